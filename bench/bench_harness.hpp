@@ -0,0 +1,275 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Minimal micro-benchmark harness for the BlockVector benchmark suite.
+//
+// A benchmark case is a function that performs one repetition and returns one
+// sample (a duration in ms, a latency in us, ...). The Runner repeats each
+// case, keeps min/median/mean/max of the samples and writes every result as
+// an aligned text table, CSV or JSON:
+//
+//     bench::Runner runner(argc, argv);
+//     runner.run({"growth", "std::vector", sizeof(T), 0, count, "ms"}, [&]() {
+//         return bench::time_ms([&]() { ... });
+//     });
+//     return runner.finish();
+namespace bench {
+namespace detail {
+constexpr size_t kDefaultRepetitions = 5;
+}
+
+// Identifies one benchmark case; block_size is 0 for containers without one.
+struct Case {
+    std::string benchmark;
+    std::string container;
+    size_t element_size;
+    size_t block_size;
+    size_t count;
+    std::string unit;
+};
+
+struct Result {
+    Case info;
+    size_t repetitions;
+    double min;
+    double median;
+    double mean;
+    double max;
+};
+
+template <typename Func>
+double time_ms(Func&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::milli> elapsed = end - start;
+    return elapsed.count();
+}
+
+// Keeps the optimizer from discarding a computed value.
+template <typename T>
+void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+#endif
+}
+
+enum class Format { text, csv, json };
+
+// Command line:
+//   --format=text|csv|json   output format (default text)
+//   --out=PATH               write results to PATH instead of stdout
+//   --filter=SUBSTR          only run cases whose "benchmark/container" contains SUBSTR
+//   --repetitions=N          samples per case (default 5)
+//   --block-sizes=A,B,...    block sizes, in elements, for the blocked containers
+//   --quick                  small inputs and one repetition, for smoke tests
+class Runner {
+public:
+    Runner(int argc, char** argv);
+
+    bool quick() const { return quick_; }
+    const std::vector<size_t>& block_sizes() const { return block_sizes_; }
+
+    // True if `benchmark` on `container` passes --filter; lets callers skip
+    // setting up inputs for cases that will not run.
+    bool enabled(const std::string& benchmark, const std::string& container) const;
+
+    template <typename Func>
+    void run(const Case& info, Func&& sample);
+
+    // Writes the collected results; returns the process exit code.
+    int finish();
+
+private:
+    static size_t parse_size(const std::string& text, const std::string& option);
+    static std::string escape_json(const std::string& text);
+    void write_text(std::ostream& out) const;
+    void write_csv(std::ostream& out) const;
+    void write_json(std::ostream& out) const;
+
+    Format format_ = Format::text;
+    std::string out_path_;
+    std::string filter_;
+    size_t repetitions_ = detail::kDefaultRepetitions;
+    std::vector<size_t> block_sizes_{256, 4096, 65536};
+    bool quick_ = false;
+    std::vector<Result> results_;
+};
+
+inline Runner::Runner(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value_of = [&](const std::string& prefix) { return arg.substr(prefix.size()); };
+        if (arg.rfind("--format=", 0) == 0) {
+            std::string format = value_of("--format=");
+            if (format == "text") {
+                format_ = Format::text;
+            } else if (format == "csv") {
+                format_ = Format::csv;
+            } else if (format == "json") {
+                format_ = Format::json;
+            } else {
+                throw std::invalid_argument("unknown --format: " + format);
+            }
+        } else if (arg.rfind("--out=", 0) == 0) {
+            out_path_ = value_of("--out=");
+        } else if (arg.rfind("--filter=", 0) == 0) {
+            filter_ = value_of("--filter=");
+        } else if (arg.rfind("--repetitions=", 0) == 0) {
+            repetitions_ = parse_size(value_of("--repetitions="), "--repetitions");
+        } else if (arg.rfind("--block-sizes=", 0) == 0) {
+            block_sizes_.clear();
+            std::stringstream list(value_of("--block-sizes="));
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                block_sizes_.push_back(parse_size(item, "--block-sizes"));
+            }
+        } else if (arg == "--quick") {
+            quick_ = true;
+            repetitions_ = 1;
+        } else {
+            throw std::invalid_argument("unknown option: " + arg);
+        }
+    }
+}
+
+inline size_t Runner::parse_size(const std::string& text, const std::string& option) {
+    char* end = nullptr;
+    unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || value == 0) {
+        throw std::invalid_argument(option + " expects a positive integer, got '" + text + "'");
+    }
+    return static_cast<size_t>(value);
+}
+
+inline bool Runner::enabled(const std::string& benchmark, const std::string& container) const {
+    return filter_.empty() || (benchmark + "/" + container).find(filter_) != std::string::npos;
+}
+
+template <typename Func>
+void Runner::run(const Case& info, Func&& sample) {
+    if (!enabled(info.benchmark, info.container)) {
+        return;
+    }
+    std::vector<double> samples;
+    samples.reserve(repetitions_);
+    for (size_t i = 0; i < repetitions_; ++i) {
+        samples.push_back(sample());
+    }
+    std::sort(samples.begin(), samples.end());
+    double total = 0.0;
+    for (double s : samples) {
+        total += s;
+    }
+    size_t mid = samples.size() / 2;
+    double median = samples.size() % 2 == 1 ? samples[mid] : (samples[mid - 1] + samples[mid]) / 2.0;
+    results_.push_back(Result{info, samples.size(), samples.front(), median,
+                              total / static_cast<double>(samples.size()), samples.back()});
+    if (format_ != Format::text || !out_path_.empty()) {
+        // Progress goes to stderr so machine-readable output stays clean.
+        std::cerr << info.benchmark << " " << info.container << " elem=" << info.element_size
+                  << " block=" << info.block_size << ": " << median << " " << info.unit << "\n";
+    }
+}
+
+inline int Runner::finish() {
+    std::ofstream file;
+    if (!out_path_.empty()) {
+        file.open(out_path_);
+        if (!file) {
+            std::cerr << "cannot open " << out_path_ << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = out_path_.empty() ? std::cout : file;
+    switch (format_) {
+    case Format::text:
+        write_text(out);
+        break;
+    case Format::csv:
+        write_csv(out);
+        break;
+    case Format::json:
+        write_json(out);
+        break;
+    }
+    return out ? 0 : 1;
+}
+
+inline void Runner::write_text(std::ostream& out) const {
+    out << std::left << std::setw(14) << "benchmark" << std::setw(26) << "container" << std::right
+        << std::setw(6) << "elem" << std::setw(8) << "block" << std::setw(11) << "count"
+        << std::setw(12) << "median" << std::setw(12) << "min" << "  unit\n";
+    for (const Result& r : results_) {
+        out << std::left << std::setw(14) << r.info.benchmark << std::setw(26) << r.info.container
+            << std::right << std::setw(6) << r.info.element_size << std::setw(8) << r.info.block_size
+            << std::setw(11) << r.info.count << std::setw(12) << r.median << std::setw(12) << r.min
+            << "  " << r.info.unit << "\n";
+    }
+}
+
+inline void Runner::write_csv(std::ostream& out) const {
+    out << "benchmark,container,element_size,block_size,count,unit,repetitions,min,median,mean,max\n";
+    out << std::setprecision(9);
+    for (const Result& r : results_) {
+        out << r.info.benchmark << ",\"" << r.info.container << "\"," << r.info.element_size << ","
+            << r.info.block_size << "," << r.info.count << "," << r.info.unit << "," << r.repetitions << ","
+            << r.min << "," << r.median << "," << r.mean << "," << r.max << "\n";
+    }
+}
+
+inline std::string Runner::escape_json(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+// The context block records how the binary was built, since results from an
+// unoptimized build are not comparable with a release build.
+inline void Runner::write_json(std::ostream& out) const {
+#if defined(__VERSION__)
+    const char* compiler = __VERSION__;
+#else
+    const char* compiler = "unknown";
+#endif
+#if defined(__OPTIMIZE__)
+    const bool optimized = true;
+#else
+    const bool optimized = false;
+#endif
+    out << std::setprecision(9);
+    out << "{\n  \"context\": {\"compiler\": \"" << escape_json(compiler) << "\", \"optimized\": "
+        << (optimized ? "true" : "false") << ", \"repetitions\": " << repetitions_
+        << ", \"quick\": " << (quick_ ? "true" : "false") << "},\n  \"results\": [";
+    for (size_t i = 0; i < results_.size(); ++i) {
+        const Result& r = results_[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"benchmark\": \"" << escape_json(r.info.benchmark)
+            << "\", \"container\": \"" << escape_json(r.info.container) << "\", \"element_size\": "
+            << r.info.element_size << ", \"block_size\": " << r.info.block_size << ", \"count\": "
+            << r.info.count << ", \"unit\": \"" << r.info.unit << "\", \"repetitions\": " << r.repetitions
+            << ", \"min\": " << r.min << ", \"median\": " << r.median << ", \"mean\": " << r.mean
+            << ", \"max\": " << r.max << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+} // namespace bench
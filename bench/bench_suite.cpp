@@ -0,0 +1,207 @@
+#include "BlockVector.hpp"
+#include "BlockVectorDiv.hpp"
+#include "bench_harness.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Benchmark suite: growth, reserve, push_back jitter, std::sort, index and
+// iteration for BlockVector, BlockVectorDiv, std::vector and std::deque, over
+// several element sizes (the old object-size comparison) and block sizes. See
+// bench_harness.hpp for the command line.
+namespace {
+// Bytes of elements per container; the element count follows from it.
+constexpr size_t kTargetBytes = static_cast<size_t>(32) << 20;
+constexpr size_t kQuickTargetBytes = static_cast<size_t>(256) << 10;
+
+template <size_t Bytes>
+struct Element {
+    static_assert(Bytes % sizeof(uint32_t) == 0, "Element size must be a multiple of 4");
+    uint32_t words[Bytes / sizeof(uint32_t)];
+
+    Element() : words() {}
+    explicit Element(uint32_t seed) {
+        for (size_t i = 0; i < Bytes / sizeof(uint32_t); ++i) {
+            words[i] = seed + static_cast<uint32_t>(i);
+        }
+    }
+};
+
+template <typename C, typename = void>
+struct has_reserve : std::false_type {};
+
+template <typename C>
+struct has_reserve<C, decltype(std::declval<C&>().reserve(size_t()), void())> : std::true_type {};
+
+// Block size applies to the blocked containers only; 0 means "not blocked".
+template <typename T>
+void configure(std::vector<T>&, size_t) {}
+
+template <typename T>
+void configure(std::deque<T>&, size_t) {}
+
+template <typename T>
+void configure(BlockVector<T>& c, size_t block_size) {
+    c.set_Block_size(block_size);
+}
+
+template <typename T>
+void configure(BlockVectorDiv<T>& c, size_t block_size) {
+    c.set_Block_size(block_size);
+}
+
+template <typename C, typename = void>
+struct has_random_access : std::false_type {};
+
+template <typename C>
+struct has_random_access<C, decltype(std::declval<C&>().end() - std::declval<C&>().begin(), void())>
+    : std::true_type {};
+
+template <typename C>
+void fill(C& c, size_t count) {
+    using T = typename std::decay<decltype(c[0])>::type;
+    for (size_t i = 0; i < count; ++i) {
+        c.push_back(T(static_cast<uint32_t>(i)));
+    }
+}
+
+template <typename C>
+void run_container(bench::Runner& runner, const char* name, size_t block_size, size_t count,
+                   const std::vector<size_t>& random_order) {
+    using T = typename std::decay<decltype(std::declval<C&>()[0])>::type;
+    auto info = [&](const char* benchmark, const char* unit) {
+        return bench::Case{benchmark, name, sizeof(T), block_size, count, unit};
+    };
+
+    runner.run(info("growth", "ms"), [&]() {
+        C c;
+        configure(c, block_size);
+        return bench::time_ms([&]() {
+            fill(c, count);
+            bench::do_not_optimize(c[count - 1]);
+        });
+    });
+
+    if constexpr (has_reserve<C>::value) {
+        runner.run(info("reserve", "ms"), [&]() {
+            C c;
+            configure(c, block_size);
+            return bench::time_ms([&]() {
+                c.reserve(count);
+                fill(c, count);
+                bench::do_not_optimize(c[count - 1]);
+            });
+        });
+    }
+
+    // Worst single push_back: the reallocation spike std::vector is known for.
+    runner.run(info("jitter", "us"), [&]() {
+        C c;
+        configure(c, block_size);
+        double worst = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            c.push_back(T(static_cast<uint32_t>(i)));
+            auto end = std::chrono::steady_clock::now();
+            std::chrono::duration<double, std::micro> step = end - start;
+            if (step.count() > worst) {
+                worst = step.count();
+            }
+        }
+        return worst;
+    });
+
+    // std::sort over random keys; BlockVectorDiv only has a forward iterator.
+    if constexpr (has_random_access<C>::value) {
+        if (runner.enabled("sort", name)) {
+            C source;
+            configure(source, block_size);
+            for (size_t i = 0; i < count; ++i) {
+                source.push_back(T(static_cast<uint32_t>(random_order[i])));
+            }
+            runner.run(info("sort", "ms"), [&]() {
+                C c = source;
+                return bench::time_ms([&]() {
+                    std::sort(c.begin(), c.end(), [](const T& a, const T& b) { return a.words[0] < b.words[0]; });
+                    bench::do_not_optimize(c[0]);
+                });
+            });
+        }
+    }
+
+    if (!runner.enabled("index_seq", name) && !runner.enabled("index_random", name) &&
+        !runner.enabled("iterate", name)) {
+        return;
+    }
+    C c;
+    configure(c, block_size);
+    fill(c, count);
+
+    runner.run(info("index_seq", "ms"), [&]() {
+        return bench::time_ms([&]() {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < count; ++i) {
+                sum += c[i].words[0];
+            }
+            bench::do_not_optimize(sum);
+        });
+    });
+
+    runner.run(info("index_random", "ms"), [&]() {
+        return bench::time_ms([&]() {
+            uint64_t sum = 0;
+            for (size_t i : random_order) {
+                sum += c[i].words[0];
+            }
+            bench::do_not_optimize(sum);
+        });
+    });
+
+    runner.run(info("iterate", "ms"), [&]() {
+        return bench::time_ms([&]() {
+            uint64_t sum = 0;
+            for (const T& value : c) {
+                sum += value.words[0];
+            }
+            bench::do_not_optimize(sum);
+        });
+    });
+}
+
+template <size_t Bytes>
+void run_element_size(bench::Runner& runner) {
+    using T = Element<Bytes>;
+    const size_t count = (runner.quick() ? kQuickTargetBytes : kTargetBytes) / Bytes;
+
+    std::vector<size_t> random_order(count);
+    std::mt19937_64 rng(42);
+    for (size_t i = 0; i < count; ++i) {
+        random_order[i] = static_cast<size_t>(rng() % count);
+    }
+
+    run_container<std::vector<T>>(runner, "std::vector", 0, count, random_order);
+    run_container<std::deque<T>>(runner, "std::deque", 0, count, random_order);
+    for (size_t block_size : runner.block_sizes()) {
+        run_container<BlockVector<T>>(runner, "BlockVector", block_size, count, random_order);
+        run_container<BlockVectorDiv<T>>(runner, "BlockVectorDiv", block_size, count, random_order);
+    }
+}
+}
+
+int main(int argc, char** argv) {
+    try {
+        bench::Runner runner(argc, argv);
+        run_element_size<4>(runner);
+        run_element_size<64>(runner);
+        run_element_size<256>(runner);
+        return runner.finish();
+    } catch (const std::exception& e) {
+        std::cerr << "blockvector_bench: " << e.what() << "\n";
+        return 2;
+    }
+}
@@ -0,0 +1,665 @@
+#pragma once
+#include "BlockVector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Slot map over BlockVector storage: insert returns a handle (slot index plus
+// generation), erase leaves a hole that a later insert reuses, and elements
+// never move, so both handles and references stay valid until the element is
+// erased. A handle to an erased element is detected by its generation.
+//
+// Empty slots form runs. The first and last slot of every run store the run
+// length (a boundary-tag skipfield), so iteration jumps over a whole run in
+// one step, and erase merges a hole with its neighbours in O(1). The runs are
+// kept on a doubly linked free list threaded through their first slots;
+// insert fills the first slot of the head run. insert, erase and lookup are
+// all O(1), and iteration costs O(elements + runs) rather than O(slots).
+template <typename T, typename Allocator = std::allocator<T>>
+class BlockSlotMap;
+
+template <typename Container, bool IsConst>
+class BlockSlotMapIterator;
+
+template <typename T, typename Allocator>
+class BlockSlotMap {
+private:
+    static constexpr uint32_t kNoSlot = std::numeric_limits<uint32_t>::max();
+
+    // Previous/next run on the free list, stored in the first slot of a run.
+    struct FreeLinks {
+        uint32_t prev;
+        uint32_t next;
+    };
+
+    // skip is 0 for an occupied slot; for the first and last slot of an empty
+    // run it is the run length (other empty slots hold stale non-zero values).
+    struct Slot {
+        alignas(T) alignas(FreeLinks) unsigned char bytes[sizeof(T) > sizeof(FreeLinks) ? sizeof(T) : sizeof(FreeLinks)];
+        uint32_t generation;
+        uint32_t skip;
+    };
+
+    using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+    using slot_storage = BlockVector<Slot, slot_allocator>;
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+    slot_storage slots_;
+    size_t size_;
+    uint32_t free_head_;
+    Allocator alloc_;
+
+    T* value_at(size_t index);
+    const T* value_at(size_t index) const;
+    FreeLinks links_at(uint32_t index) const;
+    void set_links(uint32_t index, FreeLinks links);
+    void push_run(uint32_t start);
+    void unlink_run(uint32_t start);
+    void move_run(uint32_t from, uint32_t to);
+    void set_run(uint32_t start, uint32_t length);
+    uint32_t acquire_slot();
+    size_t release_slot(uint32_t index);
+    size_t skip_empty(size_t index) const;
+    void copy_from(const BlockSlotMap& other);
+    void move_elements_from(BlockSlotMap& other);
+    template <typename Source>
+    void assign_slots_from(Source& other);
+    void release_storage();
+    void steal_from(BlockSlotMap& other) noexcept;
+public:
+    struct handle {
+        uint32_t index;
+        uint32_t generation;
+
+        bool operator==(const handle& other) const { return index == other.index && generation == other.generation; }
+        bool operator!=(const handle& other) const { return !(*this == other); }
+    };
+
+    using allocator_type  = Allocator;
+    using value_type      = T;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = T&;
+    using const_reference = const T&;
+
+    using iterator = BlockSlotMapIterator<BlockSlotMap, false>;
+    using const_iterator = BlockSlotMapIterator<BlockSlotMap, true>;
+
+    friend class BlockSlotMapIterator<BlockSlotMap, false>;
+    friend class BlockSlotMapIterator<BlockSlotMap, true>;
+    friend struct bv::detail::BlockOwnership;
+
+    BlockSlotMap();
+    explicit BlockSlotMap(const Allocator& alloc);
+    BlockSlotMap(const BlockSlotMap& other);
+    BlockSlotMap(BlockSlotMap&& other) noexcept;
+    BlockSlotMap& operator=(const BlockSlotMap& other);
+    BlockSlotMap& operator=(BlockSlotMap&& other) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value ||
+        alloc_traits::is_always_equal::value);
+    ~BlockSlotMap();
+
+    allocator_type get_allocator() const;
+    void swap(BlockSlotMap& other) noexcept;
+
+    // Insertion returns the handle of the new element.
+    handle insert(const T& value);
+    handle insert(T&& value);
+    template <typename... Args>
+    handle emplace(Args&&... args);
+
+    // Returns false if `h` does not refer to a live element.
+    bool erase(handle h);
+    iterator erase(const_iterator pos);
+
+    // Lookup: get() returns nullptr for a stale handle, at() throws.
+    bool contains(handle h) const;
+    T* get(handle h);
+    const T* get(handle h) const;
+    T& at(handle h);
+    const T& at(handle h) const;
+    T& operator[](handle h);
+    const T& operator[](handle h) const;
+
+    // Capacity related
+    size_t size() const;
+    bool empty() const;
+    size_t slot_count() const;
+    void reserve(size_t n);
+    void clear();
+
+    // Iteration visits live elements in slot order, skipping empty runs.
+    iterator begin();
+    const_iterator begin() const;
+    const_iterator cbegin() const;
+    iterator end();
+    const_iterator end() const;
+    const_iterator cend() const;
+};
+
+// Forward iterator over the live elements; handle() names the current one.
+// It walks the slot storage with a BlockVector iterator and jumps over each
+// empty run in one step. Erasing other elements keeps it valid; inserting
+// may append slots and invalidates it.
+template <typename Container, bool IsConst>
+class BlockSlotMapIterator {
+    using T = typename Container::value_type;
+    using storage = typename Container::slot_storage;
+    using slot_iterator = typename std::conditional<IsConst, typename storage::const_iterator,
+                                                    typename storage::iterator>::type;
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = T;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = typename std::conditional<IsConst, const T*, T*>::type;
+    using reference         = typename std::conditional<IsConst, const T&, T&>::type;
+    using parent_ptr        = typename std::conditional<IsConst, const Container*, Container*>::type;
+
+private:
+    slot_iterator pos_;
+    slot_iterator end_;
+    parent_ptr parent_;
+
+    friend Container;
+    friend class BlockSlotMapIterator<Container, !IsConst>;
+
+public:
+    BlockSlotMapIterator() : parent_(nullptr) {}
+    BlockSlotMapIterator(slot_iterator pos, slot_iterator end, parent_ptr parent)
+        : pos_(pos), end_(end), parent_(parent) {}
+
+    template <bool WasConst, typename = typename std::enable_if<IsConst && !WasConst>::type>
+    BlockSlotMapIterator(const BlockSlotMapIterator<Container, WasConst>& other)
+        : pos_(other.pos_), end_(other.end_), parent_(other.parent_) {}
+
+    reference operator*() const { return *operator->(); }
+    pointer operator->() const { return std::launder(reinterpret_cast<pointer>(pos_->bytes)); }
+
+    typename Container::handle handle() const {
+        return {static_cast<uint32_t>(pos_ - parent_->slots_.begin()), pos_->generation};
+    }
+
+    // A slot right after a live one starts its run, so its skip value is the
+    // distance to the next live slot (or to the end).
+    BlockSlotMapIterator& operator++() {
+        ++pos_;
+        if (pos_ != end_ && pos_->skip != 0) {
+            pos_ += pos_->skip;
+        }
+        return *this;
+    }
+
+    BlockSlotMapIterator operator++(int) {
+        BlockSlotMapIterator tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    bool operator==(const BlockSlotMapIterator& other) const { return pos_ == other.pos_; }
+    bool operator!=(const BlockSlotMapIterator& other) const { return pos_ != other.pos_; }
+};
+
+// BlockSlotMap Definitions
+
+template <typename T, typename Allocator>
+BlockSlotMap<T, Allocator>::BlockSlotMap()
+    : BlockSlotMap(Allocator()) {
+}
+
+template <typename T, typename Allocator>
+BlockSlotMap<T, Allocator>::BlockSlotMap(const Allocator& alloc)
+    : slots_(slot_allocator(alloc)), size_(0), free_head_(kNoSlot), alloc_(alloc) {
+}
+
+template <typename T, typename Allocator>
+BlockSlotMap<T, Allocator>::BlockSlotMap(const BlockSlotMap& other)
+    : BlockSlotMap(alloc_traits::select_on_container_copy_construction(other.alloc_)) {
+    copy_from(other);
+}
+
+template <typename T, typename Allocator>
+BlockSlotMap<T, Allocator>::BlockSlotMap(BlockSlotMap&& other) noexcept
+    : slots_(std::move(other.slots_)), size_(other.size_), free_head_(other.free_head_),
+      alloc_(std::move(other.alloc_)) {
+    other.size_ = 0;
+    other.free_head_ = kNoSlot;
+}
+
+// The slot storage carries its own copy of the allocator, so it takes part
+// in the same propagation as alloc_.
+template <typename T, typename Allocator>
+BlockSlotMap<T, Allocator>& BlockSlotMap<T, Allocator>::operator=(const BlockSlotMap& other) {
+    if (this == &other) {
+        return *this;
+    }
+    release_storage();
+    bv::detail::BlockOwnership::copy_allocator(slots_, other.slots_);
+    bv::detail::BlockOwnership::copy_allocator(*this, other);
+    copy_from(other);
+    return *this;
+}
+
+// With unequal allocators that do not propagate, the slots cannot change
+// owner, so the elements are moved one by one into slots laid out the same
+// way; handles into `other` stay valid here.
+template <typename T, typename Allocator>
+BlockSlotMap<T, Allocator>& BlockSlotMap<T, Allocator>::operator=(BlockSlotMap&& other) noexcept(
+    alloc_traits::propagate_on_container_move_assignment::value ||
+    alloc_traits::is_always_equal::value) {
+    if (this == &other) {
+        return *this;
+    }
+    if (bv::detail::BlockOwnership::move_storage(*this, other)) {
+        return *this;
+    }
+    release_storage();
+    move_elements_from(other);
+    other.clear();
+    return *this;
+}
+
+template <typename T, typename Allocator>
+BlockSlotMap<T, Allocator>::~BlockSlotMap() {
+    if (!std::is_trivially_destructible<T>::value) {
+        for (auto it = begin(); it != end(); ++it) {
+            alloc_traits::destroy(alloc_, &*it);
+        }
+    }
+}
+
+template <typename T, typename Allocator>
+typename BlockSlotMap<T, Allocator>::allocator_type BlockSlotMap<T, Allocator>::get_allocator() const {
+    return alloc_;
+}
+
+template <typename T, typename Allocator>
+void BlockSlotMap<T, Allocator>::swap(BlockSlotMap& other) noexcept {
+    using std::swap;
+    slots_.swap(other.slots_);
+    swap(size_, other.size_);
+    swap(free_head_, other.free_head_);
+    bv::detail::BlockOwnership::swap_allocators(*this, other);
+}
+
+template <typename T, typename Allocator>
+void swap(BlockSlotMap<T, Allocator>& a, BlockSlotMap<T, Allocator>& b) noexcept {
+    a.swap(b);
+}
+
+template <typename T, typename Allocator>
+typename BlockSlotMap<T, Allocator>::handle BlockSlotMap<T, Allocator>::insert(const T& value) {
+    return emplace(value);
+}
+
+template <typename T, typename Allocator>
+typename BlockSlotMap<T, Allocator>::handle BlockSlotMap<T, Allocator>::insert(T&& value) {
+    return emplace(std::move(value));
+}
+
+// If the constructor throws, the slot goes back to the free list (with a new
+// generation) and the map is otherwise unchanged.
+template <typename T, typename Allocator>
+template <typename... Args>
+typename BlockSlotMap<T, Allocator>::handle BlockSlotMap<T, Allocator>::emplace(Args&&... args) {
+    if (free_head_ == kNoSlot) {
+        // No holes anywhere, so the new tail slot is a run of its own.
+        if (slots_.size() >= kNoSlot) {
+            throw std::length_error("BlockSlotMap: too many slots");
+        }
+        Slot& slot = slots_.emplace_back();
+        slot.skip = 1;
+        push_run(static_cast<uint32_t>(slots_.size() - 1));
+    }
+    uint32_t index = acquire_slot();
+    try {
+        alloc_traits::construct(alloc_, reinterpret_cast<T*>(slots_[index].bytes), std::forward<Args>(args)...);
+    } catch (...) {
+        release_slot(index);
+        throw;
+    }
+    ++size_;
+    return {index, slots_[index].generation};
+}
+
+template <typename T, typename Allocator>
+bool BlockSlotMap<T, Allocator>::erase(handle h) {
+    if (!contains(h)) {
+        return false;
+    }
+    alloc_traits::destroy(alloc_, value_at(h.index));
+    release_slot(h.index);
+    --size_;
+    return true;
+}
+
+template <typename T, typename Allocator>
+typename BlockSlotMap<T, Allocator>::iterator BlockSlotMap<T, Allocator>::erase(const_iterator pos) {
+    size_t index = static_cast<size_t>(pos.pos_ - slots_.cbegin());
+    alloc_traits::destroy(alloc_, value_at(index));
+    size_t next = release_slot(static_cast<uint32_t>(index));
+    --size_;
+    return iterator(slots_.begin() + next, slots_.end(), this);
+}
+
+template <typename T, typename Allocator>
+bool BlockSlotMap<T, Allocator>::contains(handle h) const {
+    return h.index < slots_.size() && slots_[h.index].skip == 0 && slots_[h.index].generation == h.generation;
+}
+
+template <typename T, typename Allocator>
+T* BlockSlotMap<T, Allocator>::get(handle h) {
+    return contains(h) ? value_at(h.index) : nullptr;
+}
+
+template <typename T, typename Allocator>
+const T* BlockSlotMap<T, Allocator>::get(handle h) const {
+    return contains(h) ? value_at(h.index) : nullptr;
+}
+
+template <typename T, typename Allocator>
+T& BlockSlotMap<T, Allocator>::at(handle h) {
+    if (!contains(h)) {
+        throw std::out_of_range("BlockSlotMap::at");
+    }
+    return *value_at(h.index);
+}
+
+template <typename T, typename Allocator>
+const T& BlockSlotMap<T, Allocator>::at(handle h) const {
+    if (!contains(h)) {
+        throw std::out_of_range("BlockSlotMap::at");
+    }
+    return *value_at(h.index);
+}
+
+// Unchecked: `h` must refer to a live element.
+template <typename T, typename Allocator>
+T& BlockSlotMap<T, Allocator>::operator[](handle h) {
+    return *value_at(h.index);
+}
+
+template <typename T, typename Allocator>
+const T& BlockSlotMap<T, Allocator>::operator[](handle h) const {
+    return *value_at(h.index);
+}
+
+template <typename T, typename Allocator>
+size_t BlockSlotMap<T, Allocator>::size() const {
+    return size_;
+}
+
+template <typename T, typename Allocator>
+bool BlockSlotMap<T, Allocator>::empty() const {
+    return size_ == 0;
+}
+
+// Number of slots, live or empty.
+template <typename T, typename Allocator>
+size_t BlockSlotMap<T, Allocator>::slot_count() const {
+    return slots_.size();
+}
+
+template <typename T, typename Allocator>
+void BlockSlotMap<T, Allocator>::reserve(size_t n) {
+    slots_.reserve(n);
+}
+
+// Destroys every element and turns all slots into one empty run; the
+// generations advance, so no existing handle stays valid.
+template <typename T, typename Allocator>
+void BlockSlotMap<T, Allocator>::clear() {
+    for (size_t i = skip_empty(0); i < slots_.size(); i = skip_empty(i + 1)) {
+        alloc_traits::destroy(alloc_, value_at(i));
+        ++slots_[i].generation;
+        // set_run() below only rewrites the ends of the run; interior slots
+        // must still read as empty to contains() and copy_from().
+        slots_[i].skip = 1;
+    }
+    size_ = 0;
+    free_head_ = kNoSlot;
+    if (!slots_.empty()) {
+        set_run(0, static_cast<uint32_t>(slots_.size()));
+        push_run(0);
+    }
+}
+
+template <typename T, typename Allocator>
+typename BlockSlotMap<T, Allocator>::iterator BlockSlotMap<T, Allocator>::begin() {
+    return iterator(slots_.begin() + skip_empty(0), slots_.end(), this);
+}
+
+template <typename T, typename Allocator>
+typename BlockSlotMap<T, Allocator>::const_iterator BlockSlotMap<T, Allocator>::begin() const {
+    return const_iterator(slots_.begin() + skip_empty(0), slots_.end(), this);
+}
+
+template <typename T, typename Allocator>
+typename BlockSlotMap<T, Allocator>::const_iterator BlockSlotMap<T, Allocator>::cbegin() const {
+    return begin();
+}
+
+template <typename T, typename Allocator>
+typename BlockSlotMap<T, Allocator>::iterator BlockSlotMap<T, Allocator>::end() {
+    return iterator(slots_.end(), slots_.end(), this);
+}
+
+template <typename T, typename Allocator>
+typename BlockSlotMap<T, Allocator>::const_iterator BlockSlotMap<T, Allocator>::end() const {
+    return const_iterator(slots_.end(), slots_.end(), this);
+}
+
+template <typename T, typename Allocator>
+typename BlockSlotMap<T, Allocator>::const_iterator BlockSlotMap<T, Allocator>::cend() const {
+    return end();
+}
+
+template <typename T, typename Allocator>
+T* BlockSlotMap<T, Allocator>::value_at(size_t index) {
+    return std::launder(reinterpret_cast<T*>(slots_[index].bytes));
+}
+
+template <typename T, typename Allocator>
+const T* BlockSlotMap<T, Allocator>::value_at(size_t index) const {
+    return std::launder(reinterpret_cast<const T*>(slots_[index].bytes));
+}
+
+template <typename T, typename Allocator>
+typename BlockSlotMap<T, Allocator>::FreeLinks BlockSlotMap<T, Allocator>::links_at(uint32_t index) const {
+    FreeLinks links;
+    std::memcpy(&links, slots_[index].bytes, sizeof(links));
+    return links;
+}
+
+template <typename T, typename Allocator>
+void BlockSlotMap<T, Allocator>::set_links(uint32_t index, FreeLinks links) {
+    std::memcpy(slots_[index].bytes, &links, sizeof(links));
+}
+
+template <typename T, typename Allocator>
+void BlockSlotMap<T, Allocator>::push_run(uint32_t start) {
+    set_links(start, FreeLinks{kNoSlot, free_head_});
+    if (free_head_ != kNoSlot) {
+        FreeLinks head = links_at(free_head_);
+        head.prev = start;
+        set_links(free_head_, head);
+    }
+    free_head_ = start;
+}
+
+template <typename T, typename Allocator>
+void BlockSlotMap<T, Allocator>::unlink_run(uint32_t start) {
+    FreeLinks links = links_at(start);
+    if (links.prev != kNoSlot) {
+        FreeLinks prev = links_at(links.prev);
+        prev.next = links.next;
+        set_links(links.prev, prev);
+    } else {
+        free_head_ = links.next;
+    }
+    if (links.next != kNoSlot) {
+        FreeLinks next = links_at(links.next);
+        next.prev = links.prev;
+        set_links(links.next, next);
+    }
+}
+
+// The run starting at `from` now starts at `to`; it keeps its list position.
+template <typename T, typename Allocator>
+void BlockSlotMap<T, Allocator>::move_run(uint32_t from, uint32_t to) {
+    FreeLinks links = links_at(from);
+    set_links(to, links);
+    if (links.prev != kNoSlot) {
+        FreeLinks prev = links_at(links.prev);
+        prev.next = to;
+        set_links(links.prev, prev);
+    } else {
+        free_head_ = to;
+    }
+    if (links.next != kNoSlot) {
+        FreeLinks next = links_at(links.next);
+        next.prev = to;
+        set_links(links.next, next);
+    }
+}
+
+template <typename T, typename Allocator>
+void BlockSlotMap<T, Allocator>::set_run(uint32_t start, uint32_t length) {
+    slots_[start].skip = length;
+    slots_[start + length - 1].skip = length;
+}
+
+// Marks the first slot of the head run as occupied and returns it.
+template <typename T, typename Allocator>
+uint32_t BlockSlotMap<T, Allocator>::acquire_slot() {
+    uint32_t index = free_head_;
+    uint32_t length = slots_[index].skip;
+    if (length == 1) {
+        unlink_run(index);
+    } else {
+        move_run(index, index + 1);
+        set_run(index + 1, length - 1);
+    }
+    slots_[index].skip = 0;
+    return index;
+}
+
+// Turns an occupied slot into a hole, merging it with empty neighbours.
+// Returns the slot just past the merged run, which is live or the end; slot
+// index + 1 may now be inside the run, so its skip value cannot be used.
+template <typename T, typename Allocator>
+size_t BlockSlotMap<T, Allocator>::release_slot(uint32_t index) {
+    ++slots_[index].generation;
+    bool left_empty = index > 0 && slots_[index - 1].skip != 0;
+    bool right_empty = index + 1 < slots_.size() && slots_[index + 1].skip != 0;
+    uint32_t left = left_empty ? slots_[index - 1].skip : 0;
+    uint32_t right = right_empty ? slots_[index + 1].skip : 0;
+
+    if (right_empty) {
+        if (left_empty) {
+            unlink_run(index + 1);
+        } else {
+            move_run(index + 1, index);
+        }
+    } else if (!left_empty) {
+        push_run(index);
+    }
+    // Only the ends of a run carry its length, but every slot inside it must
+    // still read as empty: contains() and copy_from() test skip != 0.
+    slots_[index].skip = 1;
+    set_run(index - left, left + 1 + right);
+    return static_cast<size_t>(index) + 1 + right;
+}
+
+// First live slot at or after `index` (slots_.size() if none). A slot right
+// after a live one (or slot 0) always starts its run, so its skip value is
+// the distance to the next live slot.
+template <typename T, typename Allocator>
+size_t BlockSlotMap<T, Allocator>::skip_empty(size_t index) const {
+    if (index < slots_.size()) {
+        index += slots_[index].skip;
+    }
+    return index;
+}
+
+// Copies slot for slot, so handles into `other` are valid handles here.
+template <typename T, typename Allocator>
+void BlockSlotMap<T, Allocator>::copy_from(const BlockSlotMap& other) {
+    assign_slots_from(other);
+}
+
+// As copy_from(), but moves the elements out of `other`.
+template <typename T, typename Allocator>
+void BlockSlotMap<T, Allocator>::move_elements_from(BlockSlotMap& other) {
+    assign_slots_from(other);
+}
+
+template <typename T, typename Allocator>
+template <typename Source>
+void BlockSlotMap<T, Allocator>::assign_slots_from(Source& other) {
+    using source_ref = typename std::conditional<std::is_const<Source>::value, const T&, T&&>::type;
+    slots_.clear();
+    slots_.reserve(other.slots_.size());
+    size_ = 0;
+    free_head_ = kNoSlot;
+    try {
+        for (size_t i = 0; i < other.slots_.size(); ++i) {
+            Slot& slot = slots_.emplace_back();
+            slot.generation = other.slots_[i].generation;
+            slot.skip = other.slots_[i].skip;
+            if (slot.skip == 0) {
+                // Marked empty until constructed, so a throw leaves a consistent map.
+                slot.skip = 1;
+                alloc_traits::construct(alloc_, reinterpret_cast<T*>(slot.bytes),
+                                        static_cast<source_ref>(*other.value_at(i)));
+                slot.skip = 0;
+                ++size_;
+            } else {
+                std::memcpy(slot.bytes, other.slots_[i].bytes, sizeof(FreeLinks));
+            }
+        }
+        free_head_ = other.free_head_;
+    } catch (...) {
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            if (slots_[i].skip == 0) {
+                alloc_traits::destroy(alloc_, value_at(i));
+            }
+        }
+        slots_.clear();
+        size_ = 0;
+        throw;
+    }
+}
+
+// Destroys every element and empties the slot storage. The slot blocks stay
+// with slots_, which returns them to its allocator when that changes.
+template <typename T, typename Allocator>
+void BlockSlotMap<T, Allocator>::release_storage() {
+    if (!std::is_trivially_destructible<T>::value) {
+        for (size_t i = skip_empty(0); i < slots_.size(); i = skip_empty(i + 1)) {
+            alloc_traits::destroy(alloc_, value_at(i));
+        }
+    }
+    slots_.clear();
+    size_ = 0;
+    free_head_ = kNoSlot;
+}
+
+// Called only when the allocators are equal or alloc_ was just taken from
+// `other`, so the slot storage move below hands the blocks over as well.
+template <typename T, typename Allocator>
+void BlockSlotMap<T, Allocator>::steal_from(BlockSlotMap& other) noexcept {
+    slots_ = std::move(other.slots_);
+    size_ = other.size_;
+    free_head_ = other.free_head_;
+    other.size_ = 0;
+    other.free_head_ = kNoSlot;
+}
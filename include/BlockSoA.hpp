@@ -0,0 +1,682 @@
+#pragma once
+#include "BlockVector.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Column-oriented sibling of BlockVector: element i of BlockSoA<Ts...> is a
+// row of fields (Ts...), and each field is stored in its own array inside the
+// block. A block is one allocation laid out as
+//
+//     [ Ts[0] x block_size | pad ][ Ts[1] x block_size | pad ] ...
+//
+// with every column starting on a cache line, so a scan over one field reads
+// only that field's bytes. Growth, addressing (block = i >> shift, slot =
+// i & mask) and pointer stability are the same as BlockVector's: blocks never
+// move once allocated.
+//
+// Rows are accessed through proxy references (get<I>() on the proxy, or
+// get<I>(index) on the container); whole columns through per-block segments.
+template <typename... Ts>
+class BlockSoA;
+
+template <typename Container, bool IsConst>
+class BlockSoARef;
+
+namespace {
+// Column alignment inside a block: one cache line.
+constexpr size_t kSoAColumnAlign = 64;
+}
+
+template <typename... Ts>
+class BlockSoA : private bv::detail::BlockGeometry<bv::dynamic_block_shift> {
+    static_assert(sizeof...(Ts) > 0, "BlockSoA needs at least one column");
+
+private:
+    using Geometry = bv::detail::BlockGeometry<bv::dynamic_block_shift>;
+    using Geometry::block_size_;
+    using Geometry::block_shift_;
+    using Geometry::block_mask_;
+    using indices = std::index_sequence_for<Ts...>;
+
+    static constexpr size_t kColumns = sizeof...(Ts);
+    static constexpr size_t kBlockAlign = std::max({kSoAColumnAlign, alignof(Ts)...});
+
+    // Storage engine: a table of pointers to raw blocks. Column I of block b
+    // starts at blocks_[b] + column_offset_[I]; row i is constructed iff i < size_.
+    unsigned char** blocks_;
+    size_t block_count_;
+    size_t table_capacity_;
+    size_t size_;
+    size_t capacity_;
+    std::array<size_t, kColumns> column_offset_;
+    size_t block_bytes_;
+
+    void compute_layout();
+    void grow_table(size_t min_blocks);
+    void append_block();
+    size_t block_used(size_t block_idx) const;
+    void destroy_range(size_t first, size_t last);
+    void release_storage();
+    void steal_from(BlockSoA& other) noexcept;
+    template <size_t... I>
+    void destroy_row(size_t index, std::index_sequence<I...>);
+    template <size_t I, typename Arg, typename... Rest>
+    void construct_fields(size_t index, Arg&& arg, Rest&&... rest);
+    template <size_t I>
+    void construct_default(size_t index);
+    template <size_t... I>
+    void copy_row(const BlockSoA& other, size_t index, std::index_sequence<I...>);
+public:
+    template <size_t I>
+    using column_type = typename std::tuple_element<I, std::tuple<Ts...>>::type;
+
+    using value_type      = std::tuple<Ts...>;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = BlockSoARef<BlockSoA, false>;
+    using const_reference = BlockSoARef<BlockSoA, true>;
+
+    // Dereferencing an iterator yields a proxy, like std::vector<bool>, so
+    // there is no operator->.
+    using iterator = bv::IndexIterator<BlockSoA, false>;
+    using const_iterator = bv::IndexIterator<BlockSoA, true>;
+
+    template <size_t I>
+    using segment = bv::BlockSpan<column_type<I>>;
+    template <size_t I>
+    using const_segment = bv::BlockSpan<const column_type<I>>;
+
+    BlockSoA();
+    explicit BlockSoA(size_t n);
+    BlockSoA(const BlockSoA& other);
+    BlockSoA(BlockSoA&& other) noexcept;
+    BlockSoA& operator=(const BlockSoA& other);
+    BlockSoA& operator=(BlockSoA&& other) noexcept;
+    ~BlockSoA();
+
+    void swap(BlockSoA& other) noexcept;
+
+    // Element access
+    template <size_t I>
+    column_type<I>& get(size_t index);
+    template <size_t I>
+    const column_type<I>& get(size_t index) const;
+    reference operator[](size_t index);
+    const_reference operator[](size_t index) const;
+    reference at(size_t index);
+    const_reference at(size_t index) const;
+    reference front();
+    const_reference front() const;
+    reference back();
+    const_reference back() const;
+
+    // Capacity related
+    size_t size() const;
+    size_t capacity() const;
+    bool empty() const;
+    void reserve(size_t newCapacity);
+    void shrink_to_fit();
+    size_t get_Block_size() const;
+    size_t set_Block_size(size_t new_block_size); // only when empty
+
+    // manipulation
+    template <typename... Args>
+    reference emplace_back(Args&&... fields);
+    void push_back(const value_type& row);
+    void pop_back();
+    void clear();
+    void resize(size_t n);
+
+    // Column segments: the constructed part of column I in each block.
+    size_t segment_count() const;
+    template <size_t I>
+    segment<I> get_segment(size_t block_idx);
+    template <size_t I>
+    const_segment<I> get_segment(size_t block_idx) const;
+    template <size_t I, typename Func>
+    void for_each_segment(Func&& fn);
+    template <size_t I, typename Func>
+    void for_each_segment(Func&& fn) const;
+
+    // iterators
+    iterator begin();
+    const_iterator begin() const;
+    const_iterator cbegin() const;
+    iterator end();
+    const_iterator end() const;
+    const_iterator cend() const;
+};
+
+// Proxy for one row. Field access is lazy: get<I>() computes only that
+// field's address. Assigning from another proxy or a tuple writes the fields
+// through; converting to value_type copies them out.
+template <typename Container, bool IsConst>
+class BlockSoARef {
+    using parent_ptr = typename std::conditional<IsConst, const Container*, Container*>::type;
+
+    parent_ptr parent_;
+    size_t index_;
+
+    friend class BlockSoARef<Container, !IsConst>;
+
+    template <size_t... I>
+    typename Container::value_type load(std::index_sequence<I...>) const {
+        return typename Container::value_type(get<I>()...);
+    }
+    template <typename Row, size_t... I>
+    void store(Row&& row, std::index_sequence<I...>) const {
+        using std::get;
+        int expand[] = {0, ((this->template get<I>() = get<I>(std::forward<Row>(row))), 0)...};
+        (void)expand;
+    }
+    template <typename Other, size_t... I>
+    void store_ref(const Other& other, std::index_sequence<I...>) const {
+        int expand[] = {0, ((this->template get<I>() = other.template get<I>()), 0)...};
+        (void)expand;
+    }
+    template <size_t... I>
+    void swap_fields(const BlockSoARef& other, std::index_sequence<I...>) const {
+        using std::swap;
+        int expand[] = {0, (swap(this->template get<I>(), other.template get<I>()), 0)...};
+        (void)expand;
+    }
+
+public:
+    using value_type = typename Container::value_type;
+    static constexpr size_t kColumns = std::tuple_size<value_type>::value;
+
+    BlockSoARef(parent_ptr parent, size_t index) : parent_(parent), index_(index) {}
+    BlockSoARef(const BlockSoARef&) = default;
+
+    template <bool WasConst, typename = typename std::enable_if<IsConst && !WasConst>::type>
+    BlockSoARef(const BlockSoARef<Container, WasConst>& other) : parent_(other.parent_), index_(other.index_) {}
+
+    template <size_t I>
+    typename std::conditional<IsConst, const typename Container::template column_type<I>&,
+                              typename Container::template column_type<I>&>::type
+    get() const {
+        return parent_->template get<I>(index_);
+    }
+
+    size_t index() const { return index_; }
+
+    operator value_type() const { return load(std::make_index_sequence<kColumns>{}); }
+
+    const BlockSoARef& operator=(const BlockSoARef& other) const {
+        static_assert(!IsConst, "cannot assign through a const BlockSoA reference");
+        store_ref(other, std::make_index_sequence<kColumns>{});
+        return *this;
+    }
+    BlockSoARef& operator=(const BlockSoARef& other) {
+        static_cast<const BlockSoARef&>(*this) = other;
+        return *this;
+    }
+    template <bool OtherConst, typename = typename std::enable_if<OtherConst && !IsConst>::type>
+    const BlockSoARef& operator=(const BlockSoARef<Container, OtherConst>& other) const {
+        static_assert(!IsConst, "cannot assign through a const BlockSoA reference");
+        store_ref(other, std::make_index_sequence<kColumns>{});
+        return *this;
+    }
+    const BlockSoARef& operator=(const value_type& row) const {
+        static_assert(!IsConst, "cannot assign through a const BlockSoA reference");
+        store(row, std::make_index_sequence<kColumns>{});
+        return *this;
+    }
+    const BlockSoARef& operator=(value_type&& row) const {
+        static_assert(!IsConst, "cannot assign through a const BlockSoA reference");
+        store(std::move(row), std::make_index_sequence<kColumns>{});
+        return *this;
+    }
+
+    friend void swap(const BlockSoARef& a, const BlockSoARef& b) {
+        static_assert(!IsConst, "cannot swap through a const BlockSoA reference");
+        a.swap_fields(b, std::make_index_sequence<kColumns>{});
+    }
+};
+
+template <size_t I, typename Container, bool IsConst>
+auto get(const BlockSoARef<Container, IsConst>& ref) -> decltype(ref.template get<I>()) {
+    return ref.template get<I>();
+}
+
+// BlockSoA Definitions
+
+template <typename... Ts>
+BlockSoA<Ts...>::BlockSoA()
+    : blocks_(nullptr), block_count_(0), table_capacity_(0), size_(0), capacity_(0),
+      column_offset_(), block_bytes_(0) {
+    compute_layout();
+}
+
+template <typename... Ts>
+BlockSoA<Ts...>::BlockSoA(size_t n)
+    : BlockSoA() {
+    resize(n);
+}
+
+template <typename... Ts>
+BlockSoA<Ts...>::BlockSoA(const BlockSoA& other)
+    : BlockSoA() {
+    set_Block_size(other.block_size_);
+    reserve(other.size_);
+    for (size_t i = 0; i < other.size_; ++i) {
+        copy_row(other, i, indices{});
+    }
+}
+
+template <typename... Ts>
+BlockSoA<Ts...>::BlockSoA(BlockSoA&& other) noexcept
+    : BlockSoA() {
+    steal_from(other);
+}
+
+template <typename... Ts>
+BlockSoA<Ts...>& BlockSoA<Ts...>::operator=(const BlockSoA& other) {
+    if (this != &other) {
+        BlockSoA copy(other);
+        swap(copy);
+    }
+    return *this;
+}
+
+template <typename... Ts>
+BlockSoA<Ts...>& BlockSoA<Ts...>::operator=(BlockSoA&& other) noexcept {
+    if (this != &other) {
+        release_storage();
+        steal_from(other);
+    }
+    return *this;
+}
+
+template <typename... Ts>
+BlockSoA<Ts...>::~BlockSoA() {
+    release_storage();
+}
+
+template <typename... Ts>
+void BlockSoA<Ts...>::swap(BlockSoA& other) noexcept {
+    using std::swap;
+    this->swap_geometry(other);
+    swap(blocks_, other.blocks_);
+    swap(block_count_, other.block_count_);
+    swap(table_capacity_, other.table_capacity_);
+    swap(size_, other.size_);
+    swap(capacity_, other.capacity_);
+    swap(column_offset_, other.column_offset_);
+    swap(block_bytes_, other.block_bytes_);
+}
+
+template <typename... Ts>
+void swap(BlockSoA<Ts...>& a, BlockSoA<Ts...>& b) noexcept {
+    a.swap(b);
+}
+
+template <typename... Ts>
+template <size_t I>
+typename BlockSoA<Ts...>::template column_type<I>& BlockSoA<Ts...>::get(size_t index) {
+    unsigned char* column = blocks_[index >> block_shift_] + column_offset_[I];
+    return reinterpret_cast<column_type<I>*>(column)[index & block_mask_];
+}
+
+template <typename... Ts>
+template <size_t I>
+const typename BlockSoA<Ts...>::template column_type<I>& BlockSoA<Ts...>::get(size_t index) const {
+    const unsigned char* column = blocks_[index >> block_shift_] + column_offset_[I];
+    return reinterpret_cast<const column_type<I>*>(column)[index & block_mask_];
+}
+
+template <typename... Ts>
+typename BlockSoA<Ts...>::reference BlockSoA<Ts...>::operator[](size_t index) {
+    return reference(this, index);
+}
+
+template <typename... Ts>
+typename BlockSoA<Ts...>::const_reference BlockSoA<Ts...>::operator[](size_t index) const {
+    return const_reference(this, index);
+}
+
+template <typename... Ts>
+typename BlockSoA<Ts...>::reference BlockSoA<Ts...>::at(size_t index) {
+    if (index >= size_) {
+        throw std::out_of_range("BlockSoA::at");
+    }
+    return reference(this, index);
+}
+
+template <typename... Ts>
+typename BlockSoA<Ts...>::const_reference BlockSoA<Ts...>::at(size_t index) const {
+    if (index >= size_) {
+        throw std::out_of_range("BlockSoA::at");
+    }
+    return const_reference(this, index);
+}
+
+template <typename... Ts>
+typename BlockSoA<Ts...>::reference BlockSoA<Ts...>::front() {
+    return reference(this, 0);
+}
+
+template <typename... Ts>
+typename BlockSoA<Ts...>::const_reference BlockSoA<Ts...>::front() const {
+    return const_reference(this, 0);
+}
+
+template <typename... Ts>
+typename BlockSoA<Ts...>::reference BlockSoA<Ts...>::back() {
+    return reference(this, size_ - 1);
+}
+
+template <typename... Ts>
+typename BlockSoA<Ts...>::const_reference BlockSoA<Ts...>::back() const {
+    return const_reference(this, size_ - 1);
+}
+
+template <typename... Ts>
+size_t BlockSoA<Ts...>::size() const {
+    return size_;
+}
+
+template <typename... Ts>
+size_t BlockSoA<Ts...>::capacity() const {
+    return capacity_;
+}
+
+template <typename... Ts>
+bool BlockSoA<Ts...>::empty() const {
+    return size_ == 0;
+}
+
+template <typename... Ts>
+void BlockSoA<Ts...>::reserve(size_t newCapacity) {
+    while (capacity_ < newCapacity) {
+        append_block();
+    }
+}
+
+// Releases the blocks past the one holding the last row.
+template <typename... Ts>
+void BlockSoA<Ts...>::shrink_to_fit() {
+    size_t keep = (size_ + block_mask_) >> block_shift_;
+    while (block_count_ > keep) {
+        --block_count_;
+        ::operator delete(blocks_[block_count_], std::align_val_t(kBlockAlign));
+        capacity_ -= block_size_;
+    }
+}
+
+template <typename... Ts>
+size_t BlockSoA<Ts...>::get_Block_size() const {
+    return block_size_;
+}
+
+template <typename... Ts>
+size_t BlockSoA<Ts...>::set_Block_size(size_t new_block_size) {
+    if (size_ != 0 || new_block_size == 0) {
+        return block_size_;
+    }
+    size_t rounded = 1;
+    while (rounded < new_block_size) {
+        rounded <<= 1;
+    }
+    release_storage();
+    this->assign_block_size(rounded);
+    compute_layout();
+    return block_size_;
+}
+
+// If constructing a later field throws, the fields already built are
+// destroyed and size() is unchanged.
+template <typename... Ts>
+template <typename... Args>
+typename BlockSoA<Ts...>::reference BlockSoA<Ts...>::emplace_back(Args&&... fields) {
+    static_assert(sizeof...(Args) == kColumns, "BlockSoA::emplace_back takes one argument per column");
+    if (size_ == capacity_) {
+        append_block();
+    }
+    construct_fields<0>(size_, std::forward<Args>(fields)...);
+    ++size_;
+    return reference(this, size_ - 1);
+}
+
+template <typename... Ts>
+void BlockSoA<Ts...>::push_back(const value_type& row) {
+    if (size_ == capacity_) {
+        append_block();
+    }
+    BlockSoA& self = *this;
+    std::apply([&](const Ts&... fields) { self.template construct_fields<0>(self.size_, fields...); }, row);
+    ++size_;
+}
+
+template <typename... Ts>
+void BlockSoA<Ts...>::pop_back() {
+    if (size_ == 0) {
+        return;
+    }
+    --size_;
+    destroy_row(size_, indices{});
+}
+
+template <typename... Ts>
+void BlockSoA<Ts...>::clear() {
+    destroy_range(0, size_);
+    size_ = 0;
+}
+
+template <typename... Ts>
+void BlockSoA<Ts...>::resize(size_t n) {
+    if (n < size_) {
+        destroy_range(n, size_);
+        size_ = n;
+        return;
+    }
+    reserve(n);
+    while (size_ < n) {
+        construct_default<0>(size_);
+        ++size_;
+    }
+}
+
+template <typename... Ts>
+size_t BlockSoA<Ts...>::segment_count() const {
+    return (size_ + block_mask_) >> block_shift_;
+}
+
+template <typename... Ts>
+template <size_t I>
+typename BlockSoA<Ts...>::template segment<I> BlockSoA<Ts...>::get_segment(size_t block_idx) {
+    auto* column = reinterpret_cast<column_type<I>*>(blocks_[block_idx] + column_offset_[I]);
+    return segment<I>{column, block_used(block_idx)};
+}
+
+template <typename... Ts>
+template <size_t I>
+typename BlockSoA<Ts...>::template const_segment<I> BlockSoA<Ts...>::get_segment(size_t block_idx) const {
+    auto* column = reinterpret_cast<const column_type<I>*>(blocks_[block_idx] + column_offset_[I]);
+    return const_segment<I>{column, block_used(block_idx)};
+}
+
+template <typename... Ts>
+template <size_t I, typename Func>
+void BlockSoA<Ts...>::for_each_segment(Func&& fn) {
+    size_t count = segment_count();
+    for (size_t b = 0; b < count; ++b) {
+        fn(get_segment<I>(b));
+    }
+}
+
+template <typename... Ts>
+template <size_t I, typename Func>
+void BlockSoA<Ts...>::for_each_segment(Func&& fn) const {
+    size_t count = segment_count();
+    for (size_t b = 0; b < count; ++b) {
+        fn(get_segment<I>(b));
+    }
+}
+
+template <typename... Ts>
+typename BlockSoA<Ts...>::iterator BlockSoA<Ts...>::begin() {
+    return iterator(0, this);
+}
+
+template <typename... Ts>
+typename BlockSoA<Ts...>::const_iterator BlockSoA<Ts...>::begin() const {
+    return const_iterator(0, this);
+}
+
+template <typename... Ts>
+typename BlockSoA<Ts...>::const_iterator BlockSoA<Ts...>::cbegin() const {
+    return begin();
+}
+
+template <typename... Ts>
+typename BlockSoA<Ts...>::iterator BlockSoA<Ts...>::end() {
+    return iterator(size_, this);
+}
+
+template <typename... Ts>
+typename BlockSoA<Ts...>::const_iterator BlockSoA<Ts...>::end() const {
+    return const_iterator(size_, this);
+}
+
+template <typename... Ts>
+typename BlockSoA<Ts...>::const_iterator BlockSoA<Ts...>::cend() const {
+    return end();
+}
+
+// Column I starts at the first cache line after column I - 1 ends.
+template <typename... Ts>
+void BlockSoA<Ts...>::compute_layout() {
+    const size_t sizes[] = {sizeof(Ts)...};
+    size_t offset = 0;
+    for (size_t i = 0; i < kColumns; ++i) {
+        column_offset_[i] = offset;
+        offset += sizes[i] * block_size_;
+        offset = (offset + kBlockAlign - 1) & ~(kBlockAlign - 1);
+    }
+    block_bytes_ = offset;
+}
+
+template <typename... Ts>
+void BlockSoA<Ts...>::grow_table(size_t min_blocks) {
+    if (min_blocks <= table_capacity_) {
+        return;
+    }
+    size_t new_capacity = table_capacity_ == 0 ? kMinBlockTableCapacity : table_capacity_ * 2;
+    while (new_capacity < min_blocks) {
+        new_capacity *= 2;
+    }
+    std::allocator<unsigned char*> table_alloc;
+    unsigned char** new_table = table_alloc.allocate(new_capacity);
+    for (size_t i = 0; i < block_count_; ++i) {
+        new_table[i] = blocks_[i];
+    }
+    if (blocks_ != nullptr) {
+        table_alloc.deallocate(blocks_, table_capacity_);
+    }
+    blocks_ = new_table;
+    table_capacity_ = new_capacity;
+}
+
+template <typename... Ts>
+void BlockSoA<Ts...>::append_block() {
+    grow_table(block_count_ + 1);
+    blocks_[block_count_] = static_cast<unsigned char*>(::operator new(block_bytes_, std::align_val_t(kBlockAlign)));
+    ++block_count_;
+    capacity_ += block_size_;
+}
+
+template <typename... Ts>
+size_t BlockSoA<Ts...>::block_used(size_t block_idx) const {
+    size_t first = block_idx << block_shift_;
+    if (first >= size_) {
+        return 0;
+    }
+    size_t remaining = size_ - first;
+    return remaining < block_size_ ? remaining : block_size_;
+}
+
+template <typename... Ts>
+void BlockSoA<Ts...>::destroy_range(size_t first, size_t last) {
+    if (std::conjunction<std::is_trivially_destructible<Ts>...>::value) {
+        return;
+    }
+    for (size_t i = first; i < last; ++i) {
+        destroy_row(i, indices{});
+    }
+}
+
+template <typename... Ts>
+void BlockSoA<Ts...>::release_storage() {
+    destroy_range(0, size_);
+    size_ = 0;
+    while (block_count_ > 0) {
+        --block_count_;
+        ::operator delete(blocks_[block_count_], std::align_val_t(kBlockAlign));
+    }
+    capacity_ = 0;
+    if (blocks_ != nullptr) {
+        std::allocator<unsigned char*>().deallocate(blocks_, table_capacity_);
+        blocks_ = nullptr;
+        table_capacity_ = 0;
+    }
+}
+
+// Takes over the storage of `other`, which is left empty. This container must
+// own no storage.
+template <typename... Ts>
+void BlockSoA<Ts...>::steal_from(BlockSoA& other) noexcept {
+    swap(other);
+}
+
+template <typename... Ts>
+template <size_t... I>
+void BlockSoA<Ts...>::destroy_row(size_t index, std::index_sequence<I...>) {
+    int expand[] = {0, (std::destroy_at(&get<I>(index)), 0)...};
+    (void)expand;
+}
+
+template <typename... Ts>
+template <size_t I, typename Arg, typename... Rest>
+void BlockSoA<Ts...>::construct_fields(size_t index, Arg&& arg, Rest&&... rest) {
+    column_type<I>* field = &get<I>(index);
+    ::new (static_cast<void*>(field)) column_type<I>(std::forward<Arg>(arg));
+    if constexpr (sizeof...(Rest) > 0) {
+        try {
+            construct_fields<I + 1>(index, std::forward<Rest>(rest)...);
+        } catch (...) {
+            std::destroy_at(field);
+            throw;
+        }
+    }
+}
+
+template <typename... Ts>
+template <size_t I>
+void BlockSoA<Ts...>::construct_default(size_t index) {
+    column_type<I>* field = &get<I>(index);
+    ::new (static_cast<void*>(field)) column_type<I>();
+    if constexpr (I + 1 < kColumns) {
+        try {
+            construct_default<I + 1>(index);
+        } catch (...) {
+            std::destroy_at(field);
+            throw;
+        }
+    }
+}
+
+template <typename... Ts>
+template <size_t... I>
+void BlockSoA<Ts...>::copy_row(const BlockSoA& other, size_t index, std::index_sequence<I...>) {
+    emplace_back(other.template get<I>(index)...);
+}
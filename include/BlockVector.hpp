@@ -1,30 +1,569 @@
 #pragma once
+#include <chrono>
 #include <cstddef>
-#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <utility>
 #include <iterator>
 #include <type_traits>
 #include <stdexcept>
 #include <initializer_list>
+#include <vector>
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
+namespace {
+constexpr size_t kDefaultBlockSize = 256;
+const size_t kDefaultBlockShift = 8;
+constexpr size_t kMinBlockTableCapacity = 8;
+// Empty blocks kept past the end by pop_back/resize, so a size that oscillates
+// around a block boundary does not allocate and free on every crossing.
+constexpr size_t kDefaultSpareBlocks = 1;
+// Stride of the prefetches issued for the start of a block.
+constexpr size_t kPrefetchLineSize = 64;
+}
+
+namespace bv {
+// Default BlockShift argument: the block size is chosen at run time
+// (set_Block_size, sized constructors) and stored in the object.
+constexpr size_t dynamic_block_shift = static_cast<size_t>(-1);
+
+// Tag for the constructor that default-initializes its elements, leaving
+// trivially default-constructible ones with indeterminate values.
+struct for_overwrite_t {
+    explicit for_overwrite_t() = default;
+};
+inline constexpr for_overwrite_t for_overwrite{};
+
+namespace detail {
+// Index of the highest set bit; `value` must be non-zero.
+inline size_t floor_log2(size_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return sizeof(unsigned long long) * 8 - 1 - static_cast<size_t>(__builtin_clzll(value));
+#else
+    size_t result = 0;
+    while (value >>= 1) {
+        ++result;
+    }
+    return result;
+#endif
+}
+
+// Read hint for the cache line holding `addr`; a no-op without a builtin.
+inline void prefetch_read(const void* addr) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(addr, 0, 3);
+#else
+    (void)addr;
+#endif
+}
+
+// Position of an element in a geometric block layout where block k holds
+// (1 << base_shift) << k elements and starts at index ((1 << k) - 1) << base_shift.
+// The block table stays tiny and never has to be reallocated.
+struct GeometricSlot {
+    size_t block;
+    size_t offset;
+};
+
+inline GeometricSlot geometric_locate(size_t index, size_t base_shift) {
+    size_t biased = index + (static_cast<size_t>(1) << base_shift);
+    size_t block = floor_log2(biased) - base_shift;
+    return {block, biased - (static_cast<size_t>(1) << (block + base_shift))};
+}
+
+// Block geometry with a compile-time shift. The size, shift and mask are
+// constants, so indexing compiles to immediate shift/and instructions and
+// the geometry adds nothing to the object size.
+template <size_t BlockShift>
+struct BlockGeometry {
+    static_assert(BlockShift < sizeof(size_t) * 8, "BlockShift out of range");
+
+    static constexpr bool kFixedBlockSize = true;
+    static constexpr size_t block_shift_ = BlockShift;
+    static constexpr size_t block_size_ = static_cast<size_t>(1) << BlockShift;
+    static constexpr size_t block_mask_ = block_size_ - 1;
+
+    void assign_block_size(size_t) {}
+    void swap_geometry(BlockGeometry&) noexcept {}
+};
+
+template <>
+struct BlockGeometry<dynamic_block_shift> {
+    static constexpr bool kFixedBlockSize = false;
+    size_t block_size_ = kDefaultBlockSize;
+    size_t block_shift_ = kDefaultBlockShift;
+    size_t block_mask_ = kDefaultBlockSize - 1;
+
+    // `block_size` must be a power of two.
+    void assign_block_size(size_t block_size) {
+        block_size_ = block_size;
+        block_shift_ = 0;
+        while (block_size > 1) {
+            block_size >>= 1;
+            ++block_shift_;
+        }
+        block_mask_ = block_size_ - 1;
+    }
+
+    void swap_geometry(BlockGeometry& other) noexcept {
+        std::swap(block_size_, other.block_size_);
+        std::swap(block_shift_, other.block_shift_);
+        std::swap(block_mask_, other.block_mask_);
+    }
+};
+} // namespace detail
+} // namespace bv
+
+namespace bv {
+// Point-in-time copy of the counters kept by BasicStats.
+struct StatsSnapshot {
+    static constexpr size_t kLatencyBuckets = 32;
+
+    uint64_t block_allocations = 0;
+    uint64_t block_frees = 0;
+    uint64_t table_grows = 0;           // growth events: the block table was reallocated
+    uint64_t bytes_reserved = 0;        // bytes in blocks currently held
+    uint64_t peak_bytes_reserved = 0;
+    uint64_t bytes_used = 0;            // size() * sizeof(T), filled in by stats_snapshot()
+    uint64_t push_count = 0;
+    uint64_t push_samples = 0;
+    // push_latency_ns[k] counts sampled push_backs that took [2^k, 2^(k+1)) ns.
+    uint64_t push_latency_ns[kLatencyBuckets] = {};
+};
+
+// Default Stats policy. A Stats policy is an empty-base of BlockVector that
+// receives these hooks; with NoStats they are empty inline calls that compile
+// away, so the container pays neither size nor time for them.
+struct NoStats {
+    void on_block_allocate(size_t) {}
+    void on_block_deallocate(size_t) {}
+    void on_table_grow(size_t) {}
+    // The value returned by on_push_begin is handed to on_push_end once the
+    // element has been constructed.
+    uint64_t on_push_begin() { return 0; }
+    void on_push_end(uint64_t) {}
+    StatsSnapshot snapshot() const { return StatsSnapshot(); }
+};
+
+// Stats policy that counts block and table events, tracks the current and
+// peak block footprint, and times one push_back in kPushSampleInterval into
+// a log2 latency histogram. Counters belong to the storage: they move with
+// it on move construction, move assignment and swap, and start at zero in a
+// copy. Not thread-safe, like the container itself.
+class BasicStats {
+public:
+    static constexpr uint64_t kPushSampleInterval = 64;
+
+    void on_block_allocate(size_t bytes) {
+        ++counters_.block_allocations;
+        counters_.bytes_reserved += bytes;
+        if (counters_.bytes_reserved > counters_.peak_bytes_reserved) {
+            counters_.peak_bytes_reserved = counters_.bytes_reserved;
+        }
+    }
+    void on_block_deallocate(size_t bytes) {
+        ++counters_.block_frees;
+        counters_.bytes_reserved -= bytes;
+    }
+    void on_table_grow(size_t) { ++counters_.table_grows; }
+    uint64_t on_push_begin() {
+        if (counters_.push_count++ % kPushSampleInterval != 0) {
+            return 0;
+        }
+        return now_ns();
+    }
+    void on_push_end(uint64_t start) {
+        if (start == 0) {
+            return;
+        }
+        uint64_t elapsed = now_ns() - start;
+        size_t bucket = elapsed == 0 ? 0 : detail::floor_log2(static_cast<size_t>(elapsed));
+        if (bucket >= StatsSnapshot::kLatencyBuckets) {
+            bucket = StatsSnapshot::kLatencyBuckets - 1;
+        }
+        ++counters_.push_latency_ns[bucket];
+        ++counters_.push_samples;
+    }
+    StatsSnapshot snapshot() const { return counters_; }
+
+private:
+    static uint64_t now_ns() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    StatsSnapshot counters_;
+};
+
+// Prefetch policy for sequential scans. When a scan enters block b it
+// prefetches the first Lines cache lines of block b + Distance, plus the
+// block-table entry Distance blocks further on. Blocks live in unrelated heap
+// regions, so the hardware prefetcher cannot follow a block transition on its
+// own. Distance 0 turns prefetching off. prefetch() is the hint itself and can
+// be replaced by deriving from this policy.
+template <size_t Distance, size_t Lines = 4>
+struct BlockPrefetch {
+    static constexpr size_t distance = Distance;
+    static constexpr size_t lines = Lines;
+    static void prefetch(const void* addr) { detail::prefetch_read(addr); }
+};
+
+using DefaultPrefetch = BlockPrefetch<2>;
+using NoPrefetch = BlockPrefetch<0>;
+
+namespace detail {
+// prefetch_ahead for any container that reaches its blocks through a table
+// of `block_count` pointers to blocks of `block_bytes` bytes.
+template <typename Prefetch, typename T>
+void prefetch_block_ahead(T* const* table, size_t block_count, size_t block_idx, size_t block_bytes) {
+    if (Prefetch::distance == 0) {
+        return;
+    }
+    size_t target = block_idx + Prefetch::distance;
+    if (target >= block_count) {
+        return;
+    }
+    // The table entry one distance further on is read when the scan reaches
+    // `target`, so request it now as well.
+    if (target + Prefetch::distance < block_count) {
+        Prefetch::prefetch(table + target + Prefetch::distance);
+    }
+    const char* data = reinterpret_cast<const char*>(table[target]);
+    for (size_t line = 0; line < Prefetch::lines && line * kPrefetchLineSize < block_bytes; ++line) {
+        Prefetch::prefetch(data + line * kPrefetchLineSize);
+    }
+}
+} // namespace detail
+} // namespace bv
 
 // Forward declarations
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>, size_t BlockShift = bv::dynamic_block_shift,
+          typename Stats = bv::NoStats, typename Prefetch = bv::DefaultPrefetch>
 class BlockVector;
 
-template <typename T, bool IsConst>
+template <typename Container, bool IsConst>
 class BlockVectorIterator;
 
+template <typename Container, bool IsConst>
+class BlockSegmentRange;
+
+namespace bv {
+namespace detail {
+template <typename It>
+using enable_if_input_iterator = typename std::enable_if<std::is_convertible<
+    typename std::iterator_traits<It>::iterator_category, std::input_iterator_tag>::value>::type;
+
+// Any range exposing contiguous storage through data() and size().
+template <typename Range>
+using enable_if_contiguous_range = typename std::enable_if<std::is_pointer<
+    decltype(std::declval<const Range&>().data() + std::declval<const Range&>().size())>::value>::type;
+
+// Iterators known to walk contiguous storage: pointers, std::vector
+// iterators (except vector<bool>'s proxies) and, from C++20, anything that
+// models std::contiguous_iterator.
+template <typename It, typename V = typename std::iterator_traits<It>::value_type>
+struct is_contiguous_iterator : std::integral_constant<bool,
+    std::is_pointer<It>::value ||
+    (!std::is_same<V, bool>::value &&
+     (std::is_same<It, typename std::vector<V>::iterator>::value ||
+      std::is_same<It, typename std::vector<V>::const_iterator>::value))
+#if defined(__cpp_lib_concepts)
+    || std::contiguous_iterator<It>
+#endif
+    > {};
+
+// Source for a run of `count` > 0 elements: the address of the first element
+// when the runs are copied with memcpy, the iterator itself otherwise.
+template <typename It>
+auto run_source(It first, std::true_type) -> decltype(std::addressof(*first)) {
+    return std::addressof(*first);
+}
+template <typename It>
+It run_source(It first, std::false_type) {
+    return first;
+}
+} // namespace detail
+
+// A contiguous run of elements inside one block.
 template <typename T>
-class BlockVector {
+struct BlockSpan {
+    T* ptr;
+    size_t count;
+
+    T* data() const { return ptr; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    T* begin() const { return ptr; }
+    T* end() const { return ptr + count; }
+    T& operator[](size_t index) const { return ptr[index]; }
+};
+
+namespace detail {
+// Where an element sits in contiguous storage: element lies in [first, last).
+template <typename Pointer>
+struct StorageRun {
+    Pointer first;
+    Pointer element;
+    Pointer last;
+};
+
+// IndexIterator element access through (*parent)[index]: one O(1) lookup per
+// dereference. The reference may be a proxy, in which case there is no
+// operator->.
+template <typename Container, bool IsConst>
+class IndexedAccess {
+    using parent_ptr = typename std::conditional<IsConst, const Container*, Container*>::type;
+
+public:
+    using reference = decltype((*std::declval<parent_ptr>())[size_t()]);
+    using pointer   = typename std::conditional<std::is_reference<reference>::value,
+                                                typename std::remove_reference<reference>::type*, void>::type;
+
+protected:
+    IndexedAccess() = default;
+    template <bool WasConst>
+    IndexedAccess(const IndexedAccess<Container, WasConst>&) {}
+
+    reference get(parent_ptr parent, size_t index) const { return (*parent)[index]; }
+    void advance(std::ptrdiff_t) {}
+};
+
+// IndexIterator element access that caches the contiguous run holding the
+// current element, as reported by parent->iterator_run(index). Moves that stay
+// inside the run are pointer steps; any other move drops the cache and the
+// next dereference asks the container again, so positions past the end are
+// never resolved.
+template <typename Container, bool IsConst>
+class RunAccess {
+    using T = typename Container::value_type;
+    using parent_ptr = typename std::conditional<IsConst, const Container*, Container*>::type;
+
+public:
+    using reference = typename std::conditional<IsConst, const T&, T&>::type;
+    using pointer   = typename std::conditional<IsConst, const T*, T*>::type;
+
 private:
-    std::vector<std::vector<T>> chunks_;
+    mutable pointer first_;
+    mutable pointer cur_;
+    mutable pointer last_;
+
+    friend class RunAccess<Container, !IsConst>;
+
+protected:
+    RunAccess() : first_(nullptr), cur_(nullptr), last_(nullptr) {}
+    template <bool WasConst>
+    RunAccess(const RunAccess<Container, WasConst>& other)
+        : first_(other.first_), cur_(other.cur_), last_(other.last_) {}
+
+    reference get(parent_ptr parent, size_t index) const {
+        if (cur_ == nullptr) {
+            auto run = parent->iterator_run(index);
+            first_ = run.first;
+            cur_ = run.element;
+            last_ = run.last;
+        }
+        return *cur_;
+    }
+    void advance(std::ptrdiff_t n) {
+        if (cur_ != nullptr) {
+            if (n < last_ - cur_ && n >= first_ - cur_) {
+                cur_ += n;
+            } else {
+                cur_ = nullptr;
+            }
+        }
+    }
+};
+
+// Allocator handling shared by the block containers' copy, move and swap. A
+// container befriends this and provides alloc_, release_storage() (destroy
+// every element and free every block) and steal_from(other) (take over the
+// storage of `other`, leaving it empty; this container must own none).
+struct BlockOwnership {
+    // Adopts the allocator of `other` if it propagates on copy assignment.
+    // Blocks are returned to the allocator that handed them out, so they are
+    // released first when the two differ.
+    template <typename Container>
+    static void copy_allocator(Container& self, const Container& other) {
+        using traits = std::allocator_traits<typename Container::allocator_type>;
+        if constexpr (traits::propagate_on_container_copy_assignment::value) {
+            if constexpr (!traits::is_always_equal::value) {
+                if (self.alloc_ != other.alloc_) {
+                    self.release_storage();
+                }
+            }
+            self.alloc_ = other.alloc_;
+        }
+    }
+
+    // Hands the storage of `other` to `self` when the allocator propagates on
+    // move assignment or the two compare equal. Returns false otherwise; the
+    // caller then moves the elements one by one.
+    template <typename Container>
+    static bool move_storage(Container& self, Container& other) noexcept {
+        using traits = std::allocator_traits<typename Container::allocator_type>;
+        if constexpr (traits::propagate_on_container_move_assignment::value) {
+            self.release_storage();
+            self.alloc_ = std::move(other.alloc_);
+        } else {
+            if constexpr (!traits::is_always_equal::value) {
+                if (!(self.alloc_ == other.alloc_)) {
+                    return false;
+                }
+            }
+            self.release_storage();
+        }
+        self.steal_from(other);
+        return true;
+    }
+
+    // As with the standard containers, swapping two containers whose
+    // allocators neither propagate nor compare equal is undefined.
+    template <typename Container>
+    static void swap_allocators(Container& a, Container& b) noexcept {
+        using traits = std::allocator_traits<typename Container::allocator_type>;
+        if constexpr (traits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(a.alloc_, b.alloc_);
+        }
+    }
+};
+} // namespace detail
+
+// Random-access iterator holding a container and an element index. Arithmetic
+// and comparisons are integer operations on the index; element access goes
+// through the Access policy (detail::IndexedAccess or detail::RunAccess).
+template <typename Container, bool IsConst, template <typename, bool> class Access = detail::IndexedAccess>
+class IndexIterator : private Access<Container, IsConst> {
+    using access = Access<Container, IsConst>;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = typename Container::value_type;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = typename access::pointer;
+    using reference         = typename access::reference;
+    using parent_ptr        = typename std::conditional<IsConst, const Container*, Container*>::type;
+
+private:
+    size_t index_;
+    parent_ptr parent_;
+
+    friend class IndexIterator<Container, !IsConst, Access>;
+
+public:
+    IndexIterator() : index_(0), parent_(nullptr) {}
+    IndexIterator(size_t index, parent_ptr parent) : index_(index), parent_(parent) {}
+
+    template <bool WasConst, typename = typename std::enable_if<IsConst && !WasConst>::type>
+    IndexIterator(const IndexIterator<Container, WasConst, Access>& other)
+        : access(static_cast<const Access<Container, WasConst>&>(other)), index_(other.index_), parent_(other.parent_) {}
+
+    size_t index() const { return index_; }
+
+    reference operator*() const { return this->get(parent_, index_); }
+    pointer operator->() const { return &**this; }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    IndexIterator& operator++() {
+        ++index_;
+        this->advance(1);
+        return *this;
+    }
+    IndexIterator operator++(int) {
+        IndexIterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+    IndexIterator& operator--() {
+        --index_;
+        this->advance(-1);
+        return *this;
+    }
+    IndexIterator operator--(int) {
+        IndexIterator tmp = *this;
+        --*this;
+        return tmp;
+    }
+    IndexIterator& operator+=(difference_type n) {
+        index_ += static_cast<size_t>(n);
+        this->advance(n);
+        return *this;
+    }
+    IndexIterator& operator-=(difference_type n) { return *this += -n; }
+    IndexIterator operator+(difference_type n) const { return IndexIterator(*this) += n; }
+    IndexIterator operator-(difference_type n) const { return IndexIterator(*this) -= n; }
+
+    difference_type operator-(const IndexIterator& other) const {
+        return static_cast<difference_type>(index_ - other.index_);
+    }
+
+    bool operator==(const IndexIterator& other) const { return index_ == other.index_; }
+    bool operator!=(const IndexIterator& other) const { return index_ != other.index_; }
+    bool operator<(const IndexIterator& other) const { return index_ < other.index_; }
+    bool operator>(const IndexIterator& other) const { return index_ > other.index_; }
+    bool operator<=(const IndexIterator& other) const { return index_ <= other.index_; }
+    bool operator>=(const IndexIterator& other) const { return index_ >= other.index_; }
+
+    friend IndexIterator operator+(difference_type n, const IndexIterator& it) { return it + n; }
+};
+} // namespace bv
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+class BlockVector : private bv::detail::BlockGeometry<BlockShift>, private Stats {
+private:
+    using Geometry = bv::detail::BlockGeometry<BlockShift>;
+    using Geometry::block_size_;
+    using Geometry::block_shift_;
+    using Geometry::block_mask_;
+
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using table_allocator = typename alloc_traits::template rebind_alloc<T*>;
+    using table_traits = std::allocator_traits<table_allocator>;
+    static_assert(std::is_same<typename alloc_traits::value_type, T>::value,
+                  "BlockVector: Allocator::value_type must be T");
+    static_assert(std::is_same<typename alloc_traits::pointer, T*>::value,
+                  "BlockVector: Allocator must hand out raw pointers");
+
+    // Storage engine: a contiguous table of pointers to raw, uninitialized
+    // blocks of block_size_ elements. Element i lives at
+    // blocks_[i >> block_shift_][i & block_mask_] and is constructed iff i < size_.
+    T** blocks_;
+    size_t block_count_;
+    size_t table_capacity_;
     size_t size_;
     size_t capacity_;
-    size_t block_size_;
-    size_t block_shift_;
-    size_t block_mask_;
-
-    void update_block_shift();
+    size_t max_spare_blocks_;
+    Allocator alloc_;
+
+    void fit_block_size(size_t n);
+    size_t block_used(size_t block_idx) const;
+    size_t retained_blocks() const;
+    T* allocate_block();
+    void deallocate_block(T* block);
+    void grow_table(size_t min_blocks);
+    void append_block();
+    void release_last_block();
+    void release_blocks_from(size_t first_block);
+    void destroy_range(size_t first, size_t last);
+    void release_storage();
+    void copy_from(const BlockVector& other);
+    void steal_from(BlockVector& other) noexcept;
+    Stats& stats_policy() { return *this; }
+    template <typename InputIt>
+    void append_range(InputIt first, InputIt last, std::input_iterator_tag);
+    template <typename ForwardIt>
+    void append_range(ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+    template <typename InputIt>
+    InputIt construct_run(InputIt first, size_t count, std::false_type);
+    template <typename Ptr>
+    Ptr construct_run(Ptr first, size_t count, std::true_type);
 public:
+    using allocator_type  = Allocator;
     using value_type      = T;
     using size_type       = size_t;
     using difference_type = std::ptrdiff_t;
@@ -33,21 +572,41 @@ public:
     using pointer         = T*;
     using const_pointer   = const T*;
 
-    using iterator = BlockVectorIterator<T, false>;
-    using const_iterator = BlockVectorIterator<T, true>;
+    using iterator = BlockVectorIterator<BlockVector, false>;
+    using const_iterator = BlockVectorIterator<BlockVector, true>;
     using reverse_iterator = std::reverse_iterator<iterator>;
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
     // Allow iterator to access private members
-    friend class BlockVectorIterator<T, false>;
-    friend class BlockVectorIterator<T, true>;
+    friend class BlockVectorIterator<BlockVector, false>;
+    friend class BlockVectorIterator<BlockVector, true>;
+    friend class BlockSegmentRange<BlockVector, false>;
+    friend class BlockSegmentRange<BlockVector, true>;
+    friend struct bv::detail::BlockOwnership;
 
     BlockVector();
-    BlockVector(size_t n);
-    BlockVector(size_t n, const T& value);
-    BlockVector(std::initializer_list<T> init);
+    explicit BlockVector(const Allocator& alloc);
+    BlockVector(size_t n, const Allocator& alloc = Allocator());
+    BlockVector(size_t n, const T& value, const Allocator& alloc = Allocator());
+    BlockVector(size_t n, bv::for_overwrite_t, const Allocator& alloc = Allocator());
+    BlockVector(std::initializer_list<T> init, const Allocator& alloc = Allocator());
+    BlockVector(const BlockVector& other);
+    BlockVector(const BlockVector& other, const Allocator& alloc);
+    BlockVector(BlockVector&& other) noexcept;
+    BlockVector(BlockVector&& other, const Allocator& alloc);
+    BlockVector& operator=(const BlockVector& other);
+    BlockVector& operator=(BlockVector&& other) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value ||
+        alloc_traits::is_always_equal::value);
     ~BlockVector();
 
+    allocator_type get_allocator() const;
+    void swap(BlockVector& other) noexcept;
+
+    // instrumentation (see bv::BasicStats)
+    const Stats& stats() const { return *this; }
+    bv::StatsSnapshot stats_snapshot() const;
+
     // Element access
     T& operator[](size_t index);
     const T& operator[](size_t index) const;
@@ -57,88 +616,141 @@ public:
     const T& front() const;
     T& back();
     const T& back() const;
-    
+
     // Capacity related
     size_t size() const;
     size_t capacity() const;
     bool empty() const;
     void reserve(size_t newCapacity);
+    void shrink_to_fit();
+    // spare blocks: empty blocks past the end that pop_back/resize keep for reuse
+    size_t max_spare_blocks() const;
+    void set_max_spare_blocks(size_t n);
     // spacial capacity functions
     size_t get_Block_size() const;
     size_t set_Block_size(size_t new_block_size); // only when empty in v1.0
 
     // manipulation
     void push_back(const T& value);
+    void push_back(T&& value);
     template <typename... Args>
     T& emplace_back(Args&&... args);
     void pop_back();
     void clear();
     void resize(size_t n);
-    
-    // iterators 
+    void resize_default_init(size_t n);
+
+    // bulk insertion: capacity is reserved once and elements are filled one
+    // block-sized run at a time; trivially copyable runs from pointers,
+    // std::vector iterators and any range with data()/size() are copied with
+    // memcpy.
+    template <typename InputIt, typename = bv::detail::enable_if_input_iterator<InputIt>>
+    void append(InputIt first, InputIt last);
+    template <typename InputIt>
+    void append_n(InputIt first, size_t count);
+    template <typename Range, typename = bv::detail::enable_if_contiguous_range<Range>>
+    void append(const Range& range);
+    void append(std::initializer_list<T> init);
+    template <typename InputIt, typename = bv::detail::enable_if_input_iterator<InputIt>>
+    void assign(InputIt first, InputIt last);
+    void assign(size_t count, const T& value);
+    void assign(std::initializer_list<T> init);
+
+    // iterators
     iterator begin();
     const_iterator begin() const;
     const_iterator cbegin() const;
     iterator end();
     const_iterator end() const;
     const_iterator cend() const;
-    
+
     reverse_iterator rbegin();
     const_reverse_iterator rbegin() const;
     const_reverse_iterator crbegin() const;
     reverse_iterator rend();
     const_reverse_iterator rend() const;
     const_reverse_iterator crend() const;
+
+    // block-wise access: each segment is the contiguous, constructed part of one
+    // block, so hot loops can run over plain pointers and only pay for the
+    // block boundary once per block.
+    using segment = bv::BlockSpan<T>;
+    using const_segment = bv::BlockSpan<const T>;
+    using segment_range = BlockSegmentRange<BlockVector, false>;
+    using const_segment_range = BlockSegmentRange<BlockVector, true>;
+
+    size_t segment_count() const;
+    segment get_segment(size_t block_idx);
+    const_segment get_segment(size_t block_idx) const;
+    segment_range segments();
+    const_segment_range segments() const;
+    template <typename Func>
+    void for_each_segment(Func&& fn);
+    template <typename Func>
+    void for_each_segment(Func&& fn) const;
+    // Prefetches block block_idx + Prefetch::distance for a forward scan that
+    // is about to enter block block_idx. Blocks past the table are ignored.
+    void prefetch_ahead(size_t block_idx) const;
 };
 
 // Iterator Implementation
-template <typename T, bool IsConst>
+//
+// The iterator carries its global index plus a pointer to the current element
+// and to the end of the current block's storage. Comparisons and differences
+// are plain index arithmetic; ++/-- stay inside the cached block and only
+// consult the block table when they cross a boundary, and += / -= re-seek with
+// a single table lookup. cur_ is null when the index lies past the last
+// allocated block (e.g. end() of a full table), which is never dereferenced.
+template <typename Container, bool IsConst>
 class BlockVectorIterator {
+    using T = typename Container::value_type;
+
 public:
     using iterator_category = std::random_access_iterator_tag;
     using value_type        = T;
     using difference_type   = std::ptrdiff_t;
     using pointer           = typename std::conditional<IsConst, const T*, T*>::type;
     using reference         = typename std::conditional<IsConst, const T&, T&>::type;
-    using parent_ptr        = typename std::conditional<IsConst, const BlockVector<T>*, BlockVector<T>*>::type;
+    using parent_ptr        = typename std::conditional<IsConst, const Container*, Container*>::type;
 
 private:
-    size_t block_idx_;
+    size_t index_;
     T* cur_;
-    T* end_;
+    T* block_end_;
     parent_ptr parent_;
 
-    friend class BlockVector<T>;
-    friend class BlockVectorIterator<T, !IsConst>;
+    friend Container;
+    friend class BlockVectorIterator<Container, !IsConst>;
+
+    void seek(size_t index) {
+        index_ = index;
+        size_t block_idx = index >> parent_->block_shift_;
+        if (block_idx < parent_->block_count_) {
+            T* block = parent_->blocks_[block_idx];
+            cur_ = block + (index & parent_->block_mask_);
+            block_end_ = block + parent_->block_mask_ + 1;
+        } else {
+            cur_ = block_end_ = nullptr;
+        }
+    }
 
 public:
-    BlockVectorIterator() : block_idx_(0), cur_(nullptr), end_(nullptr), parent_(nullptr) {}
+    BlockVectorIterator() : index_(0), cur_(nullptr), block_end_(nullptr), parent_(nullptr) {}
 
-    BlockVectorIterator(size_t block_idx, T* cur, T* end, parent_ptr parent)
-        : block_idx_(block_idx), cur_(const_cast<T*>(cur)), end_(const_cast<T*>(end)), parent_(parent) {}
+    BlockVectorIterator(size_t index, parent_ptr parent) : parent_(parent) { seek(index); }
 
     template <bool WasConst, typename = typename std::enable_if<IsConst && !WasConst>::type>
-    BlockVectorIterator(const BlockVectorIterator<T, WasConst>& other)
-        : block_idx_(other.block_idx_), cur_(other.cur_), end_(other.end_), parent_(other.parent_) {}
+    BlockVectorIterator(const BlockVectorIterator<Container, WasConst>& other)
+        : index_(other.index_), cur_(other.cur_), block_end_(other.block_end_), parent_(other.parent_) {}
 
     reference operator*() const { return *cur_; }
     pointer operator->() const { return cur_; }
 
     BlockVectorIterator& operator++() {
-        ++cur_;
-        if (cur_ == end_) {
-            ++block_idx_;
-            if (block_idx_ < parent_->chunks_.size()) {
-                auto& chunk = parent_->chunks_[block_idx_];
-                if (!chunk.empty()) {
-                    cur_ = const_cast<T*>(chunk.data());
-                    end_ = cur_ + chunk.size();
-                } else {
-                    cur_ = end_ = nullptr;
-                }
-            } else {
-                cur_ = end_ = nullptr;
-            }
+        ++index_;
+        if (++cur_ == block_end_) {
+            seek(index_);
+            parent_->prefetch_ahead(index_ >> parent_->block_shift_);
         }
         return *this;
     }
@@ -150,32 +762,11 @@ public:
     }
 
     BlockVectorIterator& operator--() {
-        if (cur_ == nullptr) {
-            block_idx_ = parent_->chunks_.size();
-            while (block_idx_ > 0) {
-                --block_idx_;
-                auto& chunk = parent_->chunks_[block_idx_];
-                if (!chunk.empty()) {
-                    cur_ = const_cast<T*>(chunk.data() + chunk.size() - 1);
-                    end_ = const_cast<T*>(chunk.data() + chunk.size());
-                    return *this;
-                }
-            }
-            return *this;
-        }
-        auto& chunk = parent_->chunks_[block_idx_];
-        if (cur_ == chunk.data()) {
-            while (block_idx_ > 0) {
-                --block_idx_;
-                auto& prev_chunk = parent_->chunks_[block_idx_];
-                if (!prev_chunk.empty()) {
-                    cur_ = const_cast<T*>(prev_chunk.data() + prev_chunk.size() - 1);
-                    end_ = const_cast<T*>(prev_chunk.data() + prev_chunk.size());
-                    return *this;
-                }
-            }
-        } else {
+        if (cur_ != nullptr && (index_ & parent_->block_mask_) != 0) {
+            --index_;
             --cur_;
+        } else {
+            seek(index_ - 1);
         }
         return *this;
     }
@@ -187,240 +778,369 @@ public:
     }
 
     BlockVectorIterator& operator+=(difference_type n) {
-        if (n == 0) return *this;
-        if (n < 0) return *this -= (-n);
-        size_t global_idx;
-        if (cur_ == nullptr) global_idx = parent_->size();
-        else global_idx = (block_idx_ << parent_->block_shift_) + (cur_ - const_cast<T*>(parent_->chunks_[block_idx_].data()));
-        
-        global_idx += n;
-        if (global_idx >= parent_->size()) {
-            block_idx_ = parent_->chunks_.size();
-            cur_ = end_ = nullptr;
-            return *this;
+        size_t target = index_ + static_cast<size_t>(n);
+        if (cur_ != nullptr && ((target ^ index_) >> parent_->block_shift_) == 0) {
+            index_ = target;
+            cur_ += n;
+        } else {
+            seek(target);
         }
-        block_idx_ = global_idx >> parent_->block_shift_;
-        size_t offset = global_idx & parent_->block_mask_;
-        auto& chunk = parent_->chunks_[block_idx_];
-        cur_ = const_cast<T*>(chunk.data() + offset);
-        end_ = const_cast<T*>(chunk.data() + chunk.size());
         return *this;
     }
 
-    BlockVectorIterator& operator-=(difference_type n) {
-        if (n == 0) return *this;
-        if (n < 0) return *this += (-n);
-        size_t global_idx;
-        if (cur_ == nullptr) global_idx = parent_->size();
-        else global_idx = (block_idx_ << parent_->block_shift_) + (cur_ - const_cast<T*>(parent_->chunks_[block_idx_].data()));
-        
-        if (static_cast<size_t>(n) > global_idx) global_idx = 0;
-        else global_idx -= n;
-        
-        block_idx_ = global_idx >> parent_->block_shift_;
-        size_t offset = global_idx & parent_->block_mask_;
-        auto& chunk = parent_->chunks_[block_idx_];
-        cur_ = const_cast<T*>(chunk.data() + offset);
-        end_ = const_cast<T*>(chunk.data() + chunk.size());
-        return *this;
-    }
+    BlockVectorIterator& operator-=(difference_type n) { return *this += -n; }
 
     BlockVectorIterator operator+(difference_type n) const { return BlockVectorIterator(*this) += n; }
     BlockVectorIterator operator-(difference_type n) const { return BlockVectorIterator(*this) -= n; }
-    
+
     difference_type operator-(const BlockVectorIterator& other) const {
-        size_t my_global = (cur_ == nullptr) ? parent_->size() : (block_idx_ << parent_->block_shift_) + (cur_ - const_cast<T*>(parent_->chunks_[block_idx_].data()));
-        size_t other_global = (other.cur_ == nullptr) ? other.parent_->size() : (other.block_idx_ << other.parent_->block_shift_) + (other.cur_ - const_cast<T*>(other.parent_->chunks_[other.block_idx_].data()));
-        return static_cast<difference_type>(my_global) - static_cast<difference_type>(other_global);
+        return static_cast<difference_type>(index_ - other.index_);
     }
 
     reference operator[](difference_type n) const { return *(*this + n); }
 
-    bool operator==(const BlockVectorIterator& other) const { return block_idx_ == other.block_idx_ && cur_ == other.cur_; }
-    bool operator!=(const BlockVectorIterator& other) const { return !(*this == other); }
-    bool operator<(const BlockVectorIterator& other) const {
-            bool this_end = (cur_ == nullptr);
-            bool other_end = (other.cur_ == nullptr);
-            if (this_end) return false;
-            if (other_end) return true;
-            if (block_idx_ != other.block_idx_) return block_idx_ < other.block_idx_;
-            return cur_ < other.cur_;
-    }
-    bool operator>(const BlockVectorIterator& other) const { return other < *this; }
-    bool operator<=(const BlockVectorIterator& other) const { return !(*this > other); }
-    bool operator>=(const BlockVectorIterator& other) const { return !(*this < other); }
+    bool operator==(const BlockVectorIterator& other) const { return index_ == other.index_; }
+    bool operator!=(const BlockVectorIterator& other) const { return index_ != other.index_; }
+    bool operator<(const BlockVectorIterator& other) const { return index_ < other.index_; }
+    bool operator>(const BlockVectorIterator& other) const { return index_ > other.index_; }
+    bool operator<=(const BlockVectorIterator& other) const { return index_ <= other.index_; }
+    bool operator>=(const BlockVectorIterator& other) const { return index_ >= other.index_; }
 
     friend BlockVectorIterator operator+(difference_type n, const BlockVectorIterator& it) { return it + n; }
 };
 
+// Segment range: a forward range of BlockSpan, one per non-empty block.
+template <typename Container, bool IsConst>
+class BlockSegmentRange {
+    using T = typename Container::value_type;
+    using parent_ptr = typename std::conditional<IsConst, const Container*, Container*>::type;
+
+public:
+    using value_type = bv::BlockSpan<typename std::conditional<IsConst, const T, T>::type>;
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = BlockSegmentRange::value_type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const value_type*;
+        using reference         = value_type;
+
+        iterator() : block_idx_(0), parent_(nullptr) {}
+        iterator(size_t block_idx, parent_ptr parent) : block_idx_(block_idx), parent_(parent) {}
+
+        value_type operator*() const { return parent_->get_segment(block_idx_); }
+        iterator& operator++() {
+            ++block_idx_;
+            parent_->prefetch_ahead(block_idx_);
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+        bool operator==(const iterator& other) const { return block_idx_ == other.block_idx_; }
+        bool operator!=(const iterator& other) const { return block_idx_ != other.block_idx_; }
+
+    private:
+        size_t block_idx_;
+        parent_ptr parent_;
+    };
+
+    explicit BlockSegmentRange(parent_ptr parent) : parent_(parent) {}
+
+    iterator begin() const { return iterator(0, parent_); }
+    iterator end() const { return iterator(parent_->segment_count(), parent_); }
+    size_t size() const { return parent_->segment_count(); }
+    value_type operator[](size_t block_idx) const { return parent_->get_segment(block_idx); }
+
+private:
+    parent_ptr parent_;
+};
+
 // BlockVector Definitions
 
-namespace {
-constexpr size_t kDefaultBlockSize = 256;
-const size_t kDefaultBlockShift = 8;
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::BlockVector()
+    : BlockVector(Allocator()) {
 }
 
-template <typename T>
-BlockVector<T>::BlockVector()
-    : size_(0), capacity_(0), block_size_(kDefaultBlockSize), block_shift_(kDefaultBlockShift), block_mask_(kDefaultBlockSize - 1) {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::BlockVector(const Allocator& alloc)
+    : blocks_(nullptr), block_count_(0), table_capacity_(0), size_(0), capacity_(0),
+      max_spare_blocks_(kDefaultSpareBlocks), alloc_(alloc) {
 }
 
-template <typename T>
-BlockVector<T>::BlockVector(size_t n)
-    : size_(n), capacity_(0), block_size_(kDefaultBlockSize), block_shift_(kDefaultBlockShift), block_mask_(kDefaultBlockSize - 1) {
+// The sized constructors delegate to the allocator constructor so that the
+// destructor cleans up already constructed elements if a T constructor throws.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::BlockVector(size_t n, const Allocator& alloc)
+    : BlockVector(alloc) {
     if (n == 0) {
         return;
     }
 
-    while (block_size_ < n) {
-        block_size_ <<= 1;
+    fit_block_size(n);
+    reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        alloc_traits::construct(alloc_, &(*this)[i]);
+        ++size_;
     }
-    update_block_shift();
-    capacity_ = block_size_;
-    chunks_.emplace_back();
-    chunks_.back().reserve(block_size_);
-    chunks_.back().insert(chunks_.back().end(), n, T());
 }
 
-template <typename T>
-BlockVector<T>::BlockVector(size_t n, const T& value)
-    : size_(n), capacity_(0), block_size_(kDefaultBlockSize), block_shift_(kDefaultBlockShift), block_mask_(kDefaultBlockSize - 1) {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::BlockVector(size_t n, const T& value, const Allocator& alloc)
+    : BlockVector(alloc) {
     if (n == 0) {
         return;
     }
 
-    while (block_size_ < n) {
-        block_size_ <<= 1;
+    fit_block_size(n);
+    reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        alloc_traits::construct(alloc_, &(*this)[i], value);
+        ++size_;
     }
-    update_block_shift();
-    capacity_ = block_size_;
-    chunks_.emplace_back();
-    chunks_.back().reserve(block_size_);
-    chunks_.back().insert(chunks_.back().end(), n, value);
 }
 
-template <typename T>
-BlockVector<T>::BlockVector(std::initializer_list<T> init)
-    : size_(0), capacity_(0), block_size_(kDefaultBlockSize), block_shift_(kDefaultBlockShift), block_mask_(kDefaultBlockSize - 1) {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::BlockVector(size_t n, bv::for_overwrite_t, const Allocator& alloc)
+    : BlockVector(alloc) {
+    if (n == 0) {
+        return;
+    }
+
+    fit_block_size(n);
+    resize_default_init(n);
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::BlockVector(std::initializer_list<T> init, const Allocator& alloc)
+    : BlockVector(alloc) {
     size_t n = init.size();
     if (n == 0) {
         return;
     }
 
-    while (block_size_ < n) {
-        block_size_ <<= 1;
+    fit_block_size(n);
+    reserve(n);
+    for (const T& value : init) {
+        alloc_traits::construct(alloc_, &(*this)[size_], value);
+        ++size_;
     }
-    update_block_shift();
-    capacity_ = block_size_;
-    chunks_.emplace_back();
-    chunks_.back().reserve(block_size_);
-    chunks_.back().insert(chunks_.back().end(), init.begin(), init.end());
-    size_ = n;
 }
 
-template <typename T>
-BlockVector<T>::~BlockVector() = default;
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::BlockVector(const BlockVector& other)
+    : BlockVector(alloc_traits::select_on_container_copy_construction(other.alloc_)) {
+    copy_from(other);
+}
 
-template <typename T>
-T& BlockVector<T>::operator[](size_t index) {
-    size_t block_index = index >> block_shift_;
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::BlockVector(const BlockVector& other, const Allocator& alloc)
+    : BlockVector(alloc) {
+    copy_from(other);
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::BlockVector(BlockVector&& other) noexcept
+    : BlockVector(std::move(other.alloc_)) {
+    steal_from(other);
+}
+
+// With an unequal allocator the blocks cannot change owner, so the elements
+// are moved one by one into storage obtained from `alloc`.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::BlockVector(BlockVector&& other, const Allocator& alloc)
+    : BlockVector(alloc) {
+    if (alloc_ == other.alloc_) {
+        steal_from(other);
+        return;
+    }
+    this->assign_block_size(other.block_size_);
+    max_spare_blocks_ = other.max_spare_blocks_;
+    reserve(other.size_);
+    for (size_t i = 0; i < other.size_; ++i) {
+        alloc_traits::construct(alloc_, &(*this)[i], std::move(other[i]));
+        ++size_;
+    }
+    other.clear();
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::operator=(const BlockVector& other) {
+    if (this == &other) {
+        return *this;
+    }
+    bv::detail::BlockOwnership::copy_allocator(*this, other);
+    copy_from(other);
+    return *this;
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::operator=(BlockVector&& other) noexcept(
+    alloc_traits::propagate_on_container_move_assignment::value ||
+    alloc_traits::is_always_equal::value) {
+    if (this == &other) {
+        return *this;
+    }
+    if (bv::detail::BlockOwnership::move_storage(*this, other)) {
+        return *this;
+    }
+    clear();
+    if (block_size_ != other.block_size_) {
+        release_storage();
+        this->assign_block_size(other.block_size_);
+    }
+    max_spare_blocks_ = other.max_spare_blocks_;
+    reserve(other.size_);
+    for (size_t i = 0; i < other.size_; ++i) {
+        alloc_traits::construct(alloc_, &(*this)[i], std::move(other[i]));
+        ++size_;
+    }
+    other.clear();
+    return *this;
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::~BlockVector() {
+    release_storage();
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+typename BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::allocator_type BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::get_allocator() const {
+    return alloc_;
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::swap(BlockVector& other) noexcept {
+    using std::swap;
+    bv::detail::BlockOwnership::swap_allocators(*this, other);
+    swap(blocks_, other.blocks_);
+    swap(block_count_, other.block_count_);
+    swap(table_capacity_, other.table_capacity_);
+    swap(size_, other.size_);
+    swap(capacity_, other.capacity_);
+    swap(max_spare_blocks_, other.max_spare_blocks_);
+    this->swap_geometry(other);
+    swap(stats_policy(), other.stats_policy());
+}
+
+// Snapshot of the Stats policy counters plus the bytes currently in use.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+bv::StatsSnapshot BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::stats_snapshot() const {
+    bv::StatsSnapshot snapshot = stats().snapshot();
+    snapshot.bytes_used = static_cast<uint64_t>(size_) * sizeof(T);
+    return snapshot;
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+T& BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::operator[](size_t index) {
     // size_t offset = index % block_size_;
-    size_t offset = index & block_mask_;
-    return chunks_[block_index][offset];
+    return blocks_[index >> block_shift_][index & block_mask_];
 }
 
-template <typename T>
-const T& BlockVector<T>::operator[](size_t index) const {
-    size_t block_index = index >> block_shift_;
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+const T& BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::operator[](size_t index) const {
     // size_t offset = index % block_size_;
-    size_t offset = index & block_mask_;
-    return chunks_[block_index][offset];
+    return blocks_[index >> block_shift_][index & block_mask_];
 }
 
-template <typename T>
-T& BlockVector<T>::at(size_t index) {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+T& BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::at(size_t index) {
     if (index >= size_) {
         throw std::out_of_range("BlockVector::at");
     }
     return (*this)[index];
 }
 
-template <typename T>
-const T& BlockVector<T>::at(size_t index) const {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+const T& BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::at(size_t index) const {
     if (index >= size_) {
         throw std::out_of_range("BlockVector::at");
     }
     return (*this)[index];
 }
 
-template <typename T>
-T& BlockVector<T>::front() {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+T& BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::front() {
     return (*this)[0];
 }
 
-template <typename T>
-const T& BlockVector<T>::front() const {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+const T& BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::front() const {
     return (*this)[0];
 }
 
-template <typename T>
-T& BlockVector<T>::back() {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+T& BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::back() {
     return (*this)[size_ - 1];
 }
 
-template <typename T>
-const T& BlockVector<T>::back() const {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+const T& BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::back() const {
     return (*this)[size_ - 1];
 }
 
-template <typename T>
-size_t BlockVector<T>::size() const {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+size_t BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::size() const {
     return size_;
 }
 
-template <typename T>
-size_t BlockVector<T>::capacity() const {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+size_t BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::capacity() const {
     return capacity_;
 }
 
-template <typename T>
-bool BlockVector<T>::empty() const {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+bool BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::empty() const {
     return size_ == 0;
 }
 
-template <typename T>
-void BlockVector<T>::reserve(size_t newCapacity) {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::reserve(size_t newCapacity) {
     if (newCapacity <= capacity_) {
         return;
     }
-    if (block_size_ == 0) {
-        block_size_ = kDefaultBlockSize;
-        block_shift_ = kDefaultBlockShift;
-        block_mask_ = block_size_ - 1;
-    }
 
-    size_t required_blocks = (newCapacity + block_size_ - 1) / block_size_;
-    if (required_blocks <= chunks_.size()) {
-        capacity_ = required_blocks * block_size_;
-        return;
+    size_t required_blocks = (newCapacity + block_size_ - 1) >> block_shift_;
+    grow_table(required_blocks);
+    while (block_count_ < required_blocks) {
+        append_block();
     }
+}
 
-    size_t to_add = required_blocks - chunks_.size();
-    for (size_t i = 0; i < to_add; ++i) {
-        chunks_.emplace_back();
-        chunks_.back().reserve(block_size_);
+// Releases every block past the last element, including the spare ones. The
+// block table itself is left as is.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::shrink_to_fit() {
+    release_blocks_from((size_ + block_mask_) >> block_shift_);
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+size_t BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::max_spare_blocks() const {
+    return max_spare_blocks_;
+}
+
+// Lowering the limit releases surplus spare blocks right away.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::set_max_spare_blocks(size_t n) {
+    max_spare_blocks_ = n;
+    size_t keep = retained_blocks();
+    if (block_count_ > keep) {
+        release_blocks_from(keep);
     }
-    capacity_ = required_blocks * block_size_;
 }
 
-template <typename T>
-size_t BlockVector<T>::get_Block_size() const {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+size_t BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::get_Block_size() const {
     return block_size_;
 }
 
-template <typename T>
-size_t BlockVector<T>::set_Block_size(size_t new_block_size) {
-    if (size_ != 0 || new_block_size == 0) {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+size_t BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::set_Block_size(size_t new_block_size) {
+    if (Geometry::kFixedBlockSize || size_ != 0 || new_block_size == 0) {
         return block_size_;
     }
 
@@ -428,179 +1148,494 @@ size_t BlockVector<T>::set_Block_size(size_t new_block_size) {
     while (rounded < new_block_size) {
         rounded <<= 1;
     }
-    block_size_ = rounded;
-    update_block_shift();
-    chunks_.clear();
-    capacity_ = 0;
+    release_storage();
+    this->assign_block_size(rounded);
     return block_size_;
 }
 
-template <typename T>
-void BlockVector<T>::update_block_shift() {
-    block_shift_ = 0;
-    size_t value = block_size_;
-    while (value > 1) {
-        value >>= 1;
-        ++block_shift_;
+// The sized constructors put their n elements into a single block when the
+// block size is chosen at run time. With a compile-time shift the geometry is
+// fixed and the elements simply span several blocks.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::fit_block_size(size_t n) {
+    if (Geometry::kFixedBlockSize) {
+        return;
     }
-    block_mask_ = block_size_ - 1;
+    size_t rounded = block_size_;
+    while (rounded < n) {
+        rounded <<= 1;
+    }
+    this->assign_block_size(rounded);
 }
 
-template <typename T>
-void BlockVector<T>::push_back(const T& value) {
+// Number of constructed elements in block `block_idx`.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+size_t BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::block_used(size_t block_idx) const {
+    size_t first = block_idx << block_shift_;
+    if (first >= size_) {
+        return 0;
+    }
+    size_t remaining = size_ - first;
+    return remaining < block_size_ ? remaining : block_size_;
+}
+
+// Blocks pop_back/resize keep: the ones holding elements plus up to
+// max_spare_blocks_ empty ones, and never fewer than one.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+size_t BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::retained_blocks() const {
+    size_t keep = ((size_ + block_mask_) >> block_shift_) + max_spare_blocks_;
+    return keep > 0 ? keep : 1;
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+T* BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::allocate_block() {
+    T* block = alloc_traits::allocate(alloc_, block_size_);
+    stats_policy().on_block_allocate(block_size_ * sizeof(T));
+    return block;
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::deallocate_block(T* block) {
+    alloc_traits::deallocate(alloc_, block, block_size_);
+    stats_policy().on_block_deallocate(block_size_ * sizeof(T));
+}
+
+// Makes room in the block table for at least `min_blocks` entries. Only the
+// table of pointers moves; the blocks themselves stay where they are.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::grow_table(size_t min_blocks) {
+    if (min_blocks <= table_capacity_) {
+        return;
+    }
+    size_t new_capacity = table_capacity_ == 0 ? kMinBlockTableCapacity : table_capacity_ * 2;
+    while (new_capacity < min_blocks) {
+        new_capacity *= 2;
+    }
+    table_allocator table_alloc(alloc_);
+    T** new_table = table_traits::allocate(table_alloc, new_capacity);
+    for (size_t i = 0; i < block_count_; ++i) {
+        new_table[i] = blocks_[i];
+    }
+    if (blocks_ != nullptr) {
+        table_traits::deallocate(table_alloc, blocks_, table_capacity_);
+    }
+    blocks_ = new_table;
+    table_capacity_ = new_capacity;
+    stats_policy().on_table_grow(new_capacity * sizeof(T*));
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::append_block() {
+    grow_table(block_count_ + 1);
+    blocks_[block_count_] = allocate_block();
+    ++block_count_;
+    capacity_ += block_size_;
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::release_last_block() {
+    --block_count_;
+    deallocate_block(blocks_[block_count_]);
+    capacity_ -= block_size_;
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::release_blocks_from(size_t first_block) {
+    while (block_count_ > first_block) {
+        release_last_block();
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::destroy_range(size_t first, size_t last) {
+    if (std::is_trivially_destructible<T>::value) {
+        return;
+    }
+    for (size_t i = first; i < last; ++i) {
+        alloc_traits::destroy(alloc_, &(*this)[i]);
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::release_storage() {
+    destroy_range(0, size_);
+    size_ = 0;
+    release_blocks_from(0);
+    if (blocks_ != nullptr) {
+        table_allocator table_alloc(alloc_);
+        table_traits::deallocate(table_alloc, blocks_, table_capacity_);
+        blocks_ = nullptr;
+        table_capacity_ = 0;
+    }
+}
+
+// Replaces the contents with copies of `other`, adopting its block size.
+// Existing blocks are reused when the block sizes already match.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::copy_from(const BlockVector& other) {
+    clear();
+    if (block_size_ != other.block_size_) {
+        release_storage();
+        this->assign_block_size(other.block_size_);
+    }
+    max_spare_blocks_ = other.max_spare_blocks_;
+    reserve(other.size_);
+    for (size_t i = 0; i < other.size_; ++i) {
+        alloc_traits::construct(alloc_, &(*this)[i], other[i]);
+        ++size_;
+    }
+}
+
+// Also carries over the block size, spare-block limit and Stats counters.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::steal_from(BlockVector& other) noexcept {
+    blocks_ = other.blocks_;
+    block_count_ = other.block_count_;
+    table_capacity_ = other.table_capacity_;
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    max_spare_blocks_ = other.max_spare_blocks_;
+    this->assign_block_size(other.block_size_);
+    other.blocks_ = nullptr;
+    other.block_count_ = 0;
+    other.table_capacity_ = 0;
+    other.size_ = 0;
+    other.capacity_ = 0;
+    stats_policy() = std::move(other.stats_policy());
+    other.stats_policy() = Stats();
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::push_back(const T& value) {
+    uint64_t token = stats_policy().on_push_begin();
     if (size_ == capacity_) {
-        chunks_.emplace_back();
-        chunks_.back().reserve(block_size_);
-        capacity_ += block_size_;
+        append_block();
     }
-    chunks_.back().push_back(value);
+    alloc_traits::construct(alloc_, &(*this)[size_], value);
     ++size_;
+    stats_policy().on_push_end(token);
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::push_back(T&& value) {
+    uint64_t token = stats_policy().on_push_begin();
+    if (size_ == capacity_) {
+        append_block();
+    }
+    alloc_traits::construct(alloc_, &(*this)[size_], std::move(value));
+    ++size_;
+    stats_policy().on_push_end(token);
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
 template <typename... Args>
-T& BlockVector<T>::emplace_back(Args&&... args) {
+T& BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::emplace_back(Args&&... args) {
+    uint64_t token = stats_policy().on_push_begin();
     if (size_ == capacity_) {
-        chunks_.emplace_back();
-        chunks_.back().reserve(block_size_);
-        capacity_ += block_size_;
+        append_block();
     }
-    chunks_.back().emplace_back(std::forward<Args>(args)...);
+    T* slot = &(*this)[size_];
+    alloc_traits::construct(alloc_, slot, std::forward<Args>(args)...);
     ++size_;
-    return chunks_.back().back();
+    stats_policy().on_push_end(token);
+    return *slot;
 }
 
-template <typename T>
-void BlockVector<T>::pop_back() {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::pop_back() {
     if (size_ == 0) {
         return;
     }
-    chunks_.back().pop_back();
     --size_;
-    if (chunks_.back().empty() && chunks_.size() > 1) {
-        chunks_.pop_back();
-        capacity_ -= block_size_;
+    alloc_traits::destroy(alloc_, &(*this)[size_]);
+    if (block_count_ > retained_blocks()) {
+        release_last_block();
     }
 }
 
-template <typename T>
-void BlockVector<T>::clear() {
-    for (auto& chunk : chunks_) {
-        chunk.clear();
-    }
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::clear() {
+    destroy_range(0, size_);
     size_ = 0;
 }
 
-template <typename T>
-void BlockVector<T>::resize(size_t n) {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::resize(size_t n) {
     if (n < size_) {
-        while (size_ > n) {
-            pop_back();
-        }
+        destroy_range(n, size_);
+        size_ = n;
+        release_blocks_from(retained_blocks());
         return;
     }
 
     if (n > size_) {
         reserve(n);
-        size_t remaining = n - size_;
-        while (remaining > 0) {
-            size_t room = block_size_ - chunks_.back().size();
-            size_t count = std::min(remaining, room);
-            chunks_.back().insert(chunks_.back().end(), count, T{});
-            size_ += count;
-            remaining -= count;
-            if (remaining > 0) {
-                chunks_.emplace_back();
-                chunks_.back().reserve(block_size_);
-            }
+        while (size_ < n) {
+            alloc_traits::construct(alloc_, &(*this)[size_]);
+            ++size_;
         }
     }
 }
 
-template <typename T>
-typename BlockVector<T>::iterator BlockVector<T>::begin() {
-    if (size_ == 0) {
-        return end();
+// Like resize, but new elements are default-initialized instead of
+// value-initialized: for trivially default-constructible T the blocks are only
+// allocated and never written, so the caller must overwrite them before reading.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::resize_default_init(size_t n) {
+    if (n <= size_) {
+        resize(n);
+        return;
     }
 
-    size_t block_idx = 0;
-    while (block_idx < chunks_.size() && chunks_[block_idx].empty()) {
-        ++block_idx;
+    reserve(n);
+    if (std::is_trivially_default_constructible<T>::value) {
+        size_ = n;
+        return;
+    }
+    while (size_ < n) {
+        ::new (static_cast<void*>(&(*this)[size_])) T;
+        ++size_;
     }
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+template <typename InputIt, typename>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::append(InputIt first, InputIt last) {
+    append_range(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+}
 
-    if (block_idx >= chunks_.size()) {
-        return end();
+// Copies `count` elements starting at `first` onto the end. Blocks never move,
+// so `first` may point into this container. Trivially copyable T from a
+// contiguous source is copied with one memcpy per block.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+template <typename InputIt>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::append_n(InputIt first, size_t count) {
+    using is_raw_copy = std::integral_constant<bool,
+        std::is_trivially_copyable<T>::value && bv::detail::is_contiguous_iterator<InputIt>::value &&
+        std::is_same<typename std::remove_cv<typename std::iterator_traits<InputIt>::value_type>::type, T>::value>;
+
+    reserve(size_ + count);
+    if (count == 0) {
+        return;
+    }
+    auto source = bv::detail::run_source(first, is_raw_copy());
+    while (count > 0) {
+        size_t run = block_size_ - (size_ & block_mask_);
+        if (run > count) {
+            run = count;
+        }
+        source = construct_run(source, run, is_raw_copy());
+        count -= run;
     }
+}
 
-    auto& chunk = chunks_[block_idx];
-    return iterator(block_idx, chunk.data(), chunk.data() + chunk.size(), this);
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+template <typename Range, typename>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::append(const Range& range) {
+    append_n(range.data(), range.size());
 }
 
-template <typename T>
-typename BlockVector<T>::iterator BlockVector<T>::end() {
-    return iterator(chunks_.size(), nullptr, nullptr, this);
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::append(std::initializer_list<T> init) {
+    append_n(init.begin(), init.size());
 }
 
-template <typename T>
-typename BlockVector<T>::const_iterator BlockVector<T>::begin() const {
-    if (size_ == 0) {
-        return end();
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+template <typename InputIt, typename>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::assign(InputIt first, InputIt last) {
+    clear();
+    append(first, last);
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::assign(size_t count, const T& value) {
+    clear();
+    reserve(count);
+    while (size_ < count) {
+        alloc_traits::construct(alloc_, &(*this)[size_], value);
+        ++size_;
     }
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::assign(std::initializer_list<T> init) {
+    clear();
+    append_n(init.begin(), init.size());
+}
 
-    size_t block_idx = 0;
-    while (block_idx < chunks_.size() && chunks_[block_idx].empty()) {
-        ++block_idx;
+// Single-pass input: the length is unknown, so grow as push_back would.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+template <typename InputIt>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::append_range(InputIt first, InputIt last, std::input_iterator_tag) {
+    for (; first != last; ++first) {
+        emplace_back(*first);
     }
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+template <typename ForwardIt>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::append_range(ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+    append_n(first, static_cast<size_t>(std::distance(first, last)));
+}
 
-    if (block_idx >= chunks_.size()) {
-        return end();
+// Constructs `count` elements at the end, which must fit in the current block.
+// size_ advances per element so a throwing constructor leaves no gap.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+template <typename InputIt>
+InputIt BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::construct_run(InputIt first, size_t count, std::false_type) {
+    T* dest = &(*this)[size_];
+    for (size_t i = 0; i < count; ++i, ++first) {
+        alloc_traits::construct(alloc_, dest + i, *first);
+        ++size_;
     }
+    return first;
+}
 
-    const auto& chunk = chunks_[block_idx];
-    return const_iterator(block_idx, const_cast<T*>(chunk.data()), const_cast<T*>(chunk.data() + chunk.size()), this);
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+template <typename Ptr>
+Ptr BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::construct_run(Ptr first, size_t count, std::true_type) {
+    std::memcpy(static_cast<void*>(&(*this)[size_]), static_cast<const void*>(first), count * sizeof(T));
+    size_ += count;
+    return first + count;
 }
 
-template <typename T>
-typename BlockVector<T>::const_iterator BlockVector<T>::cbegin() const {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+typename BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::iterator BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::begin() {
+    return iterator(0, this);
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+typename BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::iterator BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::end() {
+    return iterator(size_, this);
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+typename BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::const_iterator BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::begin() const {
+    return const_iterator(0, this);
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+typename BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::const_iterator BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::cbegin() const {
     return begin();
 }
 
-template <typename T>
-typename BlockVector<T>::const_iterator BlockVector<T>::end() const {
-    return const_iterator(chunks_.size(), nullptr, nullptr, this);
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+typename BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::const_iterator BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::end() const {
+    return const_iterator(size_, this);
 }
 
-template <typename T>
-typename BlockVector<T>::const_iterator BlockVector<T>::cend() const {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+typename BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::const_iterator BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::cend() const {
     return end();
 }
 
-template <typename T>
-typename BlockVector<T>::reverse_iterator BlockVector<T>::rbegin() {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+typename BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::reverse_iterator BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::rbegin() {
     return reverse_iterator(end());
 }
 
-template <typename T>
-typename BlockVector<T>::const_reverse_iterator BlockVector<T>::rbegin() const {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+typename BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::const_reverse_iterator BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::rbegin() const {
     return const_reverse_iterator(end());
 }
 
-template <typename T>
-typename BlockVector<T>::const_reverse_iterator BlockVector<T>::crbegin() const {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+typename BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::const_reverse_iterator BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::crbegin() const {
     return const_reverse_iterator(end());
 }
 
-template <typename T>
-typename BlockVector<T>::reverse_iterator BlockVector<T>::rend() {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+typename BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::reverse_iterator BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::rend() {
     return reverse_iterator(begin());
 }
 
-template <typename T>
-typename BlockVector<T>::const_reverse_iterator BlockVector<T>::rend() const {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+typename BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::const_reverse_iterator BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::rend() const {
     return const_reverse_iterator(begin());
 }
 
-template <typename T>
-typename BlockVector<T>::const_reverse_iterator BlockVector<T>::crend() const {
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+typename BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::const_reverse_iterator BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::crend() const {
     return const_reverse_iterator(begin());
 }
+
+// Number of blocks that hold at least one element.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+size_t BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::segment_count() const {
+    return (size_ + block_mask_) >> block_shift_;
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+typename BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::segment
+BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::get_segment(size_t block_idx) {
+    return segment{blocks_[block_idx], block_used(block_idx)};
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+typename BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::const_segment
+BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::get_segment(size_t block_idx) const {
+    return const_segment{blocks_[block_idx], block_used(block_idx)};
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+typename BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::segment_range BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::segments() {
+    return segment_range(this);
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+typename BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::const_segment_range BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::segments() const {
+    return const_segment_range(this);
+}
+
+// Calls fn(segment) for every non-empty block in order. All blocks but the
+// last are full, so only the final call sees a short segment.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+template <typename Func>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::for_each_segment(Func&& fn) {
+    size_t full_blocks = size_ >> block_shift_;
+    for (size_t b = 0; b < full_blocks; ++b) {
+        prefetch_ahead(b);
+        fn(segment{blocks_[b], block_size_});
+    }
+    size_t tail = size_ & block_mask_;
+    if (tail != 0) {
+        fn(segment{blocks_[full_blocks], tail});
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+template <typename Func>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::for_each_segment(Func&& fn) const {
+    size_t full_blocks = size_ >> block_shift_;
+    for (size_t b = 0; b < full_blocks; ++b) {
+        prefetch_ahead(b);
+        fn(const_segment{blocks_[b], block_size_});
+    }
+    size_t tail = size_ & block_mask_;
+    if (tail != 0) {
+        fn(const_segment{blocks_[full_blocks], tail});
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::prefetch_ahead(size_t block_idx) const {
+    bv::detail::prefetch_block_ahead<Prefetch>(blocks_, block_count_, block_idx, block_size_ * sizeof(T));
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void swap(BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& lhs, BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+// BlockVector with a block size of 2^BlockShift fixed at compile time.
+template <typename T, size_t BlockShift>
+using FixedBlockVector = BlockVector<T, std::allocator<T>, BlockShift>;
+
+#if __has_include(<memory_resource>)
+namespace pmr {
+// BlockVector whose blocks and block table come from a std::pmr::memory_resource,
+// e.g. a monotonic_buffer_resource that is released in one shot.
+template <typename T>
+using BlockVector = ::BlockVector<T, std::pmr::polymorphic_allocator<T>>;
+}
+#endif
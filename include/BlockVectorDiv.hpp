@@ -238,7 +238,7 @@ void BlockVectorDiv<T>::push_back(const T& value) {
         chunks_.back().reserve(block_size_);
         capacity_ += block_size_;
     }
-    chunks_.back().push_back(value);
+    chunks_[size_ / block_size_].push_back(value);
     ++size_;
 }
 
@@ -247,8 +247,8 @@ void BlockVectorDiv<T>::pop_back() {
     if (size_ == 0) {
         return;
     }
-    chunks_.back().pop_back();
     --size_;
+    chunks_[size_ / block_size_].pop_back();
     if (chunks_.back().empty() && chunks_.size() > 1) {
         chunks_.pop_back();
         capacity_ -= block_size_;
@@ -274,17 +274,11 @@ void BlockVectorDiv<T>::resize(size_t n) {
 
     if (n > size_) {
         reserve(n);
-        size_t remaining = n - size_;
-        while (remaining > 0) {
-            size_t room = block_size_ - chunks_.back().size();
-            size_t count = std::min(remaining, room);
-            chunks_.back().insert(chunks_.back().end(), count, T{});
+        while (size_ < n) {
+            auto& chunk = chunks_[size_ / block_size_];
+            size_t count = std::min(n - size_, block_size_ - chunk.size());
+            chunk.insert(chunk.end(), count, T{});
             size_ += count;
-            remaining -= count;
-            if (remaining > 0) {
-                chunks_.emplace_back();
-                chunks_.back().reserve(block_size_);
-            }
         }
     }
 }
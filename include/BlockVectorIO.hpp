@@ -0,0 +1,287 @@
+#pragma once
+#include "BlockVector.hpp"
+
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+// The file-descriptor overloads need POSIX scatter/gather I/O; the stream
+// overloads are portable.
+#if __has_include(<sys/uio.h>) && __has_include(<unistd.h>)
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define BV_IO_HAS_FD 1
+#endif
+
+// Binary save/load for BlockVectors of trivially copyable T.
+//
+// The format is a 32-byte header (magic, version, element size, block size,
+// element count) followed by the elements as raw bytes in index order. The
+// block size is informational: a file can be loaded into a container with any
+// geometry, and a container with a run-time block size adopts the one in the
+// file. Data moves straight between the blocks and the file descriptor with
+// writev/readv (up to IOV_MAX blocks per call), or with one write/read per
+// block for streams; nothing is formatted or staged in a contiguous buffer.
+// Values are stored in host byte order.
+//
+// Headers are not trusted: the block size is bounded and never adopted larger
+// than the element count needs, the element count is
+// checked against the remaining input when its length is known, and loads
+// grow the container in bounded chunks, so a truncated or hostile file cannot
+// force an allocation much larger than the data it actually contains.
+namespace bv {
+namespace detail {
+constexpr uint64_t kSerialMagic = 0x0031534256424b42ULL; // "BKBVBS1"
+constexpr uint32_t kSerialVersion = 1;
+
+// Largest block, in bytes, a loaded file may ask for.
+constexpr uint64_t kMaxSerialBlockBytes = static_cast<uint64_t>(1) << 30;
+// Elements are read in chunks of this many bytes, allocating each chunk only
+// after the previous one arrived.
+constexpr size_t kLoadChunkBytes = static_cast<size_t>(64) << 20;
+
+struct SerialHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t element_size;
+    uint64_t block_size;
+    uint64_t count;
+};
+
+template <typename T>
+SerialHeader make_serial_header(size_t block_size, size_t count) {
+    return SerialHeader{kSerialMagic, kSerialVersion, static_cast<uint32_t>(sizeof(T)),
+                        static_cast<uint64_t>(block_size), static_cast<uint64_t>(count)};
+}
+
+// Length of the input still to be read, or -1 when it cannot be determined
+// (pipes, sockets, unseekable streams).
+constexpr int64_t kUnknownLength = -1;
+
+// `remaining` is the number of payload bytes left after the header, or
+// kUnknownLength.
+template <typename T>
+void check_serial_header(const SerialHeader& header, int64_t remaining) {
+    if (header.magic != kSerialMagic) {
+        throw std::runtime_error("bv::load: not a serialized BlockVector");
+    }
+    if (header.version != kSerialVersion || header.element_size != sizeof(T)) {
+        throw std::runtime_error("bv::load: version or element size mismatch");
+    }
+    if (header.block_size == 0 || (header.block_size & (header.block_size - 1)) != 0 ||
+        header.block_size > kMaxSerialBlockBytes / sizeof(T)) {
+        throw std::runtime_error("bv::load: corrupt header");
+    }
+    if (header.count > SIZE_MAX / sizeof(T) ||
+        (remaining != kUnknownLength && header.count > static_cast<uint64_t>(remaining) / sizeof(T))) {
+        throw std::runtime_error("bv::load: element count exceeds the input");
+    }
+}
+
+// Calls fn(ptr, count) for the contiguous pieces of [first, last) in `vec`.
+template <typename Vec, typename Func>
+void for_each_piece(Vec& vec, size_t first, size_t last, Func&& fn) {
+    size_t block = vec.get_Block_size();
+    while (first < last) {
+        size_t count = block - (first & (block - 1));
+        if (count > last - first) {
+            count = last - first;
+        }
+        vec.prefetch_ahead(first / block);
+        fn(&vec[first], count);
+        first += count;
+    }
+}
+
+// Bytes between the read position of `in` and its end, or kUnknownLength if
+// the stream cannot seek.
+inline int64_t remaining_bytes(std::istream& in) {
+    std::istream::pos_type pos = in.tellg();
+    if (pos == std::istream::pos_type(-1) || !in.seekg(0, std::ios::end)) {
+        in.clear();
+        return kUnknownLength;
+    }
+    std::istream::pos_type end = in.tellg();
+    in.seekg(pos);
+    if (end == std::istream::pos_type(-1) || end < pos) {
+        return kUnknownLength;
+    }
+    return static_cast<int64_t>(end - pos);
+}
+
+// Adopts the stored block size in the emptied `vec` if the geometry is chosen
+// at run time, clamped to the power of two that holds `count` elements, so the
+// first block is no larger than the payload. An empty file keeps the current
+// block size. No elements are allocated yet.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void prepare_load(BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec, const SerialHeader& header) {
+    if (header.count == 0) {
+        return;
+    }
+    // header.block_size is a power of two, so this stops at the smaller bound.
+    uint64_t block_size = 1;
+    while (block_size < header.count && block_size < header.block_size) {
+        block_size <<= 1;
+    }
+    if (block_size != vec.get_Block_size()) {
+        vec.set_Block_size(static_cast<size_t>(block_size));
+    }
+}
+
+// Grows `vec` to `count` elements one chunk at a time, calling
+// read(first, last) to fill each new chunk before allocating the next.
+template <typename Vec, typename Read>
+void load_chunks(Vec& vec, size_t count, Read&& read) {
+    using T = typename Vec::value_type;
+    size_t chunk = kLoadChunkBytes / sizeof(T) > 0 ? kLoadChunkBytes / sizeof(T) : 1;
+    try {
+        for (size_t first = 0; first < count;) {
+            size_t last = count - first > chunk ? first + chunk : count;
+            vec.resize_default_init(last);
+            read(first, last);
+            first = last;
+        }
+    } catch (...) {
+        vec.clear();
+        throw;
+    }
+}
+
+#if defined(BV_IO_HAS_FD)
+#ifdef IOV_MAX
+constexpr int kMaxIov = IOV_MAX;
+#else
+constexpr int kMaxIov = 1024;
+#endif
+
+// Transfers every byte described by iov[0, count), resuming after short
+// transfers and EINTR. `transfer` is ::writev or ::readv; iov is consumed.
+template <typename Transfer>
+void transfer_all(int fd, iovec* iov, int count, Transfer transfer, const char* what) {
+    while (count > 0) {
+        ssize_t done = transfer(fd, iov, count);
+        if (done < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+        if (done == 0) {
+            throw std::runtime_error(std::string(what) + ": unexpected end of file");
+        }
+        size_t left = static_cast<size_t>(done);
+        while (count > 0 && left >= iov->iov_len) {
+            left -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+            iov->iov_len -= left;
+        }
+    }
+}
+
+// Transfers the elements [first, last) of `vec`, preceded by `header` if it
+// is not null, in batches of at most kMaxIov entries.
+template <typename Vec, typename Transfer>
+void transfer_range(int fd, SerialHeader* header, Vec& vec, size_t first, size_t last, Transfer transfer,
+                    const char* what) {
+    iovec iov[kMaxIov];
+    int used = 0;
+    if (header != nullptr) {
+        iov[used++] = iovec{header, sizeof(*header)};
+    }
+    for_each_piece(vec, first, last, [&](auto* data, size_t count) {
+        iov[used++] = iovec{const_cast<void*>(static_cast<const void*>(data)), count * sizeof(*data)};
+        if (used == kMaxIov) {
+            transfer_all(fd, iov, used, transfer, what);
+            used = 0;
+        }
+    });
+    transfer_all(fd, iov, used, transfer, what);
+}
+
+// Bytes between the current position of `fd` and the end of the file, or
+// kUnknownLength if `fd` is not a regular file.
+inline int64_t remaining_bytes(int fd) {
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return kUnknownLength;
+    }
+    off_t pos = ::lseek(fd, 0, SEEK_CUR);
+    if (pos < 0 || pos > st.st_size) {
+        return kUnknownLength;
+    }
+    return static_cast<int64_t>(st.st_size - pos);
+}
+#endif
+} // namespace detail
+
+#if defined(BV_IO_HAS_FD)
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void save(const BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec, int fd) {
+    static_assert(std::is_trivially_copyable<T>::value, "bv::save requires a trivially copyable T");
+    detail::SerialHeader header = detail::make_serial_header<T>(vec.get_Block_size(), vec.size());
+    detail::transfer_range(fd, &header, vec, 0, vec.size(), ::writev, "bv::save");
+}
+
+// Replaces the contents of `vec` with the container stored at the current
+// position of `fd`. On failure `vec` is left empty.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void load(BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec, int fd) {
+    static_assert(std::is_trivially_copyable<T>::value, "bv::load requires a trivially copyable T");
+    vec.clear();
+    detail::SerialHeader header;
+    iovec head{&header, sizeof(header)};
+    detail::transfer_all(fd, &head, 1, ::readv, "bv::load");
+    detail::check_serial_header<T>(header, detail::remaining_bytes(fd));
+    detail::prepare_load(vec, header);
+    detail::load_chunks(vec, static_cast<size_t>(header.count), [&](size_t first, size_t last) {
+        detail::transfer_range(fd, nullptr, vec, first, last, ::readv, "bv::load");
+    });
+}
+#endif
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void save(const BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec, std::ostream& out) {
+    static_assert(std::is_trivially_copyable<T>::value, "bv::save requires a trivially copyable T");
+    detail::SerialHeader header = detail::make_serial_header<T>(vec.get_Block_size(), vec.size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    vec.for_each_segment([&](bv::BlockSpan<const T> seg) {
+        out.write(reinterpret_cast<const char*>(seg.data()),
+                  static_cast<std::streamsize>(seg.size() * sizeof(T)));
+    });
+    if (!out) {
+        throw std::runtime_error("bv::save: stream write failed");
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void load(BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec, std::istream& in) {
+    static_assert(std::is_trivially_copyable<T>::value, "bv::load requires a trivially copyable T");
+    vec.clear();
+    detail::SerialHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        throw std::runtime_error("bv::load: unexpected end of stream");
+    }
+    detail::check_serial_header<T>(header, detail::remaining_bytes(in));
+    detail::prepare_load(vec, header);
+    detail::load_chunks(vec, static_cast<size_t>(header.count), [&](size_t first, size_t last) {
+        detail::for_each_piece(vec, first, last, [&](T* data, size_t count) {
+            in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+        });
+        if (!in) {
+            throw std::runtime_error("bv::load: unexpected end of stream");
+        }
+    });
+}
+
+} // namespace bv
@@ -0,0 +1,546 @@
+#pragma once
+#include "BlockVector.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+// The std::execution overloads are opt-in: libstdc++'s <execution> pulls in
+// its TBB backend, which then has to be linked. Define
+// BV_ENABLE_EXECUTION_POLICIES (CMake does when it finds TBB) to get them.
+#if defined(BV_ENABLE_EXECUTION_POLICIES) && __has_include(<execution>)
+#include <execution>
+#if defined(__cpp_lib_execution)
+#define BV_HAS_EXECUTION_POLICIES 1
+#endif
+#endif
+
+namespace bv {
+
+// Fixed-size pool of worker threads. parallel_for(count, fn) runs fn(0) ..
+// fn(count - 1) across the workers and the calling thread and returns once
+// every task has finished; the first exception thrown by a task is rethrown
+// in the caller. A pool with concurrency 1 (or a call made from inside one of
+// its own tasks) simply runs the tasks inline.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t concurrency = std::thread::hardware_concurrency());
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    // Number of threads that execute tasks, including the caller.
+    size_t concurrency() const { return workers_.size() + 1; }
+
+    template <typename Func>
+    void parallel_for(size_t count, Func&& fn);
+
+private:
+    void worker_loop();
+    void run_tasks();
+    static bool& inside_task();
+
+    std::vector<std::thread> workers_;
+    std::mutex submit_mutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::function<void(size_t)> job_;
+    size_t job_count_ = 0;
+    std::atomic<size_t> next_task_{0};
+    size_t pending_workers_ = 0;
+    unsigned long long generation_ = 0;
+    bool stop_ = false;
+    std::exception_ptr error_;
+};
+
+inline ThreadPool::ThreadPool(size_t concurrency) {
+    if (concurrency == 0) {
+        concurrency = 1;
+    }
+    workers_.reserve(concurrency - 1);
+    for (size_t i = 1; i < concurrency; ++i) {
+        workers_.emplace_back([this]() { worker_loop(); });
+    }
+}
+
+inline ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+inline bool& ThreadPool::inside_task() {
+    thread_local bool flag = false;
+    return flag;
+}
+
+inline void ThreadPool::run_tasks() {
+    bool& flag = inside_task();
+    bool outer = flag;
+    flag = true;
+    for (size_t task = next_task_.fetch_add(1); task < job_count_; task = next_task_.fetch_add(1)) {
+        try {
+            job_(task);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+    }
+    flag = outer;
+}
+
+inline void ThreadPool::worker_loop() {
+    unsigned long long seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&]() { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+        }
+        run_tasks();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --pending_workers_;
+        }
+        done_.notify_one();
+    }
+}
+
+template <typename Func>
+void ThreadPool::parallel_for(size_t count, Func&& fn) {
+    if (count == 0) {
+        return;
+    }
+    if (workers_.empty() || count == 1 || inside_task()) {
+        for (size_t task = 0; task < count; ++task) {
+            fn(task);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(submit_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = std::ref(fn);
+        job_count_ = count;
+        next_task_.store(0);
+        pending_workers_ = workers_.size();
+        error_ = nullptr;
+        ++generation_;
+    }
+    wake_.notify_all();
+    run_tasks();
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [&]() { return pending_workers_ == 0; });
+        job_ = nullptr;
+        error = error_;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// Pool used by the algorithms below when none is passed explicitly.
+inline ThreadPool& default_thread_pool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+namespace detail {
+// Tasks per thread: a few more tasks than threads evens out uneven blocks.
+constexpr size_t kTasksPerThread = 4;
+
+// Splits the non-empty blocks of `vec` into contiguous block ranges and calls
+// body(task, first_index, segment) for every block, one range per task.
+// Returns the number of tasks used.
+template <typename Vec, typename Body>
+size_t parallel_segments(Vec& vec, ThreadPool& pool, Body&& body) {
+    size_t blocks = vec.segment_count();
+    size_t tasks = pool.concurrency() * kTasksPerThread;
+    if (tasks > blocks) {
+        tasks = blocks;
+    }
+    size_t block_size = vec.get_Block_size();
+    pool.parallel_for(tasks, [&](size_t task) {
+        size_t first = blocks * task / tasks;
+        size_t last = blocks * (task + 1) / tasks;
+        for (size_t b = first; b < last; ++b) {
+            vec.prefetch_ahead(b);
+            body(task, b * block_size, vec.get_segment(b));
+        }
+    });
+    return tasks;
+}
+
+#if defined(BV_HAS_EXECUTION_POLICIES)
+template <typename Policy>
+using enable_if_execution_policy =
+    typename std::enable_if<std::is_execution_policy<typename std::decay<Policy>::type>::value>::type;
+
+template <typename Policy>
+constexpr bool is_sequenced_policy() {
+    return std::is_same<typename std::decay<Policy>::type, std::execution::sequenced_policy>::value;
+}
+#endif
+} // namespace detail
+
+// Single-threaded pool used for std::execution::seq.
+inline ThreadPool& sequential_thread_pool() {
+    static ThreadPool pool(1);
+    return pool;
+}
+
+// Calls fn(element) for every element; fn must be safe to call concurrently.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch, typename Func>
+void for_each(BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec, Func fn, ThreadPool& pool = default_thread_pool()) {
+    detail::parallel_segments(vec, pool, [&](size_t, size_t, BlockSpan<T> seg) {
+        for (T& value : seg) {
+            fn(value);
+        }
+    });
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch, typename Func>
+void for_each(const BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec, Func fn, ThreadPool& pool = default_thread_pool()) {
+    detail::parallel_segments(vec, pool, [&](size_t, size_t, BlockSpan<const T> seg) {
+        for (const T& value : seg) {
+            fn(value);
+        }
+    });
+}
+
+// Resizes `out` to in.size() and stores fn(in[i]) into out[i].
+template <typename T, typename A1, size_t S1, typename St1, typename P1, typename U, typename A2, size_t S2, typename St2,
+          typename P2, typename Func>
+void transform(const BlockVector<T, A1, S1, St1, P1>& in, BlockVector<U, A2, S2, St2, P2>& out, Func fn,
+               ThreadPool& pool = default_thread_pool()) {
+    out.resize(in.size());
+    detail::parallel_segments(in, pool, [&](size_t, size_t first, BlockSpan<const T> seg) {
+        for (size_t i = 0; i < seg.size(); ++i) {
+            out[first + i] = fn(seg[i]);
+        }
+    });
+}
+
+// Combines all elements with `op`, which must be associative. Partial results
+// are combined in block order, so `op` need not be commutative.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch, typename Value, typename BinaryOp>
+Value reduce(const BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec, Value init, BinaryOp op,
+             ThreadPool& pool = default_thread_pool()) {
+    size_t max_tasks = pool.concurrency() * detail::kTasksPerThread;
+    std::vector<Value> partial(max_tasks, Value());
+    std::vector<unsigned char> used(max_tasks, 0);
+    size_t tasks = detail::parallel_segments(vec, pool, [&](size_t task, size_t, BlockSpan<const T> seg) {
+        size_t i = 0;
+        if (!used[task]) {
+            partial[task] = Value(seg[0]);
+            used[task] = 1;
+            i = 1;
+        }
+        Value acc = std::move(partial[task]);
+        for (; i < seg.size(); ++i) {
+            acc = op(std::move(acc), seg[i]);
+        }
+        partial[task] = std::move(acc);
+    });
+    for (size_t t = 0; t < tasks; ++t) {
+        if (used[t]) {
+            init = op(std::move(init), std::move(partial[t]));
+        }
+    }
+    return init;
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+T reduce(const BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec, ThreadPool& pool = default_thread_pool()) {
+    return bv::reduce(vec, T(), std::plus<>(), pool);
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch, typename Pred>
+size_t count_if(const BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec, Pred pred, ThreadPool& pool = default_thread_pool()) {
+    std::vector<size_t> partial(pool.concurrency() * detail::kTasksPerThread, 0);
+    size_t tasks = detail::parallel_segments(vec, pool, [&](size_t task, size_t, BlockSpan<const T> seg) {
+        size_t count = 0;
+        for (const T& value : seg) {
+            count += pred(value) ? 1 : 0;
+        }
+        partial[task] += count;
+    });
+    size_t total = 0;
+    for (size_t t = 0; t < tasks; ++t) {
+        total += partial[t];
+    }
+    return total;
+}
+
+namespace detail {
+// Merge path: how many elements of run `a` (length na) are among the first
+// `diag` outputs of a stable merge of `a` and `b` (length nb). Ties go to `a`.
+template <typename It, typename Compare>
+size_t merge_path_split(It a, size_t na, It b, size_t nb, size_t diag, Compare& comp) {
+    size_t lo = diag > nb ? diag - nb : 0;
+    size_t hi = diag < na ? diag : na;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (comp(b[diag - mid - 1], a[mid])) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+// Raw-pointer view of the index range [index, end) of a block container,
+// exposed one block piece at a time so merge loops run on plain pointers.
+template <typename Vec>
+struct BlockCursor {
+    using T = typename Vec::value_type;
+
+    BlockCursor(Vec& vec, size_t index, size_t end) : vec_(vec), index_(index), end_(end) { load(); }
+
+    bool done() const { return cur == stop; }
+    size_t available() const { return static_cast<size_t>(stop - cur); }
+
+    // Moves to the next block piece once the current one is used up.
+    void refill() {
+        if (cur == stop) {
+            load();
+        }
+    }
+
+    T* cur = nullptr;
+    T* stop = nullptr;
+
+private:
+    void load() {
+        if (index_ >= end_) {
+            cur = stop = nullptr;
+            return;
+        }
+        size_t block = vec_.get_Block_size();
+        size_t count = std::min(block - (index_ & (block - 1)), end_ - index_);
+        vec_.prefetch_ahead(index_ / block);
+        cur = &vec_[index_];
+        stop = cur + count;
+        index_ += count;
+    }
+
+    Vec& vec_;
+    size_t index_;
+    size_t end_;
+};
+
+// Stable merge of a and b into out, which has room for both. The inner loop
+// runs for as many steps as the shortest current piece allows, so it never
+// checks for a block boundary.
+template <typename Cursor, typename Compare>
+void merge_cursors(Cursor& a, Cursor& b, Cursor& out, Compare& comp) {
+    while (!a.done() && !b.done()) {
+        size_t step = std::min(std::min(a.available(), b.available()), out.available());
+        for (size_t k = 0; k < step; ++k) {
+            // Select rather than branch: the outcome is unpredictable on
+            // random keys, and this form can compile to conditional moves.
+            bool take_b = comp(*b.cur, *a.cur);
+            *out.cur++ = std::move(take_b ? *b.cur : *a.cur);
+            b.cur += take_b;
+            a.cur += !take_b;
+        }
+        a.refill();
+        b.refill();
+        out.refill();
+    }
+    for (Cursor* rest : {&a, &b}) {
+        while (!rest->done()) {
+            size_t step = std::min(rest->available(), out.available());
+            out.cur = std::move(rest->cur, rest->cur + step, out.cur);
+            rest->cur += step;
+            rest->refill();
+            out.refill();
+        }
+    }
+}
+
+// One merge pass: `in` holds sorted runs of `width` elements; adjacent pairs
+// are merged into runs of 2 * width in `out`. The output is cut into equal
+// slices, one per task, and merge_path_split finds where each slice starts
+// in its two input runs, so a long pair is merged by several tasks at once.
+template <typename Vec, typename Compare>
+void merge_pass(Vec& in, Vec& out, size_t width, ThreadPool& pool, Compare& comp) {
+    size_t n = in.size();
+    size_t tasks = pool.concurrency() * kTasksPerThread;
+    pool.parallel_for(tasks, [&](size_t task) {
+        size_t pos = n * task / tasks;
+        size_t stop = n * (task + 1) / tasks;
+        while (pos < stop) {
+            size_t first = pos - pos % (2 * width);
+            size_t middle = std::min(first + width, n);
+            size_t last = std::min(middle + width, n);
+            size_t slice_end = std::min(stop, last);
+            auto a = in.begin() + static_cast<std::ptrdiff_t>(first);
+            auto b = in.begin() + static_cast<std::ptrdiff_t>(middle);
+            size_t na = middle - first;
+            size_t nb = last - middle;
+            size_t a0 = merge_path_split(a, na, b, nb, pos - first, comp);
+            size_t a1 = merge_path_split(a, na, b, nb, slice_end - first, comp);
+            BlockCursor<Vec> run_a(in, first + a0, first + a1);
+            BlockCursor<Vec> run_b(in, middle + (pos - first - a0), middle + (slice_end - first - a1));
+            BlockCursor<Vec> dest(out, pos, slice_end);
+            merge_cursors(run_a, run_b, dest, comp);
+            pos = slice_end;
+        }
+    });
+}
+
+// Shortest run block_sort cuts a block into while looking for parallelism.
+constexpr size_t kMinSortRun = 1024;
+
+// Calls fn(first, last) for the runs [r * run, min((r + 1) * run, n)), split
+// into contiguous groups of runs, one group per task.
+template <typename Func>
+void parallel_runs(size_t n, size_t run, ThreadPool& pool, Func&& fn) {
+    size_t runs = (n + run - 1) / run;
+    size_t tasks = std::min(pool.concurrency() * kTasksPerThread, runs);
+    pool.parallel_for(tasks, [&](size_t task) {
+        for (size_t r = runs * task / tasks; r < runs * (task + 1) / tasks; ++r) {
+            fn(r * run, std::min(r * run + run, n));
+        }
+    });
+}
+
+// Sorts runs of contiguous storage, then merges runs of one, two, four ...
+// run lengths, alternating between `vec` and a scratch container with the
+// same block size. A run is one block, or a power-of-two piece of one when
+// there are too few blocks to keep every task busy (a sized constructor puts
+// all elements into a single block). Both the run sorts and the merges are
+// stable when `stable` is set.
+template <typename Vec, typename Compare>
+void block_sort(Vec& vec, Compare& comp, ThreadPool& pool, bool stable) {
+    using T = typename Vec::value_type;
+    size_t n = vec.size();
+    if (n < 2) {
+        return;
+    }
+    size_t run = vec.get_Block_size();
+    size_t tasks = pool.concurrency() * kTasksPerThread;
+    while (run > kMinSortRun && run * tasks > n) {
+        run /= 2;
+    }
+    parallel_runs(n, run, pool, [&](size_t first, size_t last) {
+        T* begin = &vec[first];
+        if (stable) {
+            std::stable_sort(begin, begin + (last - first), comp);
+        } else {
+            std::sort(begin, begin + (last - first), comp);
+        }
+    });
+    if (run >= n) {
+        return;
+    }
+
+    Vec scratch(vec.get_allocator());
+    scratch.set_Block_size(vec.get_Block_size());
+    scratch.resize_default_init(n);
+    Vec* in = &vec;
+    Vec* out = &scratch;
+    for (size_t width = run; width < n; width *= 2) {
+        merge_pass(*in, *out, width, pool, comp);
+        std::swap(in, out);
+    }
+    if (in != &vec) {
+        parallel_runs(n, run, pool, [&](size_t first, size_t last) {
+            std::move(&scratch[first], &scratch[first] + (last - first), &vec[first]);
+        });
+    }
+}
+} // namespace detail
+
+// Sorts `vec` with `comp`. Blocks (or pieces of oversized blocks) are sorted in
+// parallel on contiguous storage and then merged in parallel passes through a
+// scratch BlockVector of the same size, so T must be default-constructible and
+// move-assignable.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch, typename Compare>
+void sort(BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec, Compare comp, ThreadPool& pool = default_thread_pool()) {
+    detail::block_sort(vec, comp, pool, false);
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void sort(BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec, ThreadPool& pool = default_thread_pool()) {
+    bv::sort(vec, std::less<>(), pool);
+}
+
+// As bv::sort, but equal elements keep their relative order.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch, typename Compare>
+void stable_sort(BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec, Compare comp, ThreadPool& pool = default_thread_pool()) {
+    detail::block_sort(vec, comp, pool, true);
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+void stable_sort(BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec, ThreadPool& pool = default_thread_pool()) {
+    bv::stable_sort(vec, std::less<>(), pool);
+}
+
+#if defined(BV_HAS_EXECUTION_POLICIES)
+// std::execution overloads: sequenced_policy runs on the calling thread, every
+// other standard policy uses the default pool.
+template <typename Policy, typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch, typename Func,
+          typename = detail::enable_if_execution_policy<Policy>>
+void for_each(Policy&&, BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec, Func fn) {
+    bv::for_each(vec, fn, detail::is_sequenced_policy<Policy>() ? sequential_thread_pool() : default_thread_pool());
+}
+
+template <typename Policy, typename T, typename A1, size_t S1, typename St1, typename P1, typename U, typename A2, size_t S2, typename St2,
+          typename P2, typename Func,
+          typename = detail::enable_if_execution_policy<Policy>>
+void transform(Policy&&, const BlockVector<T, A1, S1, St1, P1>& in, BlockVector<U, A2, S2, St2, P2>& out, Func fn) {
+    bv::transform(in, out, fn, detail::is_sequenced_policy<Policy>() ? sequential_thread_pool() : default_thread_pool());
+}
+
+template <typename Policy, typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch, typename Value, typename BinaryOp,
+          typename = detail::enable_if_execution_policy<Policy>>
+Value reduce(Policy&&, const BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec, Value init, BinaryOp op) {
+    return bv::reduce(vec, std::move(init), op,
+                  detail::is_sequenced_policy<Policy>() ? sequential_thread_pool() : default_thread_pool());
+}
+
+template <typename Policy, typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch, typename Pred,
+          typename = detail::enable_if_execution_policy<Policy>>
+size_t count_if(Policy&&, const BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec, Pred pred) {
+    return bv::count_if(vec, pred, detail::is_sequenced_policy<Policy>() ? sequential_thread_pool() : default_thread_pool());
+}
+
+template <typename Policy, typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch, typename Compare = std::less<>,
+          typename = detail::enable_if_execution_policy<Policy>>
+void sort(Policy&&, BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec, Compare comp = Compare()) {
+    bv::sort(vec, comp, detail::is_sequenced_policy<Policy>() ? sequential_thread_pool() : default_thread_pool());
+}
+
+template <typename Policy, typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch, typename Compare = std::less<>,
+          typename = detail::enable_if_execution_policy<Policy>>
+void stable_sort(Policy&&, BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec, Compare comp = Compare()) {
+    bv::stable_sort(vec, comp, detail::is_sequenced_policy<Policy>() ? sequential_thread_pool() : default_thread_pool());
+}
+#endif
+
+} // namespace bv
@@ -0,0 +1,497 @@
+#pragma once
+#include "BlockVector.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__)) && defined(__SSE2__)
+#define BV_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define BV_SIMD_X86 0
+#endif
+
+// Block-wise SIMD reductions and searches for arithmetic element types.
+//
+// Every kernel runs directly over the contiguous storage of each block. For
+// int32_t, float and double an SSE2 or AVX2 kernel is picked at run time from
+// the CPU features; every other type, and every other platform, uses the
+// scalar loop. Floating-point sums are reassociated across lanes, so they can
+// differ from a sequential sum in the last bits, and min/max of data that
+// contains NaN is unspecified.
+namespace bv {
+namespace simd {
+
+enum class Isa { scalar = 0, sse2 = 1, avx2 = 2 };
+
+// Integers are summed in 64 bits, floating-point types in their own type.
+template <typename T>
+using sum_type = typename std::conditional<
+    std::is_floating_point<T>::value, T,
+    typename std::conditional<std::is_signed<T>::value, long long, unsigned long long>::type>::type;
+
+namespace detail {
+inline Isa detect_isa() {
+#if BV_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::avx2;
+    }
+    return Isa::sse2;
+#else
+    return Isa::scalar;
+#endif
+}
+
+inline std::atomic<int>& isa_limit() {
+    static std::atomic<int> limit{static_cast<int>(Isa::avx2)};
+    return limit;
+}
+
+// ---- scalar kernels (any arithmetic T) ----
+
+template <typename T>
+sum_type<T> sum_scalar(const T* data, size_t n) {
+    sum_type<T> acc = 0;
+    for (size_t i = 0; i < n; ++i) {
+        acc += data[i];
+    }
+    return acc;
+}
+
+template <typename T, bool IsMin>
+T extreme_scalar(const T* data, size_t n, T acc) {
+    for (size_t i = 0; i < n; ++i) {
+        if (IsMin ? data[i] < acc : acc < data[i]) {
+            acc = data[i];
+        }
+    }
+    return acc;
+}
+
+template <typename T>
+size_t find_scalar(const T* data, size_t n, T value) {
+    for (size_t i = 0; i < n; ++i) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return n;
+}
+
+template <typename T>
+size_t count_scalar(const T* data, size_t n, T value) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        count += data[i] == value ? 1 : 0;
+    }
+    return count;
+}
+
+#if BV_SIMD_X86
+#define BV_AVX2_TARGET __attribute__((target("avx2")))
+
+inline int lowest_bit(unsigned mask) {
+    return __builtin_ctz(mask);
+}
+
+// ---- per-ISA vector operations ----
+// Each Ops struct provides: load, splat, eq_mask (one bit per lane), min,
+// max, store, and acc_* for widening sums.
+
+struct Sse2Int32 {
+    using value_type = int32_t;
+    using vec = __m128i;
+    using acc = __m128i; // 2 x int64
+    static constexpr size_t kWidth = 4;
+
+    static vec load(const int32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static vec splat(int32_t v) { return _mm_set1_epi32(v); }
+    static unsigned eq_mask(vec a, vec b) {
+        return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))));
+    }
+    static vec min(vec a, vec b) {
+        __m128i gt = _mm_cmpgt_epi32(a, b);
+        return _mm_or_si128(_mm_and_si128(gt, b), _mm_andnot_si128(gt, a));
+    }
+    static vec max(vec a, vec b) {
+        __m128i gt = _mm_cmpgt_epi32(a, b);
+        return _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+    }
+    static void store(int32_t* out, vec v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(out), v); }
+    static acc acc_zero() { return _mm_setzero_si128(); }
+    static acc acc_add(acc sum, vec v) {
+        __m128i sign = _mm_srai_epi32(v, 31);
+        sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(v, sign));
+        return _mm_add_epi64(sum, _mm_unpackhi_epi32(v, sign));
+    }
+    static long long acc_reduce(acc sum) {
+        alignas(16) long long lanes[2];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), sum);
+        return lanes[0] + lanes[1];
+    }
+};
+
+struct Sse2Float {
+    using value_type = float;
+    using vec = __m128;
+    using acc = __m128;
+    static constexpr size_t kWidth = 4;
+
+    static vec load(const float* p) { return _mm_loadu_ps(p); }
+    static vec splat(float v) { return _mm_set1_ps(v); }
+    static unsigned eq_mask(vec a, vec b) { return static_cast<unsigned>(_mm_movemask_ps(_mm_cmpeq_ps(a, b))); }
+    static vec min(vec a, vec b) { return _mm_min_ps(a, b); }
+    static vec max(vec a, vec b) { return _mm_max_ps(a, b); }
+    static void store(float* out, vec v) { _mm_storeu_ps(out, v); }
+    static acc acc_zero() { return _mm_setzero_ps(); }
+    static acc acc_add(acc sum, vec v) { return _mm_add_ps(sum, v); }
+    static float acc_reduce(acc sum) {
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, sum);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+};
+
+struct Sse2Double {
+    using value_type = double;
+    using vec = __m128d;
+    using acc = __m128d;
+    static constexpr size_t kWidth = 2;
+
+    static vec load(const double* p) { return _mm_loadu_pd(p); }
+    static vec splat(double v) { return _mm_set1_pd(v); }
+    static unsigned eq_mask(vec a, vec b) { return static_cast<unsigned>(_mm_movemask_pd(_mm_cmpeq_pd(a, b))); }
+    static vec min(vec a, vec b) { return _mm_min_pd(a, b); }
+    static vec max(vec a, vec b) { return _mm_max_pd(a, b); }
+    static void store(double* out, vec v) { _mm_storeu_pd(out, v); }
+    static acc acc_zero() { return _mm_setzero_pd(); }
+    static acc acc_add(acc sum, vec v) { return _mm_add_pd(sum, v); }
+    static double acc_reduce(acc sum) {
+        alignas(16) double lanes[2];
+        _mm_store_pd(lanes, sum);
+        return lanes[0] + lanes[1];
+    }
+};
+
+struct Avx2Int32 {
+    using value_type = int32_t;
+    using vec = __m256i;
+    using acc = __m256i; // 4 x int64
+    static constexpr size_t kWidth = 8;
+
+    BV_AVX2_TARGET static vec load(const int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    BV_AVX2_TARGET static vec splat(int32_t v) { return _mm256_set1_epi32(v); }
+    BV_AVX2_TARGET static unsigned eq_mask(vec a, vec b) {
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))));
+    }
+    BV_AVX2_TARGET static vec min(vec a, vec b) { return _mm256_min_epi32(a, b); }
+    BV_AVX2_TARGET static vec max(vec a, vec b) { return _mm256_max_epi32(a, b); }
+    BV_AVX2_TARGET static void store(int32_t* out, vec v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v); }
+    BV_AVX2_TARGET static acc acc_zero() { return _mm256_setzero_si256(); }
+    BV_AVX2_TARGET static acc acc_add(acc sum, vec v) {
+        sum = _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+        return _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+    }
+    BV_AVX2_TARGET static long long acc_reduce(acc sum) {
+        alignas(32) long long lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sum);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+};
+
+struct Avx2Float {
+    using value_type = float;
+    using vec = __m256;
+    using acc = __m256;
+    static constexpr size_t kWidth = 8;
+
+    BV_AVX2_TARGET static vec load(const float* p) { return _mm256_loadu_ps(p); }
+    BV_AVX2_TARGET static vec splat(float v) { return _mm256_set1_ps(v); }
+    BV_AVX2_TARGET static unsigned eq_mask(vec a, vec b) {
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)));
+    }
+    BV_AVX2_TARGET static vec min(vec a, vec b) { return _mm256_min_ps(a, b); }
+    BV_AVX2_TARGET static vec max(vec a, vec b) { return _mm256_max_ps(a, b); }
+    BV_AVX2_TARGET static void store(float* out, vec v) { _mm256_storeu_ps(out, v); }
+    BV_AVX2_TARGET static acc acc_zero() { return _mm256_setzero_ps(); }
+    BV_AVX2_TARGET static acc acc_add(acc sum, vec v) { return _mm256_add_ps(sum, v); }
+    BV_AVX2_TARGET static float acc_reduce(acc sum) {
+        alignas(32) float lanes[8];
+        _mm256_store_ps(lanes, sum);
+        return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+    }
+};
+
+struct Avx2Double {
+    using value_type = double;
+    using vec = __m256d;
+    using acc = __m256d;
+    static constexpr size_t kWidth = 4;
+
+    BV_AVX2_TARGET static vec load(const double* p) { return _mm256_loadu_pd(p); }
+    BV_AVX2_TARGET static vec splat(double v) { return _mm256_set1_pd(v); }
+    BV_AVX2_TARGET static unsigned eq_mask(vec a, vec b) {
+        return static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)));
+    }
+    BV_AVX2_TARGET static vec min(vec a, vec b) { return _mm256_min_pd(a, b); }
+    BV_AVX2_TARGET static vec max(vec a, vec b) { return _mm256_max_pd(a, b); }
+    BV_AVX2_TARGET static void store(double* out, vec v) { _mm256_storeu_pd(out, v); }
+    BV_AVX2_TARGET static acc acc_zero() { return _mm256_setzero_pd(); }
+    BV_AVX2_TARGET static acc acc_add(acc sum, vec v) { return _mm256_add_pd(sum, v); }
+    BV_AVX2_TARGET static double acc_reduce(acc sum) {
+        alignas(32) double lanes[4];
+        _mm256_store_pd(lanes, sum);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+};
+
+// ---- generic loops ----
+// The same loops are stamped out once without a target attribute (SSE2 is
+// the x86-64 baseline) and once for AVX2, because GCC and Clang refuse to
+// inline AVX2 intrinsics into a function that is not itself compiled for AVX2.
+#define BV_SIMD_DEFINE_LOOPS(NS, TARGET)                                                        \
+    namespace NS {                                                                              \
+    template <typename Ops>                                                                     \
+    TARGET sum_type<typename Ops::value_type> sum(const typename Ops::value_type* data,         \
+                                                  size_t n) {                                   \
+        typename Ops::acc a0 = Ops::acc_zero();                                                 \
+        typename Ops::acc a1 = Ops::acc_zero();                                                 \
+        size_t i = 0;                                                                           \
+        for (; i + 2 * Ops::kWidth <= n; i += 2 * Ops::kWidth) {                                \
+            a0 = Ops::acc_add(a0, Ops::load(data + i));                                         \
+            a1 = Ops::acc_add(a1, Ops::load(data + i + Ops::kWidth));                           \
+        }                                                                                       \
+        for (; i + Ops::kWidth <= n; i += Ops::kWidth) {                                        \
+            a0 = Ops::acc_add(a0, Ops::load(data + i));                                         \
+        }                                                                                       \
+        sum_type<typename Ops::value_type> total = Ops::acc_reduce(a0) + Ops::acc_reduce(a1);   \
+        return total + sum_scalar(data + i, n - i);                                             \
+    }                                                                                           \
+                                                                                                \
+    template <typename Ops, bool IsMin>                                                         \
+    TARGET typename Ops::value_type extreme(const typename Ops::value_type* data, size_t n,     \
+                                            typename Ops::value_type acc) {                     \
+        using T = typename Ops::value_type;                                                     \
+        size_t i = 0;                                                                           \
+        if (n >= Ops::kWidth) {                                                                 \
+            typename Ops::vec best = Ops::splat(acc);                                           \
+            for (; i + Ops::kWidth <= n; i += Ops::kWidth) {                                    \
+                best = IsMin ? Ops::min(best, Ops::load(data + i))                              \
+                             : Ops::max(best, Ops::load(data + i));                             \
+            }                                                                                   \
+            T lanes[Ops::kWidth];                                                               \
+            Ops::store(lanes, best);                                                            \
+            acc = extreme_scalar<T, IsMin>(lanes, Ops::kWidth, acc);                            \
+        }                                                                                       \
+        return extreme_scalar<T, IsMin>(data + i, n - i, acc);                                  \
+    }                                                                                           \
+                                                                                                \
+    template <typename Ops>                                                                     \
+    TARGET size_t find(const typename Ops::value_type* data, size_t n,                          \
+                       typename Ops::value_type value) {                                        \
+        typename Ops::vec needle = Ops::splat(value);                                           \
+        size_t i = 0;                                                                           \
+        for (; i + Ops::kWidth <= n; i += Ops::kWidth) {                                        \
+            unsigned mask = Ops::eq_mask(Ops::load(data + i), needle);                          \
+            if (mask != 0) {                                                                    \
+                return i + static_cast<size_t>(lowest_bit(mask));                               \
+            }                                                                                   \
+        }                                                                                       \
+        return i + find_scalar(data + i, n - i, value);                                         \
+    }                                                                                           \
+                                                                                                \
+    template <typename Ops>                                                                     \
+    TARGET size_t count(const typename Ops::value_type* data, size_t n,                         \
+                        typename Ops::value_type value) {                                       \
+        typename Ops::vec needle = Ops::splat(value);                                           \
+        size_t total = 0;                                                                       \
+        size_t i = 0;                                                                           \
+        for (; i + Ops::kWidth <= n; i += Ops::kWidth) {                                        \
+            total += static_cast<size_t>(__builtin_popcount(Ops::eq_mask(Ops::load(data + i),   \
+                                                                         needle)));             \
+        }                                                                                       \
+        return total + count_scalar(data + i, n - i, value);                                    \
+    }                                                                                           \
+    }
+
+BV_SIMD_DEFINE_LOOPS(sse2, )
+BV_SIMD_DEFINE_LOOPS(avx2, BV_AVX2_TARGET)
+#undef BV_SIMD_DEFINE_LOOPS
+
+template <typename T>
+struct VectorOps {};
+template <>
+struct VectorOps<int32_t> {
+    using sse2 = Sse2Int32;
+    using avx2 = Avx2Int32;
+};
+template <>
+struct VectorOps<float> {
+    using sse2 = Sse2Float;
+    using avx2 = Avx2Float;
+};
+template <>
+struct VectorOps<double> {
+    using sse2 = Sse2Double;
+    using avx2 = Avx2Double;
+};
+
+template <typename T>
+struct has_vector_ops : std::false_type {};
+template <>
+struct has_vector_ops<int32_t> : std::true_type {};
+template <>
+struct has_vector_ops<float> : std::true_type {};
+template <>
+struct has_vector_ops<double> : std::true_type {};
+#else
+template <typename T>
+struct has_vector_ops : std::false_type {};
+#endif
+
+// Kernel table for one element type, resolved once per call.
+template <typename T, bool Vectorized = has_vector_ops<T>::value>
+struct Kernels {
+    static sum_type<T> sum(Isa, const T* data, size_t n) { return sum_scalar(data, n); }
+    static T min(Isa, const T* data, size_t n, T acc) { return extreme_scalar<T, true>(data, n, acc); }
+    static T max(Isa, const T* data, size_t n, T acc) { return extreme_scalar<T, false>(data, n, acc); }
+    static size_t find(Isa, const T* data, size_t n, T value) { return find_scalar(data, n, value); }
+    static size_t count(Isa, const T* data, size_t n, T value) { return count_scalar(data, n, value); }
+};
+
+#if BV_SIMD_X86
+template <typename T>
+struct Kernels<T, true> {
+    using Sse2 = typename VectorOps<T>::sse2;
+    using Avx2 = typename VectorOps<T>::avx2;
+
+    static sum_type<T> sum(Isa isa, const T* data, size_t n) {
+        switch (isa) {
+        case Isa::avx2: return avx2::sum<Avx2>(data, n);
+        case Isa::sse2: return sse2::sum<Sse2>(data, n);
+        default: return sum_scalar(data, n);
+        }
+    }
+    static T min(Isa isa, const T* data, size_t n, T acc) {
+        switch (isa) {
+        case Isa::avx2: return avx2::extreme<Avx2, true>(data, n, acc);
+        case Isa::sse2: return sse2::extreme<Sse2, true>(data, n, acc);
+        default: return extreme_scalar<T, true>(data, n, acc);
+        }
+    }
+    static T max(Isa isa, const T* data, size_t n, T acc) {
+        switch (isa) {
+        case Isa::avx2: return avx2::extreme<Avx2, false>(data, n, acc);
+        case Isa::sse2: return sse2::extreme<Sse2, false>(data, n, acc);
+        default: return extreme_scalar<T, false>(data, n, acc);
+        }
+    }
+    static size_t find(Isa isa, const T* data, size_t n, T value) {
+        switch (isa) {
+        case Isa::avx2: return avx2::find<Avx2>(data, n, value);
+        case Isa::sse2: return sse2::find<Sse2>(data, n, value);
+        default: return find_scalar(data, n, value);
+        }
+    }
+    static size_t count(Isa isa, const T* data, size_t n, T value) {
+        switch (isa) {
+        case Isa::avx2: return avx2::count<Avx2>(data, n, value);
+        case Isa::sse2: return sse2::count<Sse2>(data, n, value);
+        default: return count_scalar(data, n, value);
+        }
+    }
+};
+#endif
+} // namespace detail
+
+// Best instruction set supported by this CPU, capped by set_max_isa().
+inline Isa active_isa() {
+    static const Isa detected = detail::detect_isa();
+    int limit = detail::isa_limit().load(std::memory_order_relaxed);
+    return static_cast<int>(detected) < limit ? detected : static_cast<Isa>(limit);
+}
+
+// Caps the instruction set used by the kernels, e.g. to compare the scalar,
+// SSE2 and AVX2 paths on the same machine.
+inline void set_max_isa(Isa isa) {
+    detail::isa_limit().store(static_cast<int>(isa), std::memory_order_relaxed);
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+sum_type<T> sum(const BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec) {
+    static_assert(std::is_arithmetic<T>::value, "bv::simd::sum requires an arithmetic element type");
+    Isa isa = active_isa();
+    sum_type<T> total = 0;
+    vec.for_each_segment([&](BlockSpan<const T> seg) {
+        total += detail::Kernels<T>::sum(isa, seg.data(), seg.size());
+    });
+    return total;
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+T min(const BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec) {
+    static_assert(std::is_arithmetic<T>::value, "bv::simd::min requires an arithmetic element type");
+    if (vec.empty()) {
+        throw std::out_of_range("bv::simd::min: empty container");
+    }
+    Isa isa = active_isa();
+    T best = vec.front();
+    vec.for_each_segment([&](BlockSpan<const T> seg) {
+        best = detail::Kernels<T>::min(isa, seg.data(), seg.size(), best);
+    });
+    return best;
+}
+
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+T max(const BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec) {
+    static_assert(std::is_arithmetic<T>::value, "bv::simd::max requires an arithmetic element type");
+    if (vec.empty()) {
+        throw std::out_of_range("bv::simd::max: empty container");
+    }
+    Isa isa = active_isa();
+    T best = vec.front();
+    vec.for_each_segment([&](BlockSpan<const T> seg) {
+        best = detail::Kernels<T>::max(isa, seg.data(), seg.size(), best);
+    });
+    return best;
+}
+
+// Index of the first element equal to `value`, or vec.size() if there is none.
+// `value` is not deduced, so find(doubles, 1) converts 1 to double.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+size_t find(const BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec,
+            typename BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::value_type value) {
+    static_assert(std::is_arithmetic<T>::value, "bv::simd::find requires an arithmetic element type");
+    Isa isa = active_isa();
+    size_t first = 0;
+    for (size_t b = 0; b < vec.segment_count(); ++b) {
+        vec.prefetch_ahead(b);
+        BlockSpan<const T> seg = vec.get_segment(b);
+        size_t hit = detail::Kernels<T>::find(isa, seg.data(), seg.size(), value);
+        if (hit != seg.size()) {
+            return first + hit;
+        }
+        first += seg.size();
+    }
+    return vec.size();
+}
+
+// Number of elements equal to `value`.
+template <typename T, typename Allocator, size_t BlockShift, typename Stats, typename Prefetch>
+size_t count(const BlockVector<T, Allocator, BlockShift, Stats, Prefetch>& vec,
+             typename BlockVector<T, Allocator, BlockShift, Stats, Prefetch>::value_type value) {
+    static_assert(std::is_arithmetic<T>::value, "bv::simd::count requires an arithmetic element type");
+    Isa isa = active_isa();
+    size_t total = 0;
+    vec.for_each_segment([&](BlockSpan<const T> seg) {
+        total += detail::Kernels<T>::count(isa, seg.data(), seg.size(), value);
+    });
+    return total;
+}
+
+} // namespace simd
+} // namespace bv
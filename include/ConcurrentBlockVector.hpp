@@ -0,0 +1,272 @@
+#pragma once
+#include "BlockVector.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+// Append-only BlockVector for many concurrent writers and lock-free readers.
+//
+// Writers claim a slot with a single fetch_add on the claim counter and build
+// the element in place. Block k holds (1 << BaseShift) << k elements, so the
+// block directory is a fixed array inside the object that never moves; a
+// missing block is allocated by whichever writer needs it first and installed
+// with a compare-and-swap (the losers free their copy).
+//
+// Every slot carries a ready flag. After constructing its element a writer
+// sets the flag and then helps advance the published size over every ready
+// slot, so size() is always a prefix of fully constructed elements and no
+// writer ever waits for another one. Readers may access any index below
+// size() without synchronisation.
+//
+// Elements are never moved or destroyed before the container itself. If a
+// block allocation or a T constructor throws, the claimed slot could never be
+// published, so emplace_back is noexcept and such a failure terminates.
+template <typename T, typename Allocator = std::allocator<T>, size_t BaseShift = 8>
+class ConcurrentBlockVector {
+private:
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using ready_flag = std::atomic<unsigned char>;
+    static_assert(std::is_same<typename alloc_traits::pointer, T*>::value,
+                  "ConcurrentBlockVector: Allocator must hand out raw pointers");
+
+    static constexpr size_t kBaseSize = static_cast<size_t>(1) << BaseShift;
+    static constexpr size_t kMaxBlocks = sizeof(size_t) * 8 - BaseShift;
+
+    std::atomic<T*> blocks_[kMaxBlocks];
+    std::atomic<size_t> claimed_;
+    std::atomic<size_t> published_;
+    Allocator alloc_;
+
+    static size_t block_length(size_t block_idx);
+    static size_t block_allocation(size_t block_idx);
+    static ready_flag* ready_flags(T* block, size_t block_idx);
+    T* ensure_block(size_t block_idx);
+    bool slot_ready(size_t index) const;
+    void publish(size_t index);
+public:
+    using value_type      = T;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = T&;
+    using const_reference = const T&;
+    using pointer         = T*;
+    using const_pointer   = const T*;
+    using allocator_type  = Allocator;
+
+    ConcurrentBlockVector();
+    explicit ConcurrentBlockVector(const Allocator& alloc);
+    ConcurrentBlockVector(const ConcurrentBlockVector&) = delete;
+    ConcurrentBlockVector& operator=(const ConcurrentBlockVector&) = delete;
+    ~ConcurrentBlockVector();
+
+    // Element access; `index` must be below a value previously returned by size().
+    T& operator[](size_t index);
+    const T& operator[](size_t index) const;
+    T& at(size_t index);
+    const T& at(size_t index) const;
+
+    // Capacity related
+    size_t size() const;
+    bool empty() const;
+    size_t capacity() const;
+    void reserve(size_t newCapacity);
+
+    // manipulation (thread-safe)
+    void push_back(const T& value) noexcept;
+    void push_back(T&& value) noexcept;
+    template <typename... Args>
+    T& emplace_back(Args&&... args) noexcept;
+
+    allocator_type get_allocator() const;
+};
+
+// ConcurrentBlockVector Definitions
+
+template <typename T, typename Allocator, size_t BaseShift>
+ConcurrentBlockVector<T, Allocator, BaseShift>::ConcurrentBlockVector()
+    : ConcurrentBlockVector(Allocator()) {
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+ConcurrentBlockVector<T, Allocator, BaseShift>::ConcurrentBlockVector(const Allocator& alloc)
+    : claimed_(0), published_(0), alloc_(alloc) {
+    for (size_t i = 0; i < kMaxBlocks; ++i) {
+        blocks_[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+// Destruction must not race with writers or readers.
+template <typename T, typename Allocator, size_t BaseShift>
+ConcurrentBlockVector<T, Allocator, BaseShift>::~ConcurrentBlockVector() {
+    size_t remaining = published_.load(std::memory_order_acquire);
+    for (size_t k = 0; k < kMaxBlocks; ++k) {
+        T* block = blocks_[k].load(std::memory_order_acquire);
+        if (block == nullptr) {
+            continue;
+        }
+        size_t used = remaining < block_length(k) ? remaining : block_length(k);
+        for (size_t i = 0; i < used; ++i) {
+            alloc_traits::destroy(alloc_, block + i);
+        }
+        remaining -= used;
+        alloc_traits::deallocate(alloc_, block, block_allocation(k));
+    }
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+T& ConcurrentBlockVector<T, Allocator, BaseShift>::operator[](size_t index) {
+    bv::detail::GeometricSlot slot = bv::detail::geometric_locate(index, BaseShift);
+    return blocks_[slot.block].load(std::memory_order_acquire)[slot.offset];
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+const T& ConcurrentBlockVector<T, Allocator, BaseShift>::operator[](size_t index) const {
+    bv::detail::GeometricSlot slot = bv::detail::geometric_locate(index, BaseShift);
+    return blocks_[slot.block].load(std::memory_order_acquire)[slot.offset];
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+T& ConcurrentBlockVector<T, Allocator, BaseShift>::at(size_t index) {
+    if (index >= size()) {
+        throw std::out_of_range("ConcurrentBlockVector::at");
+    }
+    return (*this)[index];
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+const T& ConcurrentBlockVector<T, Allocator, BaseShift>::at(size_t index) const {
+    if (index >= size()) {
+        throw std::out_of_range("ConcurrentBlockVector::at");
+    }
+    return (*this)[index];
+}
+
+// Number of published elements: every index below it is fully constructed.
+template <typename T, typename Allocator, size_t BaseShift>
+size_t ConcurrentBlockVector<T, Allocator, BaseShift>::size() const {
+    return published_.load(std::memory_order_acquire);
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+bool ConcurrentBlockVector<T, Allocator, BaseShift>::empty() const {
+    return size() == 0;
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+size_t ConcurrentBlockVector<T, Allocator, BaseShift>::capacity() const {
+    size_t total = 0;
+    for (size_t k = 0; k < kMaxBlocks; ++k) {
+        if (blocks_[k].load(std::memory_order_acquire) != nullptr) {
+            total += block_length(k);
+        }
+    }
+    return total;
+}
+
+// Pre-allocates the blocks covering the first `newCapacity` slots so writers
+// do not hit the allocator on the hot path. Safe to call concurrently.
+template <typename T, typename Allocator, size_t BaseShift>
+void ConcurrentBlockVector<T, Allocator, BaseShift>::reserve(size_t newCapacity) {
+    if (newCapacity == 0) {
+        return;
+    }
+    size_t last_block = bv::detail::geometric_locate(newCapacity - 1, BaseShift).block;
+    for (size_t k = 0; k <= last_block; ++k) {
+        ensure_block(k);
+    }
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+void ConcurrentBlockVector<T, Allocator, BaseShift>::push_back(const T& value) noexcept {
+    emplace_back(value);
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+void ConcurrentBlockVector<T, Allocator, BaseShift>::push_back(T&& value) noexcept {
+    emplace_back(std::move(value));
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+template <typename... Args>
+T& ConcurrentBlockVector<T, Allocator, BaseShift>::emplace_back(Args&&... args) noexcept {
+    size_t index = claimed_.fetch_add(1, std::memory_order_relaxed);
+    bv::detail::GeometricSlot slot = bv::detail::geometric_locate(index, BaseShift);
+    T* block = ensure_block(slot.block);
+    T* element = block + slot.offset;
+    alloc_traits::construct(alloc_, element, std::forward<Args>(args)...);
+    publish(index);
+    return *element;
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+typename ConcurrentBlockVector<T, Allocator, BaseShift>::allocator_type
+ConcurrentBlockVector<T, Allocator, BaseShift>::get_allocator() const {
+    return alloc_;
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+size_t ConcurrentBlockVector<T, Allocator, BaseShift>::block_length(size_t block_idx) {
+    return kBaseSize << block_idx;
+}
+
+// Each block is followed by one ready flag per slot; the flags live in the
+// same allocation, padded up to a whole number of T.
+template <typename T, typename Allocator, size_t BaseShift>
+size_t ConcurrentBlockVector<T, Allocator, BaseShift>::block_allocation(size_t block_idx) {
+    size_t length = block_length(block_idx);
+    return length + (length * sizeof(ready_flag) + sizeof(T) - 1) / sizeof(T);
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+typename ConcurrentBlockVector<T, Allocator, BaseShift>::ready_flag*
+ConcurrentBlockVector<T, Allocator, BaseShift>::ready_flags(T* block, size_t block_idx) {
+    return reinterpret_cast<ready_flag*>(block + block_length(block_idx));
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+T* ConcurrentBlockVector<T, Allocator, BaseShift>::ensure_block(size_t block_idx) {
+    T* block = blocks_[block_idx].load(std::memory_order_acquire);
+    if (block != nullptr) {
+        return block;
+    }
+
+    T* fresh = alloc_traits::allocate(alloc_, block_allocation(block_idx));
+    ready_flag* flags = ready_flags(fresh, block_idx);
+    for (size_t i = 0; i < block_length(block_idx); ++i) {
+        ::new (static_cast<void*>(flags + i)) ready_flag(0);
+    }
+    if (blocks_[block_idx].compare_exchange_strong(block, fresh, std::memory_order_acq_rel,
+                                                   std::memory_order_acquire)) {
+        return fresh;
+    }
+    alloc_traits::deallocate(alloc_, fresh, block_allocation(block_idx));
+    return block;
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+bool ConcurrentBlockVector<T, Allocator, BaseShift>::slot_ready(size_t index) const {
+    bv::detail::GeometricSlot slot = bv::detail::geometric_locate(index, BaseShift);
+    T* block = blocks_[slot.block].load(std::memory_order_acquire);
+    return block != nullptr && ready_flags(block, slot.block)[slot.offset].load() != 0;
+}
+
+// The flag store and the loads of published_ are sequentially consistent:
+// either this writer sees its predecessor's flag, or the predecessor sees
+// ours when it advances past its own slot, so no ready slot is left behind.
+template <typename T, typename Allocator, size_t BaseShift>
+void ConcurrentBlockVector<T, Allocator, BaseShift>::publish(size_t index) {
+    bv::detail::GeometricSlot slot = bv::detail::geometric_locate(index, BaseShift);
+    ready_flags(blocks_[slot.block].load(std::memory_order_relaxed), slot.block)[slot.offset].store(1);
+
+    size_t published = published_.load();
+    while (slot_ready(published)) {
+        if (published_.compare_exchange_weak(published, published + 1)) {
+            ++published;
+        }
+    }
+}
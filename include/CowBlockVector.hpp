@@ -0,0 +1,621 @@
+#pragma once
+#include "BlockVector.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Copy-on-write block container for cheap snapshots. Blocks carry a reference
+// count and copying the container shares them: a snapshot costs O(number of
+// blocks), and a block is cloned only when a copy that shares it is written
+// to. Memory therefore grows with the blocks that are actually modified.
+//
+// Reads through a const container (or cbegin/cend, or std::as_const) never
+// clone. Non-const operator[], at, front, back, iterators and
+// for_each_segment hand out writable storage, so they clone a shared block
+// first. Appends that open a fresh block never copy; appending into a tail
+// block that is still shared clones it once.
+//
+// Reference counts are atomic, so snapshots may be handed to other threads
+// and read, modified or destroyed there independently of the original. As
+// with any copy-on-write type, taking a snapshot invalidates the references
+// and non-const iterators previously obtained from the source.
+template <typename T, typename Allocator = std::allocator<T>, size_t BlockShift = 8>
+class CowBlockVector;
+
+template <typename T, typename Allocator, size_t BlockShift>
+class CowBlockVector {
+private:
+    using alloc_traits = std::allocator_traits<Allocator>;
+    static_assert(std::is_same<typename alloc_traits::value_type, T>::value,
+                  "CowBlockVector: Allocator::value_type must be T");
+    static_assert(BlockShift < sizeof(size_t) * 8, "BlockShift out of range");
+
+    static constexpr size_t kBlockShift = BlockShift;
+    static constexpr size_t kBlockSize = static_cast<size_t>(1) << BlockShift;
+    static constexpr size_t kBlockMask = kBlockSize - 1;
+
+    // Each block is one allocation: this header followed by kBlockSize
+    // elements. The header is padded to T's alignment so the elements start
+    // right after it.
+    struct alignas(alignof(T) > alignof(std::atomic<size_t>) ? alignof(T) : alignof(std::atomic<size_t>))
+    BlockHeader {
+        std::atomic<size_t> refs;
+    };
+    using header_allocator = typename alloc_traits::template rebind_alloc<BlockHeader>;
+    using header_traits = std::allocator_traits<header_allocator>;
+    using table_allocator = typename alloc_traits::template rebind_alloc<BlockHeader*>;
+
+    static constexpr size_t kBlockUnits = 1 + (kBlockSize * sizeof(T) + sizeof(BlockHeader) - 1) / sizeof(BlockHeader);
+
+    // blocks_ holds the blocks with elements followed by spare empty ones,
+    // which are never shared. Every owner of a shared block sees the same
+    // elements in it, because writers clone before touching it.
+    std::vector<BlockHeader*, table_allocator> blocks_;
+    size_t size_;
+    Allocator alloc_;
+
+    static T* block_data(BlockHeader* block) { return reinterpret_cast<T*>(block + 1); }
+    static const T* block_data(const BlockHeader* block) { return reinterpret_cast<const T*>(block + 1); }
+    size_t block_used(size_t block_idx) const;
+    size_t used_blocks() const;
+    bool shared(size_t block_idx) const;
+    BlockHeader* allocate_block();
+    void release_block(BlockHeader* block, size_t used);
+    T* writable_block(size_t block_idx);
+    bv::detail::StorageRun<T*> iterator_run(size_t index);
+    bv::detail::StorageRun<const T*> iterator_run(size_t index) const;
+    void clone_block(size_t block_idx);
+    void truncate(size_t n);
+    void release_storage();
+    void share_from(const CowBlockVector& other);
+    void copy_elements_from(const CowBlockVector& other);
+    void steal_from(CowBlockVector& other) noexcept;
+public:
+    using allocator_type  = Allocator;
+    using value_type      = T;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = T&;
+    using const_reference = const T&;
+    using pointer         = T*;
+    using const_pointer   = const T*;
+
+    // Iterators cache a pointer into the current block, resolved on first
+    // dereference. A non-const iterator makes each block it enters writable,
+    // so iterating a snapshot without writing should use const iterators.
+    using iterator = bv::IndexIterator<CowBlockVector, false, bv::detail::RunAccess>;
+    using const_iterator = bv::IndexIterator<CowBlockVector, true, bv::detail::RunAccess>;
+    using const_segment = bv::BlockSpan<const T>;
+    using segment = bv::BlockSpan<T>;
+
+    friend class bv::detail::RunAccess<CowBlockVector, false>;
+    friend class bv::detail::RunAccess<CowBlockVector, true>;
+    friend struct bv::detail::BlockOwnership;
+
+    CowBlockVector();
+    explicit CowBlockVector(const Allocator& alloc);
+    CowBlockVector(size_t n, const T& value, const Allocator& alloc = Allocator());
+    CowBlockVector(std::initializer_list<T> init, const Allocator& alloc = Allocator());
+    CowBlockVector(const CowBlockVector& other);
+    CowBlockVector(CowBlockVector&& other) noexcept;
+    CowBlockVector& operator=(const CowBlockVector& other);
+    CowBlockVector& operator=(CowBlockVector&& other) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value ||
+        alloc_traits::is_always_equal::value);
+    ~CowBlockVector();
+
+    allocator_type get_allocator() const;
+    void swap(CowBlockVector& other) noexcept;
+
+    // Snapshot sharing every block with this container; same as copying.
+    CowBlockVector snapshot() const;
+    // Blocks holding elements whose storage is shared with another copy.
+    size_t shared_block_count() const;
+
+    // Element access; the non-const overloads clone a shared block first.
+    T& operator[](size_t index);
+    const T& operator[](size_t index) const;
+    T& at(size_t index);
+    const T& at(size_t index) const;
+    T& front();
+    const T& front() const;
+    T& back();
+    const T& back() const;
+
+    // Capacity related
+    size_t size() const;
+    size_t capacity() const;
+    bool empty() const;
+    void reserve(size_t newCapacity);
+    static constexpr size_t block_size() { return kBlockSize; }
+
+    // manipulation
+    void push_back(const T& value);
+    void push_back(T&& value);
+    template <typename... Args>
+    T& emplace_back(Args&&... args);
+    void pop_back();
+    void clear();
+    void resize(size_t n);
+
+    // Segments
+    size_t segment_count() const;
+    const_segment get_segment(size_t block_idx) const;
+    template <typename Func>
+    void for_each_segment(Func&& fn);
+    template <typename Func>
+    void for_each_segment(Func&& fn) const;
+
+    // iterators
+    iterator begin();
+    const_iterator begin() const;
+    const_iterator cbegin() const;
+    iterator end();
+    const_iterator end() const;
+    const_iterator cend() const;
+};
+
+// CowBlockVector Definitions
+
+template <typename T, typename Allocator, size_t BlockShift>
+CowBlockVector<T, Allocator, BlockShift>::CowBlockVector()
+    : CowBlockVector(Allocator()) {
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+CowBlockVector<T, Allocator, BlockShift>::CowBlockVector(const Allocator& alloc)
+    : blocks_(table_allocator(alloc)), size_(0), alloc_(alloc) {
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+CowBlockVector<T, Allocator, BlockShift>::CowBlockVector(size_t n, const T& value, const Allocator& alloc)
+    : CowBlockVector(alloc) {
+    reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        emplace_back(value);
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+CowBlockVector<T, Allocator, BlockShift>::CowBlockVector(std::initializer_list<T> init, const Allocator& alloc)
+    : CowBlockVector(alloc) {
+    reserve(init.size());
+    for (const T& value : init) {
+        emplace_back(value);
+    }
+}
+
+// Shares other's blocks when the allocators are interchangeable; otherwise
+// the blocks could not be freed by whichever copy drops them last, so the
+// elements are copied.
+template <typename T, typename Allocator, size_t BlockShift>
+CowBlockVector<T, Allocator, BlockShift>::CowBlockVector(const CowBlockVector& other)
+    : CowBlockVector(alloc_traits::select_on_container_copy_construction(other.alloc_)) {
+    if (alloc_ == other.alloc_) {
+        share_from(other);
+    } else {
+        copy_elements_from(other);
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+CowBlockVector<T, Allocator, BlockShift>::CowBlockVector(CowBlockVector&& other) noexcept
+    : CowBlockVector(std::move(other.alloc_)) {
+    steal_from(other);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+CowBlockVector<T, Allocator, BlockShift>& CowBlockVector<T, Allocator, BlockShift>::operator=(const CowBlockVector& other) {
+    if (this == &other) {
+        return *this;
+    }
+    release_storage();
+    bv::detail::BlockOwnership::copy_allocator(*this, other);
+    if (alloc_ == other.alloc_) {
+        share_from(other);
+    } else {
+        copy_elements_from(other);
+    }
+    return *this;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+CowBlockVector<T, Allocator, BlockShift>& CowBlockVector<T, Allocator, BlockShift>::operator=(CowBlockVector&& other) noexcept(
+    alloc_traits::propagate_on_container_move_assignment::value ||
+    alloc_traits::is_always_equal::value) {
+    if (this == &other) {
+        return *this;
+    }
+    if (bv::detail::BlockOwnership::move_storage(*this, other)) {
+        return *this;
+    }
+    release_storage();
+    reserve(other.size_);
+    for (size_t i = 0; i < other.size_; ++i) {
+        emplace_back(std::move(other[i]));
+    }
+    other.clear();
+    return *this;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+CowBlockVector<T, Allocator, BlockShift>::~CowBlockVector() {
+    release_storage();
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename CowBlockVector<T, Allocator, BlockShift>::allocator_type CowBlockVector<T, Allocator, BlockShift>::get_allocator() const {
+    return alloc_;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void CowBlockVector<T, Allocator, BlockShift>::swap(CowBlockVector& other) noexcept {
+    using std::swap;
+    blocks_.swap(other.blocks_);
+    swap(size_, other.size_);
+    bv::detail::BlockOwnership::swap_allocators(*this, other);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void swap(CowBlockVector<T, Allocator, BlockShift>& a, CowBlockVector<T, Allocator, BlockShift>& b) noexcept {
+    a.swap(b);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+CowBlockVector<T, Allocator, BlockShift> CowBlockVector<T, Allocator, BlockShift>::snapshot() const {
+    return CowBlockVector(*this);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+size_t CowBlockVector<T, Allocator, BlockShift>::shared_block_count() const {
+    size_t count = 0;
+    size_t used = used_blocks();
+    for (size_t b = 0; b < used; ++b) {
+        if (shared(b)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+T& CowBlockVector<T, Allocator, BlockShift>::operator[](size_t index) {
+    return writable_block(index >> BlockShift)[index & kBlockMask];
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+const T& CowBlockVector<T, Allocator, BlockShift>::operator[](size_t index) const {
+    return block_data(blocks_[index >> BlockShift])[index & kBlockMask];
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+T& CowBlockVector<T, Allocator, BlockShift>::at(size_t index) {
+    if (index >= size_) {
+        throw std::out_of_range("CowBlockVector::at");
+    }
+    return (*this)[index];
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+const T& CowBlockVector<T, Allocator, BlockShift>::at(size_t index) const {
+    if (index >= size_) {
+        throw std::out_of_range("CowBlockVector::at");
+    }
+    return (*this)[index];
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+T& CowBlockVector<T, Allocator, BlockShift>::front() {
+    return (*this)[0];
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+const T& CowBlockVector<T, Allocator, BlockShift>::front() const {
+    return (*this)[0];
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+T& CowBlockVector<T, Allocator, BlockShift>::back() {
+    return (*this)[size_ - 1];
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+const T& CowBlockVector<T, Allocator, BlockShift>::back() const {
+    return (*this)[size_ - 1];
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+size_t CowBlockVector<T, Allocator, BlockShift>::size() const {
+    return size_;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+size_t CowBlockVector<T, Allocator, BlockShift>::capacity() const {
+    return blocks_.size() << BlockShift;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+bool CowBlockVector<T, Allocator, BlockShift>::empty() const {
+    return size_ == 0;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void CowBlockVector<T, Allocator, BlockShift>::reserve(size_t newCapacity) {
+    size_t blocks = (newCapacity + kBlockMask) >> BlockShift;
+    if (blocks <= blocks_.size()) {
+        return;
+    }
+    // Reserved up front, so push_back below cannot throw and leak a block.
+    blocks_.reserve(blocks);
+    while (blocks_.size() < blocks) {
+        blocks_.push_back(allocate_block());
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void CowBlockVector<T, Allocator, BlockShift>::push_back(const T& value) {
+    emplace_back(value);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void CowBlockVector<T, Allocator, BlockShift>::push_back(T&& value) {
+    emplace_back(std::move(value));
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+template <typename... Args>
+T& CowBlockVector<T, Allocator, BlockShift>::emplace_back(Args&&... args) {
+    if (size_ == capacity()) {
+        // Grow the table before allocating, so a throwing reallocation
+        // cannot leak the new block.
+        if (blocks_.size() == blocks_.capacity()) {
+            blocks_.reserve(blocks_.empty() ? 1 : blocks_.size() * 2);
+        }
+        blocks_.push_back(allocate_block());
+    }
+    T* element = writable_block(size_ >> BlockShift) + (size_ & kBlockMask);
+    alloc_traits::construct(alloc_, element, std::forward<Args>(args)...);
+    ++size_;
+    return *element;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void CowBlockVector<T, Allocator, BlockShift>::pop_back() {
+    if (size_ != 0) {
+        truncate(size_ - 1);
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void CowBlockVector<T, Allocator, BlockShift>::clear() {
+    truncate(0);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void CowBlockVector<T, Allocator, BlockShift>::resize(size_t n) {
+    if (n < size_) {
+        truncate(n);
+        return;
+    }
+    reserve(n);
+    while (size_ < n) {
+        emplace_back();
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+size_t CowBlockVector<T, Allocator, BlockShift>::segment_count() const {
+    return used_blocks();
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename CowBlockVector<T, Allocator, BlockShift>::const_segment
+CowBlockVector<T, Allocator, BlockShift>::get_segment(size_t block_idx) const {
+    return const_segment{block_data(blocks_[block_idx]), block_used(block_idx)};
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+template <typename Func>
+void CowBlockVector<T, Allocator, BlockShift>::for_each_segment(Func&& fn) {
+    size_t count = used_blocks();
+    for (size_t b = 0; b < count; ++b) {
+        fn(segment{writable_block(b), block_used(b)});
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+template <typename Func>
+void CowBlockVector<T, Allocator, BlockShift>::for_each_segment(Func&& fn) const {
+    size_t count = used_blocks();
+    for (size_t b = 0; b < count; ++b) {
+        fn(get_segment(b));
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename CowBlockVector<T, Allocator, BlockShift>::iterator CowBlockVector<T, Allocator, BlockShift>::begin() {
+    return iterator(0, this);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename CowBlockVector<T, Allocator, BlockShift>::const_iterator CowBlockVector<T, Allocator, BlockShift>::begin() const {
+    return const_iterator(0, this);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename CowBlockVector<T, Allocator, BlockShift>::const_iterator CowBlockVector<T, Allocator, BlockShift>::cbegin() const {
+    return begin();
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename CowBlockVector<T, Allocator, BlockShift>::iterator CowBlockVector<T, Allocator, BlockShift>::end() {
+    return iterator(size_, this);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename CowBlockVector<T, Allocator, BlockShift>::const_iterator CowBlockVector<T, Allocator, BlockShift>::end() const {
+    return const_iterator(size_, this);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename CowBlockVector<T, Allocator, BlockShift>::const_iterator CowBlockVector<T, Allocator, BlockShift>::cend() const {
+    return end();
+}
+
+// Number of elements in block `block_idx`.
+template <typename T, typename Allocator, size_t BlockShift>
+size_t CowBlockVector<T, Allocator, BlockShift>::block_used(size_t block_idx) const {
+    size_t first = block_idx << BlockShift;
+    if (first >= size_) {
+        return 0;
+    }
+    size_t remaining = size_ - first;
+    return remaining < kBlockSize ? remaining : kBlockSize;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+size_t CowBlockVector<T, Allocator, BlockShift>::used_blocks() const {
+    return (size_ + kBlockMask) >> BlockShift;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+bool CowBlockVector<T, Allocator, BlockShift>::shared(size_t block_idx) const {
+    return blocks_[block_idx]->refs.load(std::memory_order_acquire) != 1;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename CowBlockVector<T, Allocator, BlockShift>::BlockHeader* CowBlockVector<T, Allocator, BlockShift>::allocate_block() {
+    header_allocator header_alloc(alloc_);
+    BlockHeader* block = header_traits::allocate(header_alloc, kBlockUnits);
+    ::new (static_cast<void*>(block)) BlockHeader{{1}};
+    return block;
+}
+
+// Drops one reference; the last owner destroys the `used` elements, which
+// are the same in every owner's view.
+template <typename T, typename Allocator, size_t BlockShift>
+void CowBlockVector<T, Allocator, BlockShift>::release_block(BlockHeader* block, size_t used) {
+    if (block->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    T* data = block_data(block);
+    if (!std::is_trivially_destructible<T>::value) {
+        for (size_t i = 0; i < used; ++i) {
+            alloc_traits::destroy(alloc_, data + i);
+        }
+    }
+    block->~BlockHeader();
+    header_allocator header_alloc(alloc_);
+    header_traits::deallocate(header_alloc, block, kBlockUnits);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+T* CowBlockVector<T, Allocator, BlockShift>::writable_block(size_t block_idx) {
+    if (shared(block_idx)) {
+        clone_block(block_idx);
+    }
+    return block_data(blocks_[block_idx]);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+bv::detail::StorageRun<T*> CowBlockVector<T, Allocator, BlockShift>::iterator_run(size_t index) {
+    T* block = writable_block(index >> kBlockShift);
+    return {block, block + (index & kBlockMask), block + kBlockSize};
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+bv::detail::StorageRun<const T*> CowBlockVector<T, Allocator, BlockShift>::iterator_run(size_t index) const {
+    const T* block = block_data(blocks_[index >> kBlockShift]);
+    return {block, block + (index & kBlockMask), block + kBlockSize};
+}
+
+// Replaces a shared block with a private copy. If a copy constructor throws,
+// the container is unchanged.
+template <typename T, typename Allocator, size_t BlockShift>
+void CowBlockVector<T, Allocator, BlockShift>::clone_block(size_t block_idx) {
+    size_t used = block_used(block_idx);
+    BlockHeader* copy = allocate_block();
+    const T* src = block_data(blocks_[block_idx]);
+    T* dst = block_data(copy);
+    size_t built = 0;
+    try {
+        for (; built < used; ++built) {
+            alloc_traits::construct(alloc_, dst + built, src[built]);
+        }
+    } catch (...) {
+        release_block(copy, built);
+        throw;
+    }
+    release_block(blocks_[block_idx], used);
+    blocks_[block_idx] = copy;
+}
+
+// Shrinks to n elements. Dropped blocks that are still shared are released
+// without touching their elements; private ones stay as spare capacity.
+template <typename T, typename Allocator, size_t BlockShift>
+void CowBlockVector<T, Allocator, BlockShift>::truncate(size_t n) {
+    size_t keep = (n + kBlockMask) >> BlockShift;
+    for (size_t b = used_blocks(); b-- > keep;) {
+        if (shared(b)) {
+            release_block(blocks_[b], block_used(b));
+            blocks_.erase(blocks_.begin() + static_cast<std::ptrdiff_t>(b));
+        } else if (!std::is_trivially_destructible<T>::value) {
+            T* data = block_data(blocks_[b]);
+            for (size_t i = 0, used = block_used(b); i < used; ++i) {
+                alloc_traits::destroy(alloc_, data + i);
+            }
+        }
+    }
+    if (keep != 0 && n < size_ && (keep << BlockShift) > n) {
+        size_t last = keep - 1;
+        size_t end = std::min(size_, keep << BlockShift);
+        T* data = writable_block(last);
+        for (size_t i = n; i < end; ++i) {
+            alloc_traits::destroy(alloc_, data + (i & kBlockMask));
+        }
+    }
+    size_ = n;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void CowBlockVector<T, Allocator, BlockShift>::release_storage() {
+    for (size_t b = 0; b < blocks_.size(); ++b) {
+        release_block(blocks_[b], block_used(b));
+    }
+    blocks_.clear();
+    size_ = 0;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void CowBlockVector<T, Allocator, BlockShift>::share_from(const CowBlockVector& other) {
+    size_t used = other.used_blocks();
+    blocks_.reserve(used);
+    for (size_t b = 0; b < used; ++b) {
+        other.blocks_[b]->refs.fetch_add(1, std::memory_order_relaxed);
+        blocks_.push_back(other.blocks_[b]);
+    }
+    size_ = other.size_;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void CowBlockVector<T, Allocator, BlockShift>::copy_elements_from(const CowBlockVector& other) {
+    reserve(other.size_);
+    for (size_t i = 0; i < other.size_; ++i) {
+        emplace_back(other[i]);
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void CowBlockVector<T, Allocator, BlockShift>::steal_from(CowBlockVector& other) noexcept {
+    blocks_.swap(other.blocks_);
+    size_ = other.size_;
+    other.size_ = 0;
+}
@@ -0,0 +1,552 @@
+#pragma once
+#include "BlockVector.hpp"
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// BlockVector variant for very large containers whose blocks grow
+// geometrically: block k holds (1 << BaseShift) << k elements. Locating an
+// element is a count-leading-zeros and a mask (bv::detail::geometric_locate),
+// so random access stays O(1), while a billion elements need about 22 blocks
+// instead of millions. The block table is a fixed array inside the object, so
+// it is never reallocated, and elements never move once constructed.
+//
+// The trade-off is granularity: the last block can be as large as everything
+// before it, so up to half of capacity() may be unused.
+template <typename T, typename Allocator = std::allocator<T>, size_t BaseShift = 8>
+class GeometricBlockVector;
+
+template <typename T, typename Allocator, size_t BaseShift>
+class GeometricBlockVector {
+private:
+    using alloc_traits = std::allocator_traits<Allocator>;
+    static_assert(std::is_same<typename alloc_traits::value_type, T>::value,
+                  "GeometricBlockVector: Allocator::value_type must be T");
+    static_assert(std::is_same<typename alloc_traits::pointer, T*>::value,
+                  "GeometricBlockVector: Allocator must hand out raw pointers");
+    static_assert(BaseShift < sizeof(size_t) * 8, "BaseShift out of range");
+
+    static constexpr size_t kBaseShift = BaseShift;
+    static constexpr size_t kMaxBlocks = sizeof(size_t) * 8 - BaseShift;
+
+    // Blocks 0 .. block_count_ - 1 are allocated; element i lives at
+    // geometric_locate(i) and is constructed iff i < size_.
+    T* blocks_[kMaxBlocks];
+    size_t block_count_;
+    size_t size_;
+    size_t capacity_;
+    Allocator alloc_;
+
+    static size_t block_length(size_t block_idx);
+    static size_t block_start(size_t block_idx);
+    size_t block_used(size_t block_idx) const;
+    bv::detail::StorageRun<T*> iterator_run(size_t index) const;
+    void append_block();
+    void release_blocks_from(size_t first_block);
+    void destroy_range(size_t first, size_t last);
+    void release_storage();
+    void steal_from(GeometricBlockVector& other) noexcept;
+public:
+    using allocator_type  = Allocator;
+    using value_type      = T;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = T&;
+    using const_reference = const T&;
+    using pointer         = T*;
+    using const_pointer   = const T*;
+
+    // Iterators cache the current block, so stepping only relocates at block
+    // boundaries.
+    using iterator = bv::IndexIterator<GeometricBlockVector, false, bv::detail::RunAccess>;
+    using const_iterator = bv::IndexIterator<GeometricBlockVector, true, bv::detail::RunAccess>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    friend class bv::detail::RunAccess<GeometricBlockVector, false>;
+    friend class bv::detail::RunAccess<GeometricBlockVector, true>;
+    friend struct bv::detail::BlockOwnership;
+
+    GeometricBlockVector();
+    explicit GeometricBlockVector(const Allocator& alloc);
+    GeometricBlockVector(size_t n, const Allocator& alloc = Allocator());
+    GeometricBlockVector(size_t n, const T& value, const Allocator& alloc = Allocator());
+    GeometricBlockVector(std::initializer_list<T> init, const Allocator& alloc = Allocator());
+    GeometricBlockVector(const GeometricBlockVector& other);
+    GeometricBlockVector(GeometricBlockVector&& other) noexcept;
+    GeometricBlockVector& operator=(const GeometricBlockVector& other);
+    GeometricBlockVector& operator=(GeometricBlockVector&& other) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value ||
+        alloc_traits::is_always_equal::value);
+    ~GeometricBlockVector();
+
+    allocator_type get_allocator() const;
+    void swap(GeometricBlockVector& other) noexcept;
+
+    // Element access
+    T& operator[](size_t index);
+    const T& operator[](size_t index) const;
+    T& at(size_t index);
+    const T& at(size_t index) const;
+    T& front();
+    const T& front() const;
+    T& back();
+    const T& back() const;
+
+    // Capacity related
+    size_t size() const;
+    size_t capacity() const;
+    bool empty() const;
+    void reserve(size_t newCapacity);
+    void shrink_to_fit();
+
+    // manipulation
+    void push_back(const T& value);
+    void push_back(T&& value);
+    template <typename... Args>
+    T& emplace_back(Args&&... args);
+    void pop_back();
+    void clear();
+    void resize(size_t n);
+
+    // iterators
+    iterator begin();
+    const_iterator begin() const;
+    const_iterator cbegin() const;
+    iterator end();
+    const_iterator end() const;
+    const_iterator cend() const;
+    reverse_iterator rbegin();
+    const_reverse_iterator rbegin() const;
+    reverse_iterator rend();
+    const_reverse_iterator rend() const;
+
+    // block-wise access, as in BlockVector
+    using segment = bv::BlockSpan<T>;
+    using const_segment = bv::BlockSpan<const T>;
+
+    size_t segment_count() const;
+    segment get_segment(size_t block_idx);
+    const_segment get_segment(size_t block_idx) const;
+    template <typename Func>
+    void for_each_segment(Func&& fn);
+    template <typename Func>
+    void for_each_segment(Func&& fn) const;
+};
+
+// GeometricBlockVector Definitions
+
+template <typename T, typename Allocator, size_t BaseShift>
+GeometricBlockVector<T, Allocator, BaseShift>::GeometricBlockVector()
+    : GeometricBlockVector(Allocator()) {
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+GeometricBlockVector<T, Allocator, BaseShift>::GeometricBlockVector(const Allocator& alloc)
+    : block_count_(0), size_(0), capacity_(0), alloc_(alloc) {
+    for (size_t k = 0; k < kMaxBlocks; ++k) {
+        blocks_[k] = nullptr;
+    }
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+GeometricBlockVector<T, Allocator, BaseShift>::GeometricBlockVector(size_t n, const Allocator& alloc)
+    : GeometricBlockVector(alloc) {
+    resize(n);
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+GeometricBlockVector<T, Allocator, BaseShift>::GeometricBlockVector(size_t n, const T& value, const Allocator& alloc)
+    : GeometricBlockVector(alloc) {
+    reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        emplace_back(value);
+    }
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+GeometricBlockVector<T, Allocator, BaseShift>::GeometricBlockVector(std::initializer_list<T> init, const Allocator& alloc)
+    : GeometricBlockVector(alloc) {
+    reserve(init.size());
+    for (const T& value : init) {
+        emplace_back(value);
+    }
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+GeometricBlockVector<T, Allocator, BaseShift>::GeometricBlockVector(const GeometricBlockVector& other)
+    : GeometricBlockVector(alloc_traits::select_on_container_copy_construction(other.alloc_)) {
+    reserve(other.size_);
+    other.for_each_segment([&](const_segment seg) {
+        for (const T& value : seg) {
+            emplace_back(value);
+        }
+    });
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+GeometricBlockVector<T, Allocator, BaseShift>::GeometricBlockVector(GeometricBlockVector&& other) noexcept
+    : GeometricBlockVector(std::move(other.alloc_)) {
+    steal_from(other);
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+GeometricBlockVector<T, Allocator, BaseShift>& GeometricBlockVector<T, Allocator, BaseShift>::operator=(const GeometricBlockVector& other) {
+    if (this == &other) {
+        return *this;
+    }
+    bv::detail::BlockOwnership::copy_allocator(*this, other);
+    clear();
+    reserve(other.size_);
+    other.for_each_segment([&](const_segment seg) {
+        for (const T& value : seg) {
+            emplace_back(value);
+        }
+    });
+    return *this;
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+GeometricBlockVector<T, Allocator, BaseShift>& GeometricBlockVector<T, Allocator, BaseShift>::operator=(GeometricBlockVector&& other) noexcept(
+    alloc_traits::propagate_on_container_move_assignment::value ||
+    alloc_traits::is_always_equal::value) {
+    if (this == &other) {
+        return *this;
+    }
+    if (bv::detail::BlockOwnership::move_storage(*this, other)) {
+        return *this;
+    }
+    clear();
+    reserve(other.size_);
+    other.for_each_segment([&](segment seg) {
+        for (T& value : seg) {
+            emplace_back(std::move(value));
+        }
+    });
+    other.clear();
+    return *this;
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+GeometricBlockVector<T, Allocator, BaseShift>::~GeometricBlockVector() {
+    release_storage();
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+typename GeometricBlockVector<T, Allocator, BaseShift>::allocator_type
+GeometricBlockVector<T, Allocator, BaseShift>::get_allocator() const {
+    return alloc_;
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+void GeometricBlockVector<T, Allocator, BaseShift>::swap(GeometricBlockVector& other) noexcept {
+    using std::swap;
+    for (size_t k = 0; k < kMaxBlocks; ++k) {
+        swap(blocks_[k], other.blocks_[k]);
+    }
+    swap(block_count_, other.block_count_);
+    swap(size_, other.size_);
+    swap(capacity_, other.capacity_);
+    bv::detail::BlockOwnership::swap_allocators(*this, other);
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+void swap(GeometricBlockVector<T, Allocator, BaseShift>& a, GeometricBlockVector<T, Allocator, BaseShift>& b) noexcept {
+    a.swap(b);
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+T& GeometricBlockVector<T, Allocator, BaseShift>::operator[](size_t index) {
+    bv::detail::GeometricSlot slot = bv::detail::geometric_locate(index, BaseShift);
+    return blocks_[slot.block][slot.offset];
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+const T& GeometricBlockVector<T, Allocator, BaseShift>::operator[](size_t index) const {
+    bv::detail::GeometricSlot slot = bv::detail::geometric_locate(index, BaseShift);
+    return blocks_[slot.block][slot.offset];
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+T& GeometricBlockVector<T, Allocator, BaseShift>::at(size_t index) {
+    if (index >= size_) {
+        throw std::out_of_range("GeometricBlockVector::at");
+    }
+    return (*this)[index];
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+const T& GeometricBlockVector<T, Allocator, BaseShift>::at(size_t index) const {
+    if (index >= size_) {
+        throw std::out_of_range("GeometricBlockVector::at");
+    }
+    return (*this)[index];
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+T& GeometricBlockVector<T, Allocator, BaseShift>::front() {
+    return blocks_[0][0];
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+const T& GeometricBlockVector<T, Allocator, BaseShift>::front() const {
+    return blocks_[0][0];
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+T& GeometricBlockVector<T, Allocator, BaseShift>::back() {
+    return (*this)[size_ - 1];
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+const T& GeometricBlockVector<T, Allocator, BaseShift>::back() const {
+    return (*this)[size_ - 1];
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+size_t GeometricBlockVector<T, Allocator, BaseShift>::size() const {
+    return size_;
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+size_t GeometricBlockVector<T, Allocator, BaseShift>::capacity() const {
+    return capacity_;
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+bool GeometricBlockVector<T, Allocator, BaseShift>::empty() const {
+    return size_ == 0;
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+void GeometricBlockVector<T, Allocator, BaseShift>::reserve(size_t newCapacity) {
+    while (capacity_ < newCapacity) {
+        append_block();
+    }
+}
+
+// Frees the blocks past the one holding the last element.
+template <typename T, typename Allocator, size_t BaseShift>
+void GeometricBlockVector<T, Allocator, BaseShift>::shrink_to_fit() {
+    release_blocks_from(size_ == 0 ? 0 : bv::detail::geometric_locate(size_ - 1, BaseShift).block + 1);
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+void GeometricBlockVector<T, Allocator, BaseShift>::push_back(const T& value) {
+    emplace_back(value);
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+void GeometricBlockVector<T, Allocator, BaseShift>::push_back(T&& value) {
+    emplace_back(std::move(value));
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+template <typename... Args>
+T& GeometricBlockVector<T, Allocator, BaseShift>::emplace_back(Args&&... args) {
+    if (size_ == capacity_) {
+        append_block();
+    }
+    T* element = &(*this)[size_];
+    alloc_traits::construct(alloc_, element, std::forward<Args>(args)...);
+    ++size_;
+    return *element;
+}
+
+// Blocks are kept for reuse; shrink_to_fit() releases them.
+template <typename T, typename Allocator, size_t BaseShift>
+void GeometricBlockVector<T, Allocator, BaseShift>::pop_back() {
+    if (size_ == 0) {
+        return;
+    }
+    --size_;
+    alloc_traits::destroy(alloc_, &(*this)[size_]);
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+void GeometricBlockVector<T, Allocator, BaseShift>::clear() {
+    destroy_range(0, size_);
+    size_ = 0;
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+void GeometricBlockVector<T, Allocator, BaseShift>::resize(size_t n) {
+    if (n < size_) {
+        destroy_range(n, size_);
+        size_ = n;
+        return;
+    }
+    reserve(n);
+    while (size_ < n) {
+        emplace_back();
+    }
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+typename GeometricBlockVector<T, Allocator, BaseShift>::iterator GeometricBlockVector<T, Allocator, BaseShift>::begin() {
+    return iterator(0, this);
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+typename GeometricBlockVector<T, Allocator, BaseShift>::const_iterator GeometricBlockVector<T, Allocator, BaseShift>::begin() const {
+    return const_iterator(0, this);
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+typename GeometricBlockVector<T, Allocator, BaseShift>::const_iterator GeometricBlockVector<T, Allocator, BaseShift>::cbegin() const {
+    return begin();
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+typename GeometricBlockVector<T, Allocator, BaseShift>::iterator GeometricBlockVector<T, Allocator, BaseShift>::end() {
+    return iterator(size_, this);
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+typename GeometricBlockVector<T, Allocator, BaseShift>::const_iterator GeometricBlockVector<T, Allocator, BaseShift>::end() const {
+    return const_iterator(size_, this);
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+typename GeometricBlockVector<T, Allocator, BaseShift>::const_iterator GeometricBlockVector<T, Allocator, BaseShift>::cend() const {
+    return end();
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+typename GeometricBlockVector<T, Allocator, BaseShift>::reverse_iterator GeometricBlockVector<T, Allocator, BaseShift>::rbegin() {
+    return reverse_iterator(end());
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+typename GeometricBlockVector<T, Allocator, BaseShift>::const_reverse_iterator GeometricBlockVector<T, Allocator, BaseShift>::rbegin() const {
+    return const_reverse_iterator(end());
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+typename GeometricBlockVector<T, Allocator, BaseShift>::reverse_iterator GeometricBlockVector<T, Allocator, BaseShift>::rend() {
+    return reverse_iterator(begin());
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+typename GeometricBlockVector<T, Allocator, BaseShift>::const_reverse_iterator GeometricBlockVector<T, Allocator, BaseShift>::rend() const {
+    return const_reverse_iterator(begin());
+}
+
+// Number of blocks holding at least one element.
+template <typename T, typename Allocator, size_t BaseShift>
+size_t GeometricBlockVector<T, Allocator, BaseShift>::segment_count() const {
+    return size_ == 0 ? 0 : bv::detail::geometric_locate(size_ - 1, BaseShift).block + 1;
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+typename GeometricBlockVector<T, Allocator, BaseShift>::segment
+GeometricBlockVector<T, Allocator, BaseShift>::get_segment(size_t block_idx) {
+    return segment{blocks_[block_idx], block_used(block_idx)};
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+typename GeometricBlockVector<T, Allocator, BaseShift>::const_segment
+GeometricBlockVector<T, Allocator, BaseShift>::get_segment(size_t block_idx) const {
+    return const_segment{blocks_[block_idx], block_used(block_idx)};
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+template <typename Func>
+void GeometricBlockVector<T, Allocator, BaseShift>::for_each_segment(Func&& fn) {
+    size_t segments = segment_count();
+    for (size_t k = 0; k < segments; ++k) {
+        fn(get_segment(k));
+    }
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+template <typename Func>
+void GeometricBlockVector<T, Allocator, BaseShift>::for_each_segment(Func&& fn) const {
+    size_t segments = segment_count();
+    for (size_t k = 0; k < segments; ++k) {
+        fn(get_segment(k));
+    }
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+size_t GeometricBlockVector<T, Allocator, BaseShift>::block_length(size_t block_idx) {
+    return (static_cast<size_t>(1) << BaseShift) << block_idx;
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+size_t GeometricBlockVector<T, Allocator, BaseShift>::block_start(size_t block_idx) {
+    return ((static_cast<size_t>(1) << block_idx) - 1) << BaseShift;
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+bv::detail::StorageRun<T*> GeometricBlockVector<T, Allocator, BaseShift>::iterator_run(size_t index) const {
+    bv::detail::GeometricSlot slot = bv::detail::geometric_locate(index, kBaseShift);
+    T* block = blocks_[slot.block];
+    return {block, block + slot.offset, block + block_length(slot.block)};
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+size_t GeometricBlockVector<T, Allocator, BaseShift>::block_used(size_t block_idx) const {
+    size_t start = block_start(block_idx);
+    if (size_ <= start) {
+        return 0;
+    }
+    size_t remaining = size_ - start;
+    return remaining < block_length(block_idx) ? remaining : block_length(block_idx);
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+void GeometricBlockVector<T, Allocator, BaseShift>::append_block() {
+    if (block_count_ == kMaxBlocks) {
+        throw std::length_error("GeometricBlockVector: too many elements");
+    }
+    blocks_[block_count_] = alloc_traits::allocate(alloc_, block_length(block_count_));
+    capacity_ += block_length(block_count_);
+    ++block_count_;
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+void GeometricBlockVector<T, Allocator, BaseShift>::release_blocks_from(size_t first_block) {
+    while (block_count_ > first_block) {
+        --block_count_;
+        alloc_traits::deallocate(alloc_, blocks_[block_count_], block_length(block_count_));
+        blocks_[block_count_] = nullptr;
+        capacity_ -= block_length(block_count_);
+    }
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+void GeometricBlockVector<T, Allocator, BaseShift>::destroy_range(size_t first, size_t last) {
+    if (std::is_trivially_destructible<T>::value) {
+        return;
+    }
+    for (size_t i = first; i < last; ++i) {
+        alloc_traits::destroy(alloc_, &(*this)[i]);
+    }
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+void GeometricBlockVector<T, Allocator, BaseShift>::release_storage() {
+    destroy_range(0, size_);
+    size_ = 0;
+    release_blocks_from(0);
+}
+
+template <typename T, typename Allocator, size_t BaseShift>
+void GeometricBlockVector<T, Allocator, BaseShift>::steal_from(GeometricBlockVector& other) noexcept {
+    for (size_t k = 0; k < kMaxBlocks; ++k) {
+        blocks_[k] = other.blocks_[k];
+        other.blocks_[k] = nullptr;
+    }
+    block_count_ = other.block_count_;
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    other.block_count_ = 0;
+    other.size_ = 0;
+    other.capacity_ = 0;
+}
@@ -0,0 +1,211 @@
+#pragma once
+#include "BlockVector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+#include <sys/mman.h>
+
+namespace {
+constexpr size_t kHugePageSize = static_cast<size_t>(2) << 20;
+constexpr size_t kDefaultHugeArenaBytes = kHugePageSize * 32;
+}
+
+namespace bv {
+
+// Memory resource that carves allocations out of 2 MB-aligned anonymous
+// arenas advised with MADV_HUGEPAGE, so a large BlockVector's blocks share a
+// few huge pages instead of being scattered across 4 KB pages of the heap:
+//
+//     bv::HugePageResource huge;
+//     pmr::BlockVector<Record> records(&huge);
+//
+// Freed allocations go onto a free list for their size and alignment and are
+// reused by the next allocation of that size and alignment, which suits
+// fixed-size blocks; memory is returned to the system when the resource is
+// destroyed. A request larger than an arena gets a mapping of its own. When a
+// request does not fit in the rest of the current arena, that rest is kept as
+// a leftover and serves later requests that fit in it, so the only space
+// never handed out is leftovers smaller than every later request.
+//
+// MADV_HUGEPAGE only makes the arenas eligible for transparent huge pages:
+// the kernel may still back them with normal pages (THP disabled, no free
+// 2 MB frames), and /proc/self/smaps (AnonHugePages) is the only place to see
+// what it did. Like std::pmr::unsynchronized_pool_resource, it is not
+// thread-safe.
+class HugePageResource : public std::pmr::memory_resource {
+public:
+    explicit HugePageResource(size_t arena_bytes = kDefaultHugeArenaBytes);
+    HugePageResource(const HugePageResource&) = delete;
+    HugePageResource& operator=(const HugePageResource&) = delete;
+    ~HugePageResource() override;
+
+    // True if madvise(MADV_HUGEPAGE) succeeded for every arena mapped so far.
+    // This says the advice was accepted, not that huge pages back the arenas.
+    bool huge_page_advice_accepted() const { return advice_accepted_; }
+    size_t arena_count() const { return arenas_.size(); }
+
+private:
+    struct Arena {
+        void* base;
+        size_t length;
+    };
+    struct FreeList {
+        size_t bytes;
+        size_t alignment;
+        void* head;
+    };
+    struct Leftover {
+        char* cursor;
+        char* limit;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    static size_t round_up(size_t value, size_t multiple);
+    static void* carve(char*& cursor, char* limit, size_t bytes, size_t alignment);
+    char* map_arena(size_t min_bytes);
+    FreeList* find_free_list(size_t bytes, size_t alignment);
+
+    size_t arena_bytes_;
+    std::vector<Arena> arenas_;
+    std::vector<FreeList> free_lists_;
+    std::vector<Leftover> leftovers_;
+    char* cursor_;
+    char* limit_;
+    bool advice_accepted_;
+};
+
+inline HugePageResource::HugePageResource(size_t arena_bytes)
+    : arena_bytes_(round_up(arena_bytes == 0 ? kHugePageSize : arena_bytes, kHugePageSize)),
+      cursor_(nullptr), limit_(nullptr), advice_accepted_(true) {
+}
+
+inline HugePageResource::~HugePageResource() {
+    for (const Arena& arena : arenas_) {
+        ::munmap(arena.base, arena.length);
+    }
+}
+
+inline size_t HugePageResource::round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+// Bump-allocates from [cursor, limit); null if the request does not fit.
+inline void* HugePageResource::carve(char*& cursor, char* limit, size_t bytes, size_t alignment) {
+    if (cursor == nullptr) {
+        return nullptr;
+    }
+    uintptr_t aligned = round_up(reinterpret_cast<uintptr_t>(cursor), alignment);
+    if (aligned > reinterpret_cast<uintptr_t>(limit) || bytes > reinterpret_cast<uintptr_t>(limit) - aligned) {
+        return nullptr;
+    }
+    cursor = reinterpret_cast<char*>(aligned + bytes);
+    return reinterpret_cast<void*>(aligned);
+}
+
+// Maps an arena of at least `min_bytes` on a 2 MB boundary by over-allocating
+// one huge page and trimming the misaligned head and tail. Returns its base.
+inline char* HugePageResource::map_arena(size_t min_bytes) {
+    size_t length = arena_bytes_ > min_bytes ? arena_bytes_ : round_up(min_bytes, kHugePageSize);
+    arenas_.reserve(arenas_.size() + 1);
+    void* raw = ::mmap(nullptr, length + kHugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = round_up(start, kHugePageSize);
+    if (aligned > start) {
+        ::munmap(raw, aligned - start);
+    }
+    size_t tail = kHugePageSize - (aligned - start);
+    if (tail > 0) {
+        ::munmap(reinterpret_cast<void*>(aligned + length), tail);
+    }
+    void* base = reinterpret_cast<void*>(aligned);
+#if defined(MADV_HUGEPAGE)
+    if (::madvise(base, length, MADV_HUGEPAGE) != 0) {
+        advice_accepted_ = false;
+    }
+#else
+    advice_accepted_ = false;
+#endif
+    arenas_.push_back(Arena{base, length});
+    return static_cast<char*>(base);
+}
+
+// Chunks are only reused at the alignment they were handed out with, so a
+// chunk freed at 8 bytes never comes back for a 64-byte-aligned request.
+inline HugePageResource::FreeList* HugePageResource::find_free_list(size_t bytes, size_t alignment) {
+    for (FreeList& list : free_lists_) {
+        if (list.bytes == bytes && list.alignment == alignment) {
+            return &list;
+        }
+    }
+    return nullptr;
+}
+
+inline void* HugePageResource::do_allocate(size_t bytes, size_t alignment) {
+    if (alignment < alignof(void*)) {
+        alignment = alignof(void*);
+    }
+    bytes = round_up(bytes == 0 ? 1 : bytes, alignment);
+
+    // The free list is created when a size and alignment is first handed
+    // out, so do_deallocate never has to allocate (and so never throws).
+    FreeList* list = find_free_list(bytes, alignment);
+    if (list == nullptr) {
+        free_lists_.push_back(FreeList{bytes, alignment, nullptr});
+    } else if (list->head != nullptr) {
+        void* p = list->head;
+        list->head = *static_cast<void**>(p);
+        return p;
+    }
+
+    if (void* p = carve(cursor_, limit_, bytes, alignment)) {
+        return p;
+    }
+    for (Leftover& leftover : leftovers_) {
+        if (void* p = carve(leftover.cursor, leftover.limit, bytes, alignment)) {
+            return p;
+        }
+    }
+    // Arena bases are 2 MB aligned, so any alignment up to that needs no slack.
+    size_t needed = alignment <= kHugePageSize ? bytes : bytes + alignment;
+    if (needed > arena_bytes_) {
+        char* base = map_arena(needed);
+        char* cursor = base;
+        return carve(cursor, base + needed, bytes, alignment);
+    }
+    if (cursor_ != nullptr && cursor_ < limit_) {
+        leftovers_.push_back(Leftover{cursor_, limit_});
+    }
+    cursor_ = map_arena(needed);
+    limit_ = cursor_ + arena_bytes_;
+    return carve(cursor_, limit_, bytes, alignment);
+}
+
+// The chunk is kept for the next allocation of the same rounded size and
+// alignment; the free list is threaded through the freed chunks themselves.
+// do_allocate already created that list, so this never allocates.
+inline void HugePageResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    if (alignment < alignof(void*)) {
+        alignment = alignof(void*);
+    }
+    bytes = round_up(bytes == 0 ? 1 : bytes, alignment);
+
+    FreeList* list = find_free_list(bytes, alignment);
+    *static_cast<void**>(p) = list->head;
+    list->head = p;
+}
+
+inline bool HugePageResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+} // namespace bv
@@ -0,0 +1,580 @@
+#pragma once
+#include "BlockVector.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+constexpr size_t kDefaultMappedBlockSize = static_cast<size_t>(1) << 16;
+}
+
+namespace bv {
+namespace detail {
+constexpr uint64_t kMappedMagic = 0x0031504d56424b42ULL; // "BKBVMP1"
+constexpr uint32_t kMappedVersion = 1;
+
+// First page of a mapped file. Block k starts at data_offset + k * block_stride.
+struct MappedHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t element_size;
+    uint64_t block_size;
+    uint64_t block_stride;
+    uint64_t data_offset;
+    uint64_t block_count;
+    uint64_t size;
+};
+
+[[noreturn]] inline void throw_errno(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+} // namespace detail
+} // namespace bv
+
+// BlockVector whose blocks live in a file.
+//
+// Every block is a page-aligned region of the backing file mapped with
+// MAP_SHARED, so elements are written straight to the page cache. Growing
+// extends the file and maps the new blocks next to the old ones, which never
+// move: pointers and references stay valid exactly as with BlockVector.
+//
+// Opening an existing file only validates its header and maps the blocks it
+// already holds in one call; pages are faulted in on first access, so a
+// multi-GB container is usable right away. The element count is kept in the
+// mapped header and is updated on every size change; call sync() to force
+// the data to disk. T must be trivially copyable, since elements are stored
+// and reloaded as raw bytes.
+template <typename T>
+class MappedBlockVector {
+private:
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "MappedBlockVector: T must be trivially copyable");
+
+    struct Mapping {
+        void* base;
+        size_t length;
+    };
+
+    int fd_;
+    bv::detail::MappedHeader* header_;
+    size_t header_bytes_;
+    std::vector<T*> blocks_;
+    std::vector<Mapping> mappings_;
+    size_t block_count_;
+    size_t size_;
+    size_t block_size_;
+    size_t block_shift_;
+    size_t block_mask_;
+    size_t block_stride_;
+
+    void open_file(const std::string& path, size_t block_size);
+    void init_header(size_t block_size);
+    void load_header();
+    void map_blocks(size_t count);
+    void set_size(size_t n);
+    size_t block_used(size_t block_idx) const;
+    void release() noexcept;
+public:
+    using value_type      = T;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = T&;
+    using const_reference = const T&;
+    using pointer         = T*;
+    using const_pointer   = const T*;
+
+    using iterator = BlockVectorIterator<MappedBlockVector, false>;
+    using const_iterator = BlockVectorIterator<MappedBlockVector, true>;
+    using segment = bv::BlockSpan<T>;
+    using const_segment = bv::BlockSpan<const T>;
+    using segment_range = BlockSegmentRange<MappedBlockVector, false>;
+    using const_segment_range = BlockSegmentRange<MappedBlockVector, true>;
+
+    friend class BlockVectorIterator<MappedBlockVector, false>;
+    friend class BlockVectorIterator<MappedBlockVector, true>;
+    friend class BlockSegmentRange<MappedBlockVector, false>;
+    friend class BlockSegmentRange<MappedBlockVector, true>;
+
+    // Opens `path`, creating it if it is missing or empty. `block_size` (in
+    // elements, rounded up to a power of two) only applies to new files; an
+    // existing file keeps the geometry recorded in its header.
+    explicit MappedBlockVector(const std::string& path, size_t block_size = kDefaultMappedBlockSize);
+    MappedBlockVector(const MappedBlockVector&) = delete;
+    MappedBlockVector& operator=(const MappedBlockVector&) = delete;
+    MappedBlockVector(MappedBlockVector&& other) noexcept;
+    MappedBlockVector& operator=(MappedBlockVector&& other) noexcept;
+    ~MappedBlockVector();
+
+    void swap(MappedBlockVector& other) noexcept;
+
+    // Element access
+    T& operator[](size_t index);
+    const T& operator[](size_t index) const;
+    T& at(size_t index);
+    const T& at(size_t index) const;
+    T& front();
+    const T& front() const;
+    T& back();
+    const T& back() const;
+
+    // Capacity related
+    size_t size() const;
+    size_t capacity() const;
+    bool empty() const;
+    void reserve(size_t newCapacity);
+    size_t get_Block_size() const;
+
+    // manipulation
+    void push_back(const T& value);
+    template <typename... Args>
+    T& emplace_back(Args&&... args);
+    void pop_back();
+    void clear();
+    void resize(size_t n);
+
+    // Writes every dirty page and the header back to the file.
+    void sync();
+
+    // iterators
+    iterator begin();
+    const_iterator begin() const;
+    iterator end();
+    const_iterator end() const;
+
+    // block-wise access
+    size_t segment_count() const;
+    segment get_segment(size_t block_idx);
+    const_segment get_segment(size_t block_idx) const;
+    segment_range segments();
+    const_segment_range segments() const;
+    template <typename Func>
+    void for_each_segment(Func&& fn) const;
+    // Same contract as BlockVector::prefetch_ahead.
+    void prefetch_ahead(size_t block_idx) const;
+};
+
+// MappedBlockVector Definitions
+
+template <typename T>
+MappedBlockVector<T>::MappedBlockVector(const std::string& path, size_t block_size)
+    : fd_(-1), header_(nullptr), header_bytes_(0), block_count_(0), size_(0),
+      block_size_(0), block_shift_(0), block_mask_(0), block_stride_(0) {
+    try {
+        open_file(path, block_size);
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+template <typename T>
+MappedBlockVector<T>::MappedBlockVector(MappedBlockVector&& other) noexcept
+    : fd_(-1), header_(nullptr), header_bytes_(0), block_count_(0), size_(0),
+      block_size_(0), block_shift_(0), block_mask_(0), block_stride_(0) {
+    swap(other);
+}
+
+template <typename T>
+MappedBlockVector<T>& MappedBlockVector<T>::operator=(MappedBlockVector&& other) noexcept {
+    if (this != &other) {
+        release();
+        swap(other);
+    }
+    return *this;
+}
+
+template <typename T>
+MappedBlockVector<T>::~MappedBlockVector() {
+    release();
+}
+
+template <typename T>
+void MappedBlockVector<T>::swap(MappedBlockVector& other) noexcept {
+    using std::swap;
+    swap(fd_, other.fd_);
+    swap(header_, other.header_);
+    swap(header_bytes_, other.header_bytes_);
+    blocks_.swap(other.blocks_);
+    mappings_.swap(other.mappings_);
+    swap(block_count_, other.block_count_);
+    swap(size_, other.size_);
+    swap(block_size_, other.block_size_);
+    swap(block_shift_, other.block_shift_);
+    swap(block_mask_, other.block_mask_);
+    swap(block_stride_, other.block_stride_);
+}
+
+template <typename T>
+T& MappedBlockVector<T>::operator[](size_t index) {
+    return blocks_[index >> block_shift_][index & block_mask_];
+}
+
+template <typename T>
+const T& MappedBlockVector<T>::operator[](size_t index) const {
+    return blocks_[index >> block_shift_][index & block_mask_];
+}
+
+template <typename T>
+T& MappedBlockVector<T>::at(size_t index) {
+    if (index >= size_) {
+        throw std::out_of_range("MappedBlockVector::at");
+    }
+    return (*this)[index];
+}
+
+template <typename T>
+const T& MappedBlockVector<T>::at(size_t index) const {
+    if (index >= size_) {
+        throw std::out_of_range("MappedBlockVector::at");
+    }
+    return (*this)[index];
+}
+
+template <typename T>
+T& MappedBlockVector<T>::front() {
+    return (*this)[0];
+}
+
+template <typename T>
+const T& MappedBlockVector<T>::front() const {
+    return (*this)[0];
+}
+
+template <typename T>
+T& MappedBlockVector<T>::back() {
+    return (*this)[size_ - 1];
+}
+
+template <typename T>
+const T& MappedBlockVector<T>::back() const {
+    return (*this)[size_ - 1];
+}
+
+template <typename T>
+size_t MappedBlockVector<T>::size() const {
+    return size_;
+}
+
+template <typename T>
+size_t MappedBlockVector<T>::capacity() const {
+    return block_count_ << block_shift_;
+}
+
+template <typename T>
+bool MappedBlockVector<T>::empty() const {
+    return size_ == 0;
+}
+
+// Extends the file once and maps all missing blocks with a single mmap.
+template <typename T>
+void MappedBlockVector<T>::reserve(size_t newCapacity) {
+    size_t required_blocks = (newCapacity + block_mask_) >> block_shift_;
+    if (required_blocks > block_count_) {
+        map_blocks(required_blocks - block_count_);
+    }
+}
+
+template <typename T>
+size_t MappedBlockVector<T>::get_Block_size() const {
+    return block_size_;
+}
+
+template <typename T>
+void MappedBlockVector<T>::push_back(const T& value) {
+    emplace_back(value);
+}
+
+template <typename T>
+template <typename... Args>
+T& MappedBlockVector<T>::emplace_back(Args&&... args) {
+    if (size_ == capacity()) {
+        map_blocks(1);
+    }
+    T* slot = &(*this)[size_];
+    ::new (static_cast<void*>(slot)) T(std::forward<Args>(args)...);
+    set_size(size_ + 1);
+    return *slot;
+}
+
+// Blocks stay mapped and the file keeps its length; only the size shrinks.
+template <typename T>
+void MappedBlockVector<T>::pop_back() {
+    if (size_ != 0) {
+        set_size(size_ - 1);
+    }
+}
+
+template <typename T>
+void MappedBlockVector<T>::clear() {
+    set_size(0);
+}
+
+template <typename T>
+void MappedBlockVector<T>::resize(size_t n) {
+    if (n > size_) {
+        reserve(n);
+        for (size_t i = size_; i < n; ++i) {
+            ::new (static_cast<void*>(&(*this)[i])) T();
+        }
+    }
+    set_size(n);
+}
+
+template <typename T>
+void MappedBlockVector<T>::sync() {
+    for (const Mapping& mapping : mappings_) {
+        if (::msync(mapping.base, mapping.length, MS_SYNC) != 0) {
+            bv::detail::throw_errno("MappedBlockVector: msync");
+        }
+    }
+    if (::msync(header_, header_bytes_, MS_SYNC) != 0) {
+        bv::detail::throw_errno("MappedBlockVector: msync");
+    }
+}
+
+template <typename T>
+typename MappedBlockVector<T>::iterator MappedBlockVector<T>::begin() {
+    return iterator(0, this);
+}
+
+template <typename T>
+typename MappedBlockVector<T>::const_iterator MappedBlockVector<T>::begin() const {
+    return const_iterator(0, this);
+}
+
+template <typename T>
+typename MappedBlockVector<T>::iterator MappedBlockVector<T>::end() {
+    return iterator(size_, this);
+}
+
+template <typename T>
+typename MappedBlockVector<T>::const_iterator MappedBlockVector<T>::end() const {
+    return const_iterator(size_, this);
+}
+
+template <typename T>
+size_t MappedBlockVector<T>::segment_count() const {
+    return (size_ + block_mask_) >> block_shift_;
+}
+
+template <typename T>
+typename MappedBlockVector<T>::segment MappedBlockVector<T>::get_segment(size_t block_idx) {
+    return segment{blocks_[block_idx], block_used(block_idx)};
+}
+
+template <typename T>
+typename MappedBlockVector<T>::const_segment MappedBlockVector<T>::get_segment(size_t block_idx) const {
+    return const_segment{blocks_[block_idx], block_used(block_idx)};
+}
+
+template <typename T>
+typename MappedBlockVector<T>::segment_range MappedBlockVector<T>::segments() {
+    return segment_range(this);
+}
+
+template <typename T>
+typename MappedBlockVector<T>::const_segment_range MappedBlockVector<T>::segments() const {
+    return const_segment_range(this);
+}
+
+template <typename T>
+template <typename Func>
+void MappedBlockVector<T>::for_each_segment(Func&& fn) const {
+    size_t count = segment_count();
+    for (size_t b = 0; b < count; ++b) {
+        prefetch_ahead(b);
+        fn(get_segment(b));
+    }
+}
+
+template <typename T>
+void MappedBlockVector<T>::prefetch_ahead(size_t block_idx) const {
+    bv::detail::prefetch_block_ahead<bv::DefaultPrefetch>(blocks_.data(), block_count_, block_idx,
+                                                          block_size_ * sizeof(T));
+}
+
+template <typename T>
+void MappedBlockVector<T>::open_file(const std::string& path, size_t block_size) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        bv::detail::throw_errno("MappedBlockVector: open");
+    }
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+        bv::detail::throw_errno("MappedBlockVector: fstat");
+    }
+    if (st.st_size == 0) {
+        init_header(block_size);
+    } else {
+        load_header();
+    }
+}
+
+template <typename T>
+void MappedBlockVector<T>::init_header(size_t block_size) {
+    size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t rounded = 1;
+    while (rounded < block_size) {
+        rounded <<= 1;
+    }
+    header_bytes_ = (sizeof(bv::detail::MappedHeader) + page - 1) / page * page;
+    if (::ftruncate(fd_, static_cast<off_t>(header_bytes_)) != 0) {
+        bv::detail::throw_errno("MappedBlockVector: ftruncate");
+    }
+    void* base = ::mmap(nullptr, header_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (base == MAP_FAILED) {
+        bv::detail::throw_errno("MappedBlockVector: mmap");
+    }
+    header_ = static_cast<bv::detail::MappedHeader*>(base);
+    header_->magic = bv::detail::kMappedMagic;
+    header_->version = bv::detail::kMappedVersion;
+    header_->element_size = static_cast<uint32_t>(sizeof(T));
+    header_->block_size = rounded;
+    header_->block_stride = (rounded * sizeof(T) + page - 1) / page * page;
+    header_->data_offset = header_bytes_;
+    header_->block_count = 0;
+    header_->size = 0;
+
+    block_size_ = rounded;
+    block_shift_ = bv::detail::floor_log2(rounded);
+    block_mask_ = rounded - 1;
+    block_stride_ = static_cast<size_t>(header_->block_stride);
+}
+
+template <typename T>
+void MappedBlockVector<T>::load_header() {
+    bv::detail::MappedHeader header;
+    ssize_t got = ::pread(fd_, &header, sizeof(header), 0);
+    if (got < 0) {
+        bv::detail::throw_errno("MappedBlockVector: pread");
+    }
+    size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    if (static_cast<size_t>(got) != sizeof(header) || header.magic != bv::detail::kMappedMagic) {
+        throw std::runtime_error("MappedBlockVector: not a mapped BlockVector file");
+    }
+    if (header.version != bv::detail::kMappedVersion || header.element_size != sizeof(T)) {
+        throw std::runtime_error("MappedBlockVector: file version or element size mismatch");
+    }
+    // Every field is untrusted: each product is checked for overflow before
+    // it is formed.
+    if (header.block_size == 0 || (header.block_size & (header.block_size - 1)) != 0 ||
+        header.block_size > UINT64_MAX / sizeof(T) ||
+        header.block_stride % page != 0 || header.block_stride < header.block_size * sizeof(T) ||
+        header.data_offset % page != 0 || header.data_offset < sizeof(bv::detail::MappedHeader) ||
+        header.block_count > UINT64_MAX / header.block_size ||
+        header.size > header.block_count * header.block_size) {
+        throw std::runtime_error("MappedBlockVector: corrupt header");
+    }
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+        bv::detail::throw_errno("MappedBlockVector: fstat");
+    }
+    uint64_t file_bytes = static_cast<uint64_t>(st.st_size);
+    if (file_bytes < header.data_offset ||
+        header.block_count > (file_bytes - header.data_offset) / header.block_stride) {
+        throw std::runtime_error("MappedBlockVector: file is truncated");
+    }
+
+    header_bytes_ = static_cast<size_t>(header.data_offset);
+    void* base = ::mmap(nullptr, header_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (base == MAP_FAILED) {
+        bv::detail::throw_errno("MappedBlockVector: mmap");
+    }
+    header_ = static_cast<bv::detail::MappedHeader*>(base);
+    block_size_ = static_cast<size_t>(header.block_size);
+    block_shift_ = bv::detail::floor_log2(block_size_);
+    block_mask_ = block_size_ - 1;
+    block_stride_ = static_cast<size_t>(header.block_stride);
+
+    // The on-disk block count is left alone until the blocks are mapped, so
+    // a failed open never rewrites the header of a valid file.
+    size_t existing = static_cast<size_t>(header.block_count);
+    if (existing > 0) {
+        map_blocks(existing);
+    }
+    size_ = static_cast<size_t>(header.size);
+}
+
+// Maps `count` more blocks as one contiguous region of the file, extending
+// the file first when it is too short.
+template <typename T>
+void MappedBlockVector<T>::map_blocks(size_t count) {
+    size_t offset = header_bytes_ + block_count_ * block_stride_;
+    size_t length = count * block_stride_;
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+        bv::detail::throw_errno("MappedBlockVector: fstat");
+    }
+    if (static_cast<size_t>(st.st_size) < offset + length &&
+        ::ftruncate(fd_, static_cast<off_t>(offset + length)) != 0) {
+        bv::detail::throw_errno("MappedBlockVector: ftruncate");
+    }
+    // Reserve first: once the region is mapped nothing below may throw, or
+    // the mapping would leak.
+    mappings_.reserve(mappings_.size() + 1);
+    blocks_.reserve(block_count_ + count);
+    void* base = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, static_cast<off_t>(offset));
+    if (base == MAP_FAILED) {
+        bv::detail::throw_errno("MappedBlockVector: mmap");
+    }
+    mappings_.push_back(Mapping{base, length});
+    for (size_t k = 0; k < count; ++k) {
+        blocks_.push_back(reinterpret_cast<T*>(static_cast<char*>(base) + k * block_stride_));
+    }
+    block_count_ += count;
+    header_->block_count = block_count_;
+}
+
+template <typename T>
+void MappedBlockVector<T>::set_size(size_t n) {
+    size_ = n;
+    header_->size = n;
+}
+
+// Number of constructed elements in block `block_idx`.
+template <typename T>
+size_t MappedBlockVector<T>::block_used(size_t block_idx) const {
+    size_t first = block_idx << block_shift_;
+    if (first >= size_) {
+        return 0;
+    }
+    size_t remaining = size_ - first;
+    return remaining < block_size_ ? remaining : block_size_;
+}
+
+template <typename T>
+void MappedBlockVector<T>::release() noexcept {
+    for (const Mapping& mapping : mappings_) {
+        ::munmap(mapping.base, mapping.length);
+    }
+    mappings_.clear();
+    blocks_.clear();
+    if (header_ != nullptr) {
+        ::munmap(header_, header_bytes_);
+        header_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    block_count_ = 0;
+    size_ = 0;
+}
+
+template <typename T>
+void swap(MappedBlockVector<T>& lhs, MappedBlockVector<T>& rhs) noexcept {
+    lhs.swap(rhs);
+}
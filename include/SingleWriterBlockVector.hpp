@@ -0,0 +1,306 @@
+#pragma once
+#include "BlockVector.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Append-only block container for one writer thread and any number of reader
+// threads. Blocks have the fixed size 1 << BlockShift, so element i is at
+// block i >> BlockShift, slot i & mask, as in BlockVector.
+//
+// The block directory never moves, so readers can load it while it grows. It
+// has two levels: a fixed array of segment pointers inside the object, where
+// segment k holds (16 << k) block pointers. A new segment is allocated next
+// to the old ones and nothing is ever copied or freed before the container
+// itself.
+//
+// The writer constructs an element, installs any new block and segment
+// pointers, and then publishes with a release store of the size. A reader
+// that loads the size (acquire) may read every index below it with plain
+// loads: no locks, CAS or retry loops, so operator[] and iteration are
+// wait-free. snapshot() captures one size so a scan sees a consistent prefix.
+//
+// Published elements are immutable: the container only hands out const
+// references. push_back/emplace_back/reserve must be called from a single
+// thread at a time; destruction must not race with anything.
+template <typename T, typename Allocator = std::allocator<T>, size_t BlockShift = 8>
+class SingleWriterBlockVector;
+
+template <typename Container>
+class SingleWriterSnapshot;
+
+template <typename T, typename Allocator, size_t BlockShift>
+class SingleWriterBlockVector {
+private:
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using block_slot = std::atomic<T*>;
+    using segment_allocator = typename alloc_traits::template rebind_alloc<block_slot>;
+    using segment_traits = std::allocator_traits<segment_allocator>;
+    static_assert(std::is_same<typename alloc_traits::pointer, T*>::value,
+                  "SingleWriterBlockVector: Allocator must hand out raw pointers");
+    static_assert(BlockShift < sizeof(size_t) * 8, "BlockShift out of range");
+
+    static constexpr size_t kBlockShift = BlockShift;
+    static constexpr size_t kBlockSize = static_cast<size_t>(1) << BlockShift;
+    static constexpr size_t kBlockMask = kBlockSize - 1;
+    // Directory segment k holds (1 << kSegmentShift) << k block pointers.
+    static constexpr size_t kSegmentShift = 4;
+    static constexpr size_t kMaxSegments = sizeof(size_t) * 8 - kSegmentShift;
+
+    std::atomic<block_slot*> directory_[kMaxSegments];
+    std::atomic<size_t> size_;
+    // Writer-only state.
+    size_t block_count_;
+    Allocator alloc_;
+
+    static size_t segment_length(size_t segment_idx);
+    const T* block_data(size_t block_idx) const;
+    bv::detail::StorageRun<const T*> iterator_run(size_t index) const;
+    void append_block();
+
+    friend class bv::detail::RunAccess<SingleWriterBlockVector, true>;
+    friend class SingleWriterSnapshot<SingleWriterBlockVector>;
+public:
+    using value_type      = T;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = const T&;
+    using const_reference = const T&;
+    using pointer         = const T*;
+    using const_pointer   = const T*;
+    using allocator_type  = Allocator;
+
+    // Read-only iterator caching a pointer into the current block, resolved
+    // through the directory on first dereference.
+    using const_iterator = bv::IndexIterator<SingleWriterBlockVector, true, bv::detail::RunAccess>;
+    using iterator = const_iterator;
+    using snapshot_type = SingleWriterSnapshot<SingleWriterBlockVector>;
+    using const_segment = bv::BlockSpan<const T>;
+
+    SingleWriterBlockVector();
+    explicit SingleWriterBlockVector(const Allocator& alloc);
+    SingleWriterBlockVector(const SingleWriterBlockVector&) = delete;
+    SingleWriterBlockVector& operator=(const SingleWriterBlockVector&) = delete;
+    ~SingleWriterBlockVector();
+
+    allocator_type get_allocator() const;
+
+    // Reader side (any thread). `index` must be below a value this thread
+    // obtained from size() or snapshot().
+    const T& operator[](size_t index) const;
+    const T& at(size_t index) const;
+    size_t size() const;
+    bool empty() const;
+    snapshot_type snapshot() const;
+    template <typename Func>
+    void for_each_segment(Func&& fn) const;
+    static constexpr size_t block_size() { return kBlockSize; }
+
+    // Writer side (one thread at a time). If the element's constructor
+    // throws, nothing is published.
+    void push_back(const T& value);
+    void push_back(T&& value);
+    template <typename... Args>
+    const T& emplace_back(Args&&... args);
+    void reserve(size_t newCapacity);
+    size_t capacity() const;
+};
+
+// A consistent prefix of a SingleWriterBlockVector: the elements published
+// when the snapshot was taken. Cheap to copy; valid as long as the container.
+template <typename Container>
+class SingleWriterSnapshot {
+    using T = typename Container::value_type;
+
+    const Container* parent_;
+    size_t size_;
+
+public:
+    using value_type     = T;
+    using const_iterator = typename Container::const_iterator;
+    using iterator       = const_iterator;
+
+    SingleWriterSnapshot(const Container* parent, size_t size) : parent_(parent), size_(size) {}
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const T& operator[](size_t index) const { return (*parent_)[index]; }
+    const T& at(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("SingleWriterSnapshot::at");
+        }
+        return (*parent_)[index];
+    }
+    const_iterator begin() const { return const_iterator(0, parent_); }
+    const_iterator end() const { return const_iterator(size_, parent_); }
+
+    // Calls fn(bv::BlockSpan<const T>) for each block, in order.
+    template <typename Func>
+    void for_each_segment(Func&& fn) const {
+        for (size_t first = 0; first < size_; first += Container::kBlockSize) {
+            size_t remaining = size_ - first;
+            size_t count = remaining < Container::kBlockSize ? remaining : Container::kBlockSize;
+            fn(bv::BlockSpan<const T>{parent_->block_data(first >> Container::kBlockShift), count});
+        }
+    }
+};
+
+// SingleWriterBlockVector Definitions
+
+template <typename T, typename Allocator, size_t BlockShift>
+SingleWriterBlockVector<T, Allocator, BlockShift>::SingleWriterBlockVector()
+    : SingleWriterBlockVector(Allocator()) {
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+SingleWriterBlockVector<T, Allocator, BlockShift>::SingleWriterBlockVector(const Allocator& alloc)
+    : size_(0), block_count_(0), alloc_(alloc) {
+    for (size_t k = 0; k < kMaxSegments; ++k) {
+        directory_[k].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+SingleWriterBlockVector<T, Allocator, BlockShift>::~SingleWriterBlockVector() {
+    size_t size = size_.load(std::memory_order_acquire);
+    segment_allocator segment_alloc(alloc_);
+    for (size_t b = 0; b < block_count_; ++b) {
+        T* block = const_cast<T*>(block_data(b));
+        size_t first = b << BlockShift;
+        for (size_t i = first; i < size && i < first + kBlockSize; ++i) {
+            alloc_traits::destroy(alloc_, block + (i & kBlockMask));
+        }
+        alloc_traits::deallocate(alloc_, block, kBlockSize);
+    }
+    for (size_t k = 0; k < kMaxSegments; ++k) {
+        block_slot* segment = directory_[k].load(std::memory_order_relaxed);
+        if (segment == nullptr) {
+            break;
+        }
+        for (size_t i = 0; i < segment_length(k); ++i) {
+            segment[i].~block_slot();
+        }
+        segment_traits::deallocate(segment_alloc, segment, segment_length(k));
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename SingleWriterBlockVector<T, Allocator, BlockShift>::allocator_type
+SingleWriterBlockVector<T, Allocator, BlockShift>::get_allocator() const {
+    return alloc_;
+}
+
+// Relaxed loads are enough: the acquire load of size_ that bounded `index`
+// already made the directory entries and the element visible.
+template <typename T, typename Allocator, size_t BlockShift>
+const T& SingleWriterBlockVector<T, Allocator, BlockShift>::operator[](size_t index) const {
+    return block_data(index >> BlockShift)[index & kBlockMask];
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+const T& SingleWriterBlockVector<T, Allocator, BlockShift>::at(size_t index) const {
+    if (index >= size()) {
+        throw std::out_of_range("SingleWriterBlockVector::at");
+    }
+    return (*this)[index];
+}
+
+// Number of published elements; pairs with the writer's release store.
+template <typename T, typename Allocator, size_t BlockShift>
+size_t SingleWriterBlockVector<T, Allocator, BlockShift>::size() const {
+    return size_.load(std::memory_order_acquire);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+bool SingleWriterBlockVector<T, Allocator, BlockShift>::empty() const {
+    return size() == 0;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename SingleWriterBlockVector<T, Allocator, BlockShift>::snapshot_type
+SingleWriterBlockVector<T, Allocator, BlockShift>::snapshot() const {
+    return snapshot_type(this, size());
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+template <typename Func>
+void SingleWriterBlockVector<T, Allocator, BlockShift>::for_each_segment(Func&& fn) const {
+    snapshot().for_each_segment(std::forward<Func>(fn));
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void SingleWriterBlockVector<T, Allocator, BlockShift>::push_back(const T& value) {
+    emplace_back(value);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void SingleWriterBlockVector<T, Allocator, BlockShift>::push_back(T&& value) {
+    emplace_back(std::move(value));
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+template <typename... Args>
+const T& SingleWriterBlockVector<T, Allocator, BlockShift>::emplace_back(Args&&... args) {
+    size_t index = size_.load(std::memory_order_relaxed);
+    if (index == capacity()) {
+        append_block();
+    }
+    T* element = const_cast<T*>(block_data(index >> BlockShift)) + (index & kBlockMask);
+    alloc_traits::construct(alloc_, element, std::forward<Args>(args)...);
+    size_.store(index + 1, std::memory_order_release);
+    return *element;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void SingleWriterBlockVector<T, Allocator, BlockShift>::reserve(size_t newCapacity) {
+    while (capacity() < newCapacity) {
+        append_block();
+    }
+}
+
+// Writer side only.
+template <typename T, typename Allocator, size_t BlockShift>
+size_t SingleWriterBlockVector<T, Allocator, BlockShift>::capacity() const {
+    return block_count_ << BlockShift;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+size_t SingleWriterBlockVector<T, Allocator, BlockShift>::segment_length(size_t segment_idx) {
+    return (static_cast<size_t>(1) << kSegmentShift) << segment_idx;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+const T* SingleWriterBlockVector<T, Allocator, BlockShift>::block_data(size_t block_idx) const {
+    bv::detail::GeometricSlot slot = bv::detail::geometric_locate(block_idx, kSegmentShift);
+    return directory_[slot.block].load(std::memory_order_relaxed)[slot.offset].load(std::memory_order_relaxed);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+bv::detail::StorageRun<const T*> SingleWriterBlockVector<T, Allocator, BlockShift>::iterator_run(size_t index) const {
+    const T* block = block_data(index >> BlockShift);
+    return {block, block + (index & kBlockMask), block + kBlockSize};
+}
+
+// Installs one more block, opening a new directory segment when the current
+// ones are full. Readers never look at these entries before the size that
+// covers them is published.
+template <typename T, typename Allocator, size_t BlockShift>
+void SingleWriterBlockVector<T, Allocator, BlockShift>::append_block() {
+    bv::detail::GeometricSlot slot = bv::detail::geometric_locate(block_count_, kSegmentShift);
+    block_slot* segment = directory_[slot.block].load(std::memory_order_relaxed);
+    if (segment == nullptr) {
+        segment_allocator segment_alloc(alloc_);
+        segment = segment_traits::allocate(segment_alloc, segment_length(slot.block));
+        for (size_t i = 0; i < segment_length(slot.block); ++i) {
+            ::new (static_cast<void*>(segment + i)) block_slot(nullptr);
+        }
+        directory_[slot.block].store(segment, std::memory_order_release);
+    }
+    segment[slot.offset].store(alloc_traits::allocate(alloc_, kBlockSize), std::memory_order_release);
+    ++block_count_;
+}
@@ -0,0 +1,762 @@
+#pragma once
+#include "BlockVector.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Tiered vector: a block container that supports insert and erase in the
+// middle. Every block is a circular buffer of (1 << BlockShift) elements with
+// its own rotation offset, and every block except the last is full, so
+// element i is still found in O(1):
+//
+//     tier = tiers_[i >> BlockShift];
+//     tier.data[(tier.offset + (i & mask)) & mask]
+//
+// Inserting or erasing k < block-size elements shifts elements inside one
+// block and then, in each later block, only rotates the offset and hands k
+// elements across the boundary: O(block + k * blocks) moves instead of O(n).
+// Whole blocks of a larger range are spliced in or out of the block table.
+//
+// Unlike BlockVector, insert and erase move the elements after the edit, so
+// references and iterators past the edit point are invalidated. Both require a
+// nothrow move constructor; push_back, indexing and iteration do not.
+template <typename T, typename Allocator = std::allocator<T>, size_t BlockShift = 8>
+class TieredVector;
+
+namespace bv {
+namespace detail {
+// Allocator for insert's staging buffer. The array comes from the default
+// heap, so temporaries never use up the container's resource (a monotonic
+// buffer would not get them back), but the elements are constructed through
+// the container's allocator, so moving them into place cannot throw.
+template <typename T, typename Outer>
+struct StagingAllocator {
+    using value_type = T;
+
+    Outer* outer;
+
+    explicit StagingAllocator(Outer* container_alloc) : outer(container_alloc) {}
+    template <typename U>
+    StagingAllocator(const StagingAllocator<U, Outer>& other) : outer(other.outer) {}
+
+    template <typename U>
+    struct rebind { using other = StagingAllocator<U, Outer>; };
+
+    T* allocate(size_t n) { return std::allocator<T>().allocate(n); }
+    void deallocate(T* p, size_t n) { std::allocator<T>().deallocate(p, n); }
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        std::allocator_traits<Outer>::construct(*outer, p, std::forward<Args>(args)...);
+    }
+    template <typename U>
+    void destroy(U* p) {
+        std::allocator_traits<Outer>::destroy(*outer, p);
+    }
+
+    template <typename U>
+    bool operator==(const StagingAllocator<U, Outer>& other) const { return outer == other.outer; }
+    template <typename U>
+    bool operator!=(const StagingAllocator<U, Outer>& other) const { return outer != other.outer; }
+};
+} // namespace detail
+} // namespace bv
+
+template <typename T, typename Allocator, size_t BlockShift>
+class TieredVector {
+private:
+    using alloc_traits = std::allocator_traits<Allocator>;
+    static_assert(std::is_same<typename alloc_traits::value_type, T>::value,
+                  "TieredVector: Allocator::value_type must be T");
+    static_assert(std::is_same<typename alloc_traits::pointer, T*>::value,
+                  "TieredVector: Allocator must hand out raw pointers");
+    static_assert(BlockShift < sizeof(size_t) * 8, "BlockShift out of range");
+
+    static constexpr size_t kBlockSize = static_cast<size_t>(1) << BlockShift;
+    static constexpr size_t kBlockMask = kBlockSize - 1;
+
+    // Block header: logical slot y of the block is data[(offset + y) & mask].
+    struct Tier {
+        T* data;
+        size_t offset;
+    };
+    using tier_allocator = typename alloc_traits::template rebind_alloc<Tier>;
+    using staging_allocator = bv::detail::StagingAllocator<T, Allocator>;
+    using staging_vector = std::vector<T, staging_allocator>;
+
+    // tiers_ holds the used blocks followed by spare (empty) ones. Within a used
+    // block the constructed elements are logical slots [0, used).
+    std::vector<Tier, tier_allocator> tiers_;
+    size_t size_;
+    Allocator alloc_;
+
+    T* slot(size_t block_idx, size_t logical);
+    T* slot_at(size_t index);
+    bv::detail::StorageRun<T*> iterator_run(size_t index) const;
+    size_t used_blocks() const;
+    void ensure_capacity(size_t n);
+    void relocate(T* dst, T* src);
+    void destroy_range(size_t first, size_t last);
+    void release_storage();
+    void steal_from(TieredVector& other) noexcept;
+    void open_gap(size_t pos, size_t count);
+    void open_blocks(size_t pos, size_t blocks);
+    void open_small(size_t pos, size_t count);
+    void close_gap(size_t pos, size_t count);
+    void close_blocks(size_t pos, size_t blocks);
+    void close_small(size_t pos, size_t count);
+    template <typename Construct>
+    size_t insert_constructed(size_t pos, size_t count, Construct construct);
+public:
+    using allocator_type  = Allocator;
+    using value_type      = T;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = T&;
+    using const_reference = const T&;
+    using pointer         = T*;
+    using const_pointer   = const T*;
+
+    // Iterators cache the physically contiguous stretch of the current block.
+    using iterator = bv::IndexIterator<TieredVector, false, bv::detail::RunAccess>;
+    using const_iterator = bv::IndexIterator<TieredVector, true, bv::detail::RunAccess>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    friend class bv::detail::RunAccess<TieredVector, false>;
+    friend class bv::detail::RunAccess<TieredVector, true>;
+    friend struct bv::detail::BlockOwnership;
+
+    TieredVector();
+    explicit TieredVector(const Allocator& alloc);
+    TieredVector(size_t n, const Allocator& alloc = Allocator());
+    TieredVector(size_t n, const T& value, const Allocator& alloc = Allocator());
+    TieredVector(std::initializer_list<T> init, const Allocator& alloc = Allocator());
+    TieredVector(const TieredVector& other);
+    TieredVector(TieredVector&& other) noexcept;
+    TieredVector& operator=(const TieredVector& other);
+    TieredVector& operator=(TieredVector&& other) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value ||
+        alloc_traits::is_always_equal::value);
+    ~TieredVector();
+
+    allocator_type get_allocator() const;
+    void swap(TieredVector& other) noexcept;
+
+    // Element access
+    T& operator[](size_t index);
+    const T& operator[](size_t index) const;
+    T& at(size_t index);
+    const T& at(size_t index) const;
+    T& front();
+    const T& front() const;
+    T& back();
+    const T& back() const;
+
+    // Capacity related
+    size_t size() const;
+    size_t capacity() const;
+    bool empty() const;
+    void reserve(size_t newCapacity);
+    void shrink_to_fit();
+    static constexpr size_t block_size() { return kBlockSize; }
+
+    // manipulation at the end
+    void push_back(const T& value);
+    void push_back(T&& value);
+    template <typename... Args>
+    T& emplace_back(Args&&... args);
+    void pop_back();
+    void clear();
+    void resize(size_t n);
+
+    // manipulation in the middle; the returned iterator points at the first
+    // inserted element, or at the element that followed the erased range.
+    iterator insert(const_iterator pos, const T& value);
+    iterator insert(const_iterator pos, T&& value);
+    iterator insert(const_iterator pos, size_t count, const T& value);
+    template <typename InputIt, typename = bv::detail::enable_if_input_iterator<InputIt>>
+    iterator insert(const_iterator pos, InputIt first, InputIt last);
+    iterator insert(const_iterator pos, std::initializer_list<T> init);
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args);
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+
+    // iterators
+    iterator begin();
+    const_iterator begin() const;
+    const_iterator cbegin() const;
+    iterator end();
+    const_iterator end() const;
+    const_iterator cend() const;
+    reverse_iterator rbegin();
+    const_reverse_iterator rbegin() const;
+    reverse_iterator rend();
+    const_reverse_iterator rend() const;
+};
+
+// TieredVector Definitions
+
+template <typename T, typename Allocator, size_t BlockShift>
+TieredVector<T, Allocator, BlockShift>::TieredVector()
+    : TieredVector(Allocator()) {
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+TieredVector<T, Allocator, BlockShift>::TieredVector(const Allocator& alloc)
+    : tiers_(tier_allocator(alloc)), size_(0), alloc_(alloc) {
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+TieredVector<T, Allocator, BlockShift>::TieredVector(size_t n, const Allocator& alloc)
+    : TieredVector(alloc) {
+    resize(n);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+TieredVector<T, Allocator, BlockShift>::TieredVector(size_t n, const T& value, const Allocator& alloc)
+    : TieredVector(alloc) {
+    reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        emplace_back(value);
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+TieredVector<T, Allocator, BlockShift>::TieredVector(std::initializer_list<T> init, const Allocator& alloc)
+    : TieredVector(alloc) {
+    reserve(init.size());
+    for (const T& value : init) {
+        emplace_back(value);
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+TieredVector<T, Allocator, BlockShift>::TieredVector(const TieredVector& other)
+    : TieredVector(alloc_traits::select_on_container_copy_construction(other.alloc_)) {
+    reserve(other.size_);
+    for (size_t i = 0; i < other.size_; ++i) {
+        emplace_back(other[i]);
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+TieredVector<T, Allocator, BlockShift>::TieredVector(TieredVector&& other) noexcept
+    : TieredVector(std::move(other.alloc_)) {
+    steal_from(other);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+TieredVector<T, Allocator, BlockShift>& TieredVector<T, Allocator, BlockShift>::operator=(const TieredVector& other) {
+    if (this == &other) {
+        return *this;
+    }
+    bv::detail::BlockOwnership::copy_allocator(*this, other);
+    clear();
+    reserve(other.size_);
+    for (size_t i = 0; i < other.size_; ++i) {
+        emplace_back(other[i]);
+    }
+    return *this;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+TieredVector<T, Allocator, BlockShift>& TieredVector<T, Allocator, BlockShift>::operator=(TieredVector&& other) noexcept(
+    alloc_traits::propagate_on_container_move_assignment::value ||
+    alloc_traits::is_always_equal::value) {
+    if (this == &other) {
+        return *this;
+    }
+    if (bv::detail::BlockOwnership::move_storage(*this, other)) {
+        return *this;
+    }
+    clear();
+    reserve(other.size_);
+    for (size_t i = 0; i < other.size_; ++i) {
+        emplace_back(std::move(other[i]));
+    }
+    other.clear();
+    return *this;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+TieredVector<T, Allocator, BlockShift>::~TieredVector() {
+    release_storage();
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename TieredVector<T, Allocator, BlockShift>::allocator_type TieredVector<T, Allocator, BlockShift>::get_allocator() const {
+    return alloc_;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void TieredVector<T, Allocator, BlockShift>::swap(TieredVector& other) noexcept {
+    using std::swap;
+    tiers_.swap(other.tiers_);
+    swap(size_, other.size_);
+    bv::detail::BlockOwnership::swap_allocators(*this, other);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void swap(TieredVector<T, Allocator, BlockShift>& a, TieredVector<T, Allocator, BlockShift>& b) noexcept {
+    a.swap(b);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+T& TieredVector<T, Allocator, BlockShift>::operator[](size_t index) {
+    const Tier& tier = tiers_[index >> BlockShift];
+    return tier.data[(tier.offset + index) & kBlockMask];
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+const T& TieredVector<T, Allocator, BlockShift>::operator[](size_t index) const {
+    const Tier& tier = tiers_[index >> BlockShift];
+    return tier.data[(tier.offset + index) & kBlockMask];
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+T& TieredVector<T, Allocator, BlockShift>::at(size_t index) {
+    if (index >= size_) {
+        throw std::out_of_range("TieredVector::at");
+    }
+    return (*this)[index];
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+const T& TieredVector<T, Allocator, BlockShift>::at(size_t index) const {
+    if (index >= size_) {
+        throw std::out_of_range("TieredVector::at");
+    }
+    return (*this)[index];
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+T& TieredVector<T, Allocator, BlockShift>::front() {
+    return (*this)[0];
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+const T& TieredVector<T, Allocator, BlockShift>::front() const {
+    return (*this)[0];
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+T& TieredVector<T, Allocator, BlockShift>::back() {
+    return (*this)[size_ - 1];
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+const T& TieredVector<T, Allocator, BlockShift>::back() const {
+    return (*this)[size_ - 1];
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+size_t TieredVector<T, Allocator, BlockShift>::size() const {
+    return size_;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+size_t TieredVector<T, Allocator, BlockShift>::capacity() const {
+    return tiers_.size() << BlockShift;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+bool TieredVector<T, Allocator, BlockShift>::empty() const {
+    return size_ == 0;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void TieredVector<T, Allocator, BlockShift>::reserve(size_t newCapacity) {
+    ensure_capacity(newCapacity);
+}
+
+// Releases the spare blocks past the last element.
+template <typename T, typename Allocator, size_t BlockShift>
+void TieredVector<T, Allocator, BlockShift>::shrink_to_fit() {
+    size_t keep = used_blocks();
+    while (tiers_.size() > keep) {
+        alloc_traits::deallocate(alloc_, tiers_.back().data, kBlockSize);
+        tiers_.pop_back();
+    }
+    tiers_.shrink_to_fit();
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void TieredVector<T, Allocator, BlockShift>::push_back(const T& value) {
+    emplace_back(value);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void TieredVector<T, Allocator, BlockShift>::push_back(T&& value) {
+    emplace_back(std::move(value));
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+template <typename... Args>
+T& TieredVector<T, Allocator, BlockShift>::emplace_back(Args&&... args) {
+    ensure_capacity(size_ + 1);
+    T* element = slot_at(size_);
+    alloc_traits::construct(alloc_, element, std::forward<Args>(args)...);
+    ++size_;
+    return *element;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void TieredVector<T, Allocator, BlockShift>::pop_back() {
+    if (size_ == 0) {
+        return;
+    }
+    --size_;
+    alloc_traits::destroy(alloc_, slot_at(size_));
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void TieredVector<T, Allocator, BlockShift>::clear() {
+    destroy_range(0, size_);
+    size_ = 0;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void TieredVector<T, Allocator, BlockShift>::resize(size_t n) {
+    if (n < size_) {
+        destroy_range(n, size_);
+        size_ = n;
+        return;
+    }
+    reserve(n);
+    while (size_ < n) {
+        emplace_back();
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename TieredVector<T, Allocator, BlockShift>::iterator
+TieredVector<T, Allocator, BlockShift>::insert(const_iterator pos, const T& value) {
+    return emplace(pos, value);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename TieredVector<T, Allocator, BlockShift>::iterator
+TieredVector<T, Allocator, BlockShift>::insert(const_iterator pos, T&& value) {
+    return emplace(pos, std::move(value));
+}
+
+// The copies are made before any element moves, so `value` may refer into
+// this container and a throwing copy constructor leaves it unchanged.
+template <typename T, typename Allocator, size_t BlockShift>
+typename TieredVector<T, Allocator, BlockShift>::iterator
+TieredVector<T, Allocator, BlockShift>::insert(const_iterator pos, size_t count, const T& value) {
+    staging_vector staged(count, value, staging_allocator(&alloc_));
+    return iterator(insert_constructed(pos.index(), count, [&](T* dst, size_t i) {
+        alloc_traits::construct(alloc_, dst, std::move(staged[i]));
+    }), this);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+template <typename InputIt, typename>
+typename TieredVector<T, Allocator, BlockShift>::iterator
+TieredVector<T, Allocator, BlockShift>::insert(const_iterator pos, InputIt first, InputIt last) {
+    staging_vector staged(first, last, staging_allocator(&alloc_));
+    return iterator(insert_constructed(pos.index(), staged.size(), [&](T* dst, size_t i) {
+        alloc_traits::construct(alloc_, dst, std::move(staged[i]));
+    }), this);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename TieredVector<T, Allocator, BlockShift>::iterator
+TieredVector<T, Allocator, BlockShift>::insert(const_iterator pos, std::initializer_list<T> init) {
+    return insert(pos, init.begin(), init.end());
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+template <typename... Args>
+typename TieredVector<T, Allocator, BlockShift>::iterator
+TieredVector<T, Allocator, BlockShift>::emplace(const_iterator pos, Args&&... args) {
+    size_t index = pos.index();
+    if (index == size_) {
+        emplace_back(std::forward<Args>(args)...);
+        return iterator(index, this);
+    }
+    T value(std::forward<Args>(args)...);
+    insert_constructed(index, 1, [&](T* dst, size_t) {
+        alloc_traits::construct(alloc_, dst, std::move(value));
+    });
+    return iterator(index, this);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename TieredVector<T, Allocator, BlockShift>::iterator
+TieredVector<T, Allocator, BlockShift>::erase(const_iterator pos) {
+    return erase(pos, pos + 1);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename TieredVector<T, Allocator, BlockShift>::iterator
+TieredVector<T, Allocator, BlockShift>::erase(const_iterator first, const_iterator last) {
+    size_t from = first.index();
+    size_t count = last.index() - from;
+    if (count != 0) {
+        destroy_range(from, from + count);
+        close_gap(from, count);
+    }
+    return iterator(from, this);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename TieredVector<T, Allocator, BlockShift>::iterator TieredVector<T, Allocator, BlockShift>::begin() {
+    return iterator(0, this);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename TieredVector<T, Allocator, BlockShift>::const_iterator TieredVector<T, Allocator, BlockShift>::begin() const {
+    return const_iterator(0, this);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename TieredVector<T, Allocator, BlockShift>::const_iterator TieredVector<T, Allocator, BlockShift>::cbegin() const {
+    return begin();
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename TieredVector<T, Allocator, BlockShift>::iterator TieredVector<T, Allocator, BlockShift>::end() {
+    return iterator(size_, this);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename TieredVector<T, Allocator, BlockShift>::const_iterator TieredVector<T, Allocator, BlockShift>::end() const {
+    return const_iterator(size_, this);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename TieredVector<T, Allocator, BlockShift>::const_iterator TieredVector<T, Allocator, BlockShift>::cend() const {
+    return end();
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename TieredVector<T, Allocator, BlockShift>::reverse_iterator TieredVector<T, Allocator, BlockShift>::rbegin() {
+    return reverse_iterator(end());
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename TieredVector<T, Allocator, BlockShift>::const_reverse_iterator TieredVector<T, Allocator, BlockShift>::rbegin() const {
+    return const_reverse_iterator(end());
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename TieredVector<T, Allocator, BlockShift>::reverse_iterator TieredVector<T, Allocator, BlockShift>::rend() {
+    return reverse_iterator(begin());
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+typename TieredVector<T, Allocator, BlockShift>::const_reverse_iterator TieredVector<T, Allocator, BlockShift>::rend() const {
+    return const_reverse_iterator(begin());
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+T* TieredVector<T, Allocator, BlockShift>::slot(size_t block_idx, size_t logical) {
+    const Tier& tier = tiers_[block_idx];
+    return tier.data + ((tier.offset + logical) & kBlockMask);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+T* TieredVector<T, Allocator, BlockShift>::slot_at(size_t index) {
+    return slot(index >> BlockShift, index & kBlockMask);
+}
+
+// The slots around `index` that are adjacent both logically and in the
+// block's ring buffer: up to the wrap point or the block edge, whichever
+// comes first in each direction.
+template <typename T, typename Allocator, size_t BlockShift>
+bv::detail::StorageRun<T*> TieredVector<T, Allocator, BlockShift>::iterator_run(size_t index) const {
+    const Tier& tier = tiers_[index >> BlockShift];
+    size_t logical = index & kBlockMask;
+    size_t physical = (tier.offset + logical) & kBlockMask;
+    size_t before = logical < physical ? logical : physical;
+    size_t after = kBlockSize - (logical > physical ? logical : physical);
+    T* element = tier.data + physical;
+    return {element - before, element, element + after};
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+size_t TieredVector<T, Allocator, BlockShift>::used_blocks() const {
+    return (size_ + kBlockMask) >> BlockShift;
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void TieredVector<T, Allocator, BlockShift>::ensure_capacity(size_t n) {
+    size_t blocks = (n + kBlockMask) >> BlockShift;
+    if (blocks <= tiers_.size()) {
+        return;
+    }
+    tiers_.reserve(blocks);
+    while (tiers_.size() < blocks) {
+        tiers_.push_back(Tier{alloc_traits::allocate(alloc_, kBlockSize), 0});
+    }
+}
+
+// Moves an element into raw storage and ends the source's lifetime.
+template <typename T, typename Allocator, size_t BlockShift>
+void TieredVector<T, Allocator, BlockShift>::relocate(T* dst, T* src) {
+    static_assert(std::is_nothrow_move_constructible<T>::value,
+                  "TieredVector: insert and erase require a nothrow move constructor");
+    alloc_traits::construct(alloc_, dst, std::move(*src));
+    alloc_traits::destroy(alloc_, src);
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void TieredVector<T, Allocator, BlockShift>::destroy_range(size_t first, size_t last) {
+    if (std::is_trivially_destructible<T>::value) {
+        return;
+    }
+    for (size_t i = first; i < last; ++i) {
+        alloc_traits::destroy(alloc_, slot_at(i));
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void TieredVector<T, Allocator, BlockShift>::release_storage() {
+    destroy_range(0, size_);
+    size_ = 0;
+    for (const Tier& tier : tiers_) {
+        alloc_traits::deallocate(alloc_, tier.data, kBlockSize);
+    }
+    tiers_.clear();
+}
+
+template <typename T, typename Allocator, size_t BlockShift>
+void TieredVector<T, Allocator, BlockShift>::steal_from(TieredVector& other) noexcept {
+    tiers_.swap(other.tiers_);
+    size_ = other.size_;
+    other.size_ = 0;
+}
+
+// Makes room for `count` elements at `pos`, constructs them with
+// construct(slot, i) (which must not throw) and returns `pos`.
+template <typename T, typename Allocator, size_t BlockShift>
+template <typename Construct>
+size_t TieredVector<T, Allocator, BlockShift>::insert_constructed(size_t pos, size_t count, Construct construct) {
+    if (count == 0) {
+        return pos;
+    }
+    ensure_capacity(size_ + count);
+    open_gap(pos, count);
+    for (size_t i = 0; i < count; ++i) {
+        construct(slot_at(pos + i), i);
+    }
+    return pos;
+}
+
+// Shifts [pos, size_) right by `count`, leaving [pos, pos + count) as raw
+// slots, and grows size_. Capacity must already cover the new size.
+template <typename T, typename Allocator, size_t BlockShift>
+void TieredVector<T, Allocator, BlockShift>::open_gap(size_t pos, size_t count) {
+    size_t blocks = count >> BlockShift;
+    if (blocks != 0) {
+        open_blocks(pos, blocks);
+    }
+    if ((count & kBlockMask) != 0) {
+        open_small(pos + (blocks << BlockShift), count & kBlockMask);
+    }
+}
+
+// Splices `blocks` spare blocks into the table in front of the block holding
+// `pos`; that block's elements before `pos` move into the first new block.
+template <typename T, typename Allocator, size_t BlockShift>
+void TieredVector<T, Allocator, BlockShift>::open_blocks(size_t pos, size_t blocks) {
+    size_t block_idx = pos >> BlockShift;
+    size_t head = pos & kBlockMask;
+    size_t used = used_blocks();
+    std::rotate(tiers_.begin() + block_idx, tiers_.begin() + used, tiers_.begin() + used + blocks);
+    for (size_t y = 0; y < head; ++y) {
+        relocate(slot(block_idx, y), slot(block_idx + blocks, y));
+    }
+    size_ += blocks << BlockShift;
+}
+
+// Gap of count < block size: every block after the one holding `pos` rotates
+// right by `count` and takes `count` elements from the end of its
+// predecessor; the first block shifts its own tail. Walks from the back so
+// each element is moved exactly once.
+template <typename T, typename Allocator, size_t BlockShift>
+void TieredVector<T, Allocator, BlockShift>::open_small(size_t pos, size_t count) {
+    size_t new_size = size_ + count;
+    size_t first_block = pos >> BlockShift;
+    size_t last_block = (new_size - 1) >> BlockShift;
+    for (size_t j = last_block; j > first_block; --j) {
+        size_t base = j << BlockShift;
+        size_t new_used = std::min(kBlockSize, new_size - base);
+        tiers_[j].offset = (tiers_[j].offset - count) & kBlockMask;
+        size_t pull = std::min(count, new_used);
+        for (size_t y = 0; y < pull; ++y) {
+            if (base + y >= pos + count) {
+                relocate(slot(j, y), slot(j - 1, kBlockSize - count + y));
+            }
+        }
+    }
+    size_t base = first_block << BlockShift;
+    size_t new_used = std::min(kBlockSize, new_size - base);
+    for (size_t y = new_used; y-- > pos - base + count;) {
+        relocate(slot(first_block, y), slot(first_block, y - count));
+    }
+    size_ = new_size;
+}
+
+// Removes the raw slots [pos, pos + count) by shifting the elements after
+// them left.
+template <typename T, typename Allocator, size_t BlockShift>
+void TieredVector<T, Allocator, BlockShift>::close_gap(size_t pos, size_t count) {
+    size_t blocks = count >> BlockShift;
+    if (blocks != 0) {
+        close_blocks(pos, blocks);
+    }
+    if ((count & kBlockMask) != 0) {
+        close_small(pos, count & kBlockMask);
+    }
+}
+
+// The block holding `pos` hands its elements before `pos` to the block
+// `blocks` further on; the emptied blocks move to the spare end of the table.
+template <typename T, typename Allocator, size_t BlockShift>
+void TieredVector<T, Allocator, BlockShift>::close_blocks(size_t pos, size_t blocks) {
+    size_t block_idx = pos >> BlockShift;
+    size_t head = pos & kBlockMask;
+    for (size_t y = 0; y < head; ++y) {
+        relocate(slot(block_idx + blocks, y), slot(block_idx, y));
+    }
+    std::rotate(tiers_.begin() + block_idx, tiers_.begin() + block_idx + blocks, tiers_.begin() + used_blocks());
+    size_ -= blocks << BlockShift;
+}
+
+// Mirror of open_small: the first block shifts its tail left, and every later
+// block gives its first `count` elements to its predecessor and rotates left.
+template <typename T, typename Allocator, size_t BlockShift>
+void TieredVector<T, Allocator, BlockShift>::close_small(size_t pos, size_t count) {
+    size_t new_size = size_ - count;
+    size_t first_block = pos >> BlockShift;
+    size_t base = first_block << BlockShift;
+    size_t limit = std::min(kBlockSize, new_size - base);
+    for (size_t y = pos - base; y < limit; ++y) {
+        relocate(slot(first_block, y), slot_at(base + y + count));
+    }
+    size_t last_block = (size_ - 1) >> BlockShift;
+    for (size_t j = first_block + 1; j <= last_block; ++j) {
+        size_t jbase = j << BlockShift;
+        tiers_[j].offset = (tiers_[j].offset + count) & kBlockMask;
+        if (new_size <= jbase) {
+            break;
+        }
+        size_t new_used = std::min(kBlockSize, new_size - jbase);
+        for (size_t y = kBlockSize - count; y < new_used; ++y) {
+            relocate(slot(j, y), slot(j + 1, y - (kBlockSize - count)));
+        }
+    }
+    size_ = new_size;
+}
@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+#include "BlockVector.hpp"
+#include <memory_resource>
+#include <string>
+
+namespace {
+// Stateful allocator that records how many bytes are live per arena id.
+template <typename T, bool Propagate>
+struct ArenaAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::integral_constant<bool, Propagate>;
+    using propagate_on_container_move_assignment = std::integral_constant<bool, Propagate>;
+    using propagate_on_container_swap = std::integral_constant<bool, Propagate>;
+
+    int id;
+    long* live;
+
+    ArenaAllocator(int arena_id, long* counter) : id(arena_id), live(counter) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U, Propagate>& other) : id(other.id), live(other.live) {}
+
+    template <typename U>
+    struct rebind { using other = ArenaAllocator<U, Propagate>; };
+
+    T* allocate(size_t n) {
+        *live += static_cast<long>(n * sizeof(T));
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, size_t n) {
+        *live -= static_cast<long>(n * sizeof(T));
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U, Propagate>& other) const { return id == other.id; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U, Propagate>& other) const { return id != other.id; }
+};
+}
+
+TEST(BlockVectorAllocator, BlocksAndTableComeFromAllocator) {
+    long live = 0;
+    {
+        using Alloc = ArenaAllocator<int, false>;
+        BlockVector<int, Alloc> bv(Alloc(1, &live));
+        for (int i = 0; i < 5000; ++i) {
+            bv.push_back(i);
+        }
+        EXPECT_GE(live, static_cast<long>(5000 * sizeof(int)));
+        EXPECT_EQ(bv.get_allocator().id, 1);
+    }
+    EXPECT_EQ(live, 0);
+}
+
+TEST(BlockVectorAllocator, PropagatingAllocatorFollowsCopyAndMove) {
+    long live_a = 0;
+    long live_b = 0;
+    using Alloc = ArenaAllocator<int, true>;
+    {
+        BlockVector<int, Alloc> a(Alloc(1, &live_a));
+        BlockVector<int, Alloc> b(Alloc(2, &live_b));
+        for (int i = 0; i < 1000; ++i) {
+            a.push_back(i);
+        }
+        b = a;
+        EXPECT_EQ(b.get_allocator().id, 1);
+        EXPECT_EQ(b[999], 999);
+
+        BlockVector<int, Alloc> c(Alloc(2, &live_b));
+        c = std::move(a);
+        EXPECT_EQ(c.get_allocator().id, 1);
+        EXPECT_EQ(c.size(), 1000u);
+        EXPECT_TRUE(a.empty());
+
+        BlockVector<int, Alloc> d(Alloc(2, &live_b));
+        d.push_back(42);
+        swap(c, d);
+        EXPECT_EQ(c.get_allocator().id, 2);
+        EXPECT_EQ(d.get_allocator().id, 1);
+        EXPECT_EQ(c[0], 42);
+        EXPECT_EQ(d[500], 500);
+    }
+    EXPECT_EQ(live_a, 0);
+    EXPECT_EQ(live_b, 0);
+}
+
+TEST(BlockVectorAllocator, NonPropagatingMoveCopiesIntoOwnArena) {
+    long live_a = 0;
+    long live_b = 0;
+    using Alloc = ArenaAllocator<int, false>;
+    {
+        BlockVector<int, Alloc> a(Alloc(1, &live_a));
+        for (int i = 0; i < 1000; ++i) {
+            a.push_back(i);
+        }
+        BlockVector<int, Alloc> b(Alloc(2, &live_b));
+        b = std::move(a);
+        EXPECT_EQ(b.get_allocator().id, 2);
+        EXPECT_EQ(b.size(), 1000u);
+        EXPECT_EQ(b[123], 123);
+        EXPECT_GT(live_b, 0);
+
+        BlockVector<int, Alloc> c(std::move(b), Alloc(1, &live_a));
+        EXPECT_EQ(c.get_allocator().id, 1);
+        EXPECT_EQ(c[999], 999);
+    }
+    EXPECT_EQ(live_a, 0);
+    EXPECT_EQ(live_b, 0);
+}
+
+TEST(BlockVectorAllocator, PmrMonotonicBuffer) {
+    std::pmr::monotonic_buffer_resource arena;
+    pmr::BlockVector<std::pmr::string> bv(&arena);
+    for (int i = 0; i < 2000; ++i) {
+        bv.emplace_back("a string that is too long for the small buffer " + std::to_string(i));
+    }
+    EXPECT_EQ(bv.size(), 2000u);
+    EXPECT_EQ(bv.get_allocator().resource(), &arena);
+    // Elements are constructed with the container's allocator (uses-allocator construction).
+    EXPECT_EQ(bv[1999].get_allocator().resource(), &arena);
+
+    pmr::BlockVector<std::pmr::string> copy(bv);
+    EXPECT_EQ(copy.get_allocator().resource(), std::pmr::get_default_resource());
+    EXPECT_EQ(copy[10], bv[10]);
+}
+
+namespace {
+// memory_resource that tracks its live bytes, so a block returned to the
+// wrong resource shows up as a count that never reaches zero.
+class CountingResource : public std::pmr::memory_resource {
+public:
+    long live = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t align) override {
+        live += static_cast<long>(bytes);
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t align) override {
+        live -= static_cast<long>(bytes);
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+pmr::BlockVector<std::pmr::string> make_strings(std::pmr::memory_resource* r, int n) {
+    pmr::BlockVector<std::pmr::string> bv(r);
+    for (int i = 0; i < n; ++i) {
+        bv.emplace_back(std::to_string(i) + std::string(40, 'x'));
+    }
+    return bv;
+}
+}
+
+TEST(BlockVectorAllocator, PmrCopyAssignKeepsOwnResource) {
+    CountingResource r1;
+    CountingResource r2;
+    {
+        auto a = make_strings(&r1, 300);
+        auto same = make_strings(&r1, 10);
+        auto other = make_strings(&r2, 2000);
+        same = a;
+        other = a;
+        EXPECT_EQ(same.get_allocator().resource(), &r1);
+        EXPECT_EQ(other.get_allocator().resource(), &r2);
+        ASSERT_EQ(other.size(), 300u);
+        EXPECT_EQ(other[299], a[299]);
+        EXPECT_EQ(other[299].get_allocator().resource(), &r2);
+        EXPECT_EQ(same[0], a[0]);
+    }
+    EXPECT_EQ(r1.live, 0);
+    EXPECT_EQ(r2.live, 0);
+}
+
+TEST(BlockVectorAllocator, PmrMoveAssignEqualAndUnequalResources) {
+    CountingResource r1;
+    CountingResource r2;
+    {
+        auto a = make_strings(&r1, 300);
+        auto same = make_strings(&r1, 5);
+        same = std::move(a);
+        EXPECT_EQ(same.size(), 300u);
+        EXPECT_TRUE(a.empty());
+
+        auto other = make_strings(&r2, 5);
+        other = std::move(same);
+        EXPECT_EQ(other.get_allocator().resource(), &r2);
+        ASSERT_EQ(other.size(), 300u);
+        EXPECT_STREQ(other[123].c_str(), (std::to_string(123) + std::string(40, 'x')).c_str());
+        EXPECT_EQ(other[123].get_allocator().resource(), &r2);
+        EXPECT_TRUE(same.empty());
+    }
+    EXPECT_EQ(r1.live, 0);
+    EXPECT_EQ(r2.live, 0);
+}
+
+TEST(BlockVectorAllocator, PmrSwapEqualResources) {
+    CountingResource r1;
+    {
+        auto a = make_strings(&r1, 300);
+        auto b = make_strings(&r1, 3);
+        a.swap(b);
+        EXPECT_EQ(a.size(), 3u);
+        EXPECT_EQ(b.size(), 300u);
+        swap(a, b);
+        EXPECT_EQ(a.size(), 300u);
+        EXPECT_EQ(a.get_allocator().resource(), &r1);
+    }
+    EXPECT_EQ(r1.live, 0);
+}
+
+// Unequal non-propagating allocators make swap undefined, so this only pins
+// down that swap between different resources still compiles and keeps each
+// container's own resource; the contents stay where they were allocated.
+TEST(BlockVectorAllocator, PmrSwapUnequalResourcesKeepsAllocators) {
+    CountingResource r1;
+    CountingResource r2;
+    {
+        pmr::BlockVector<int> a(&r1);
+        pmr::BlockVector<int> b(&r2);
+        a.swap(b);
+        EXPECT_EQ(a.get_allocator().resource(), &r1);
+        EXPECT_EQ(b.get_allocator().resource(), &r2);
+    }
+    EXPECT_EQ(r1.live, 0);
+    EXPECT_EQ(r2.live, 0);
+}
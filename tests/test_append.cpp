@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include "BlockVector.hpp"
+#include <list>
+#include <sstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+TEST(BlockVectorAppend, PointerRangeSpansBlocks) {
+    FixedBlockVector<int, 4> bv;
+    bv.push_back(-1);
+    std::vector<int> source(100);
+    for (int i = 0; i < 100; ++i) {
+        source[i] = i;
+    }
+    bv.append(source.data(), source.data() + source.size());
+    ASSERT_EQ(bv.size(), 101u);
+    EXPECT_EQ(bv.capacity(), 112u);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(bv[i + 1], i);
+    }
+
+    bv.append_n(source.data() + 90, 10);
+    EXPECT_EQ(bv.size(), 111u);
+    EXPECT_EQ(bv.back(), 99);
+}
+
+TEST(BlockVectorAppend, ContiguousRangeAndInitList) {
+    BlockVector<double> bv;
+    std::vector<double> batch(700, 1.5);
+    bv.append(batch);
+    bv.append({2.5, 3.5});
+    ASSERT_EQ(bv.size(), 702u);
+    EXPECT_EQ(bv[699], 1.5);
+    EXPECT_EQ(bv[701], 3.5);
+
+    // A segment of another BlockVector is a contiguous range as well.
+    BlockVector<double> copy;
+    for (auto seg : bv.segments()) {
+        copy.append(seg);
+    }
+    EXPECT_EQ(copy.size(), bv.size());
+    EXPECT_EQ(copy[700], 2.5);
+}
+
+TEST(BlockVectorAppend, ContiguousIteratorsSpanBlocks) {
+    static_assert(bv::detail::is_contiguous_iterator<std::vector<int>::iterator>::value, "");
+    static_assert(bv::detail::is_contiguous_iterator<std::vector<int>::const_iterator>::value, "");
+    static_assert(!bv::detail::is_contiguous_iterator<std::vector<bool>::iterator>::value, "");
+    static_assert(!bv::detail::is_contiguous_iterator<std::list<int>::iterator>::value, "");
+    static_assert(!bv::detail::is_contiguous_iterator<std::reverse_iterator<int*>>::value, "");
+
+    FixedBlockVector<int, 4> bv = {-1, -2, -3};
+    std::vector<int> source(100);
+    for (int i = 0; i < 100; ++i) {
+        source[i] = i;
+    }
+    bv.append(source.begin(), source.end());
+    bv.append(source.cbegin() + 90, source.cend());
+    ASSERT_EQ(bv.size(), 113u);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(bv[i + 3], i);
+    }
+    EXPECT_EQ(bv[103], 90);
+    EXPECT_EQ(bv.back(), 99);
+
+    bv.assign(source.rbegin(), source.rend());
+    ASSERT_EQ(bv.size(), 100u);
+    EXPECT_EQ(bv.front(), 99);
+
+    std::vector<bool> flags = {true, false, true};
+    BlockVector<bool> bits;
+    bits.append(flags.begin(), flags.end());
+    ASSERT_EQ(bits.size(), 3u);
+    EXPECT_FALSE(bits[1]);
+}
+
+TEST(BlockVectorAppend, NonTrivialAndSinglePassSources) {
+    BlockVector<std::string> bv;
+    std::list<std::string> words = {"a", "bb", "ccc"};
+    bv.append(words.begin(), words.end());
+    ASSERT_EQ(bv.size(), 3u);
+    EXPECT_EQ(bv[2], "ccc");
+
+    std::istringstream in("1 2 3 4 5");
+    BlockVector<int> ints;
+    ints.append(std::istream_iterator<int>(in), std::istream_iterator<int>());
+    ASSERT_EQ(ints.size(), 5u);
+    EXPECT_EQ(ints[4], 5);
+}
+
+TEST(BlockVectorAppend, SelfAppend) {
+    FixedBlockVector<int, 3> bv = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    bv.append(bv.begin(), bv.end());
+    ASSERT_EQ(bv.size(), 20u);
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_EQ(bv[i], i % 10 + 1);
+    }
+}
+
+TEST(BlockVectorAppend, Assign) {
+    BlockVector<std::string> bv = {"x", "y"};
+    bv.assign(3, "z");
+    ASSERT_EQ(bv.size(), 3u);
+    EXPECT_EQ(bv[2], "z");
+
+    std::vector<std::string> source = {"p", "q"};
+    bv.assign(source.begin(), source.end());
+    ASSERT_EQ(bv.size(), 2u);
+    EXPECT_EQ(bv[1], "q");
+
+    bv.assign({"only"});
+    ASSERT_EQ(bv.size(), 1u);
+    EXPECT_EQ(bv.front(), "only");
+}
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include "BlockVector.hpp"
+#include <cstdint>
+#include <string>
+
+namespace {
+struct Tracked {
+    static int live;
+    int value;
+    Tracked(int v = 0) : value(v) { ++live; }
+    Tracked(const Tracked& other) : value(other.value) { ++live; }
+    ~Tracked() { --live; }
+};
+int Tracked::live = 0;
+
+struct alignas(64) OverAligned {
+    int value;
+};
+}
+
+TEST(BlockStorageTest, ReserveThenPushBackKeepsOrder) {
+    BlockVector<int> bv;
+    bv.reserve(bv.get_Block_size() * 3);
+    const size_t n = bv.get_Block_size() * 3 + 7;
+    for (size_t i = 0; i < n; ++i) {
+        bv.push_back(static_cast<int>(i));
+    }
+    ASSERT_EQ(bv.size(), n);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_EQ(bv[i], static_cast<int>(i));
+    }
+    size_t count = 0;
+    for (int v : bv) {
+        EXPECT_EQ(v, static_cast<int>(count));
+        ++count;
+    }
+    EXPECT_EQ(count, n);
+}
+
+TEST(BlockStorageTest, ElementsAreConstructedAndDestroyedExactlyOnce) {
+    Tracked::live = 0;
+    {
+        BlockVector<Tracked> bv;
+        for (int i = 0; i < 1000; ++i) {
+            bv.emplace_back(i);
+        }
+        EXPECT_EQ(Tracked::live, 1000);
+        bv.resize(300);
+        EXPECT_EQ(Tracked::live, 300);
+        bv.pop_back();
+        EXPECT_EQ(Tracked::live, 299);
+        bv.resize(600);
+        EXPECT_EQ(Tracked::live, 600);
+        bv.clear();
+        EXPECT_EQ(Tracked::live, 0);
+        bv.push_back(Tracked(7));
+        EXPECT_EQ(Tracked::live, 1);
+    }
+    EXPECT_EQ(Tracked::live, 0);
+}
+
+TEST(BlockStorageTest, BlocksAreAligned) {
+    BlockVector<OverAligned> bv;
+    for (int i = 0; i < 600; ++i) {
+        bv.push_back(OverAligned{i});
+    }
+    for (size_t i = 0; i < bv.size(); ++i) {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&bv[i]) % alignof(OverAligned), 0u);
+        EXPECT_EQ(bv[i].value, static_cast<int>(i));
+    }
+}
+
+TEST(BlockStorageTest, CopyIsDeep) {
+    BlockVector<std::string> a;
+    for (int i = 0; i < 700; ++i) {
+        a.push_back(std::to_string(i));
+    }
+    BlockVector<std::string> b(a);
+    ASSERT_EQ(b.size(), a.size());
+    EXPECT_NE(&a[0], &b[0]);
+    b[5] = "changed";
+    EXPECT_EQ(a[5], "5");
+
+    BlockVector<std::string> c = {"x"};
+    c = a;
+    ASSERT_EQ(c.size(), a.size());
+    EXPECT_EQ(c[699], "699");
+}
+
+TEST(BlockStorageTest, PopBackReleasesEmptyTailBlock) {
+    BlockVector<int> bv;
+    bv.set_max_spare_blocks(0);
+    const size_t block = bv.get_Block_size();
+    for (size_t i = 0; i < block * 2 + 1; ++i) {
+        bv.push_back(static_cast<int>(i));
+    }
+    EXPECT_EQ(bv.capacity(), block * 3);
+    bv.pop_back();
+    EXPECT_EQ(bv.capacity(), block * 2);
+    EXPECT_EQ(bv.back(), static_cast<int>(block * 2 - 1));
+}
+
+TEST(BlockStorageTest, SpareBlockIsReusedAcrossBoundary) {
+    BlockVector<int> bv;
+    const size_t block = bv.get_Block_size();
+    EXPECT_EQ(bv.max_spare_blocks(), 1u);
+    for (size_t i = 0; i < block * 2 + 1; ++i) {
+        bv.push_back(static_cast<int>(i));
+    }
+    int* tail = &bv.back();
+    bv.pop_back();
+    EXPECT_EQ(bv.capacity(), block * 3);
+    bv.push_back(42);
+    EXPECT_EQ(&bv.back(), tail);
+
+    // A second empty block exceeds the limit and is released.
+    for (size_t i = 0; i < block; ++i) {
+        bv.pop_back();
+    }
+    EXPECT_EQ(bv.capacity(), block * 3);
+    bv.pop_back();
+    EXPECT_EQ(bv.capacity(), block * 2);
+}
+
+TEST(BlockStorageTest, ResizeKeepsSpareBlocksUpToLimit) {
+    BlockVector<int> bv;
+    const size_t block = bv.get_Block_size();
+    bv.set_max_spare_blocks(2);
+    bv.resize(block * 6);
+    bv.resize(block);
+    EXPECT_EQ(bv.capacity(), block * 3);
+
+    bv.set_max_spare_blocks(1);
+    EXPECT_EQ(bv.capacity(), block * 2);
+}
+
+TEST(BlockStorageTest, ShrinkToFitReleasesSpareBlocks) {
+    BlockVector<int> bv;
+    const size_t block = bv.get_Block_size();
+    bv.reserve(block * 4);
+    for (size_t i = 0; i < block + 3; ++i) {
+        bv.push_back(static_cast<int>(i));
+    }
+    bv.shrink_to_fit();
+    EXPECT_EQ(bv.capacity(), block * 2);
+    EXPECT_EQ(bv[block + 2], static_cast<int>(block + 2));
+
+    bv.clear();
+    bv.shrink_to_fit();
+    EXPECT_EQ(bv.capacity(), 0u);
+    bv.push_back(7);
+    EXPECT_EQ(bv.front(), 7);
+}
+
+TEST(BlockStorageTest, ResizeDefaultInit) {
+    BlockVector<uint64_t> bv = {7, 8};
+    const size_t block = bv.get_Block_size();
+    bv.resize_default_init(block * 3 + 5);
+    ASSERT_EQ(bv.size(), block * 3 + 5);
+    EXPECT_EQ(bv[1], 8u);
+    for (size_t i = 0; i < bv.size(); ++i) {
+        bv[i] = i;
+    }
+    EXPECT_EQ(bv.back(), block * 3 + 4);
+
+    bv.resize_default_init(1);
+    EXPECT_EQ(bv.size(), 1u);
+
+    // Types with a default constructor still get it run.
+    BlockVector<std::string> strings;
+    strings.resize_default_init(10);
+    EXPECT_TRUE(strings[9].empty());
+}
+
+TEST(BlockStorageTest, ForOverwriteConstructor) {
+    BlockVector<double> bv(1000, bv::for_overwrite);
+    EXPECT_EQ(bv.size(), 1000u);
+    EXPECT_GE(bv.capacity(), 1000u);
+    bv[999] = 1.5;
+    EXPECT_EQ(bv.back(), 1.5);
+
+    FixedBlockVector<int, 4> fixed(40, bv::for_overwrite);
+    EXPECT_EQ(fixed.size(), 40u);
+    EXPECT_EQ(fixed.capacity(), 48u);
+}
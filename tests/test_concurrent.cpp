@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "ConcurrentBlockVector.hpp"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ConcurrentBlockVector, SingleThreadBehavesLikeAVector) {
+    ConcurrentBlockVector<std::string> cv;
+    EXPECT_TRUE(cv.empty());
+    for (int i = 0; i < 5000; ++i) {
+        cv.push_back(std::to_string(i));
+    }
+    ASSERT_EQ(cv.size(), 5000u);
+    for (size_t i = 0; i < cv.size(); ++i) {
+        EXPECT_EQ(cv[i], std::to_string(i));
+    }
+    EXPECT_THROW(cv.at(5000), std::out_of_range);
+    EXPECT_GE(cv.capacity(), 5000u);
+}
+
+TEST(ConcurrentBlockVector, ElementsNeverMove) {
+    ConcurrentBlockVector<int, std::allocator<int>, 2> cv;
+    int& first = cv.emplace_back(42);
+    for (int i = 0; i < 10000; ++i) {
+        cv.push_back(i);
+    }
+    EXPECT_EQ(&first, &cv[0]);
+    EXPECT_EQ(first, 42);
+}
+
+TEST(ConcurrentBlockVector, ConcurrentWritersAndReaders) {
+    constexpr size_t kWriters = 4;
+    constexpr size_t kPerWriter = 50000;
+    ConcurrentBlockVector<size_t, std::allocator<size_t>, 4> cv;
+    std::atomic<bool> done{false};
+    std::atomic<size_t> bad_reads{0};
+
+    std::thread reader([&]() {
+        size_t seen = 0;
+        while (!done.load()) {
+            size_t n = cv.size();
+            EXPECT_GE(n, seen);
+            for (size_t i = seen; i < n; ++i) {
+                if (cv[i] >= kWriters * kPerWriter) {
+                    ++bad_reads;
+                }
+            }
+            seen = n;
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (size_t w = 0; w < kWriters; ++w) {
+        writers.emplace_back([&, w]() {
+            for (size_t i = 0; i < kPerWriter; ++i) {
+                cv.push_back(w * kPerWriter + i);
+            }
+        });
+    }
+    for (auto& t : writers) {
+        t.join();
+    }
+    done.store(true);
+    reader.join();
+
+    ASSERT_EQ(cv.size(), kWriters * kPerWriter);
+    EXPECT_EQ(bad_reads.load(), 0u);
+    std::vector<bool> present(kWriters * kPerWriter, false);
+    for (size_t i = 0; i < cv.size(); ++i) {
+        ASSERT_LT(cv[i], present.size());
+        EXPECT_FALSE(present[cv[i]]);
+        present[cv[i]] = true;
+    }
+}
@@ -0,0 +1,247 @@
+#include <gtest/gtest.h>
+#include "CowBlockVector.hpp"
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using SmallCow = CowBlockVector<int, std::allocator<int>, 2>;
+
+TEST(CowBlockVector, SnapshotSharesEveryBlock) {
+    SmallCow cv;
+    for (int i = 0; i < 20; ++i) {
+        cv.push_back(i);
+    }
+    EXPECT_EQ(cv.shared_block_count(), 0u);
+
+    SmallCow snap = cv.snapshot();
+    EXPECT_EQ(cv.shared_block_count(), 5u);
+    EXPECT_EQ(snap.shared_block_count(), 5u);
+    EXPECT_EQ(&std::as_const(cv)[7], &std::as_const(snap)[7]);
+    EXPECT_EQ(snap.size(), 20u);
+}
+
+TEST(CowBlockVector, WriteClonesOnlyTouchedBlock) {
+    SmallCow cv;
+    for (int i = 0; i < 20; ++i) {
+        cv.push_back(i);
+    }
+    SmallCow snap(cv);
+    const int* shared_first = &std::as_const(snap)[0];
+
+    cv[9] = -9;
+    EXPECT_EQ(cv.shared_block_count(), 4u);
+    EXPECT_EQ(std::as_const(snap)[9], 9);
+    EXPECT_EQ(std::as_const(cv)[9], -9);
+    EXPECT_EQ(&std::as_const(cv)[0], shared_first);
+
+    // Writes to a block that is already private do not clone again.
+    const int* private_block = &std::as_const(cv)[8];
+    cv[10] = -10;
+    EXPECT_EQ(&std::as_const(cv)[8], private_block);
+
+    // Reads through a const view never clone.
+    long sum = 0;
+    for (auto it = snap.cbegin(); it != snap.cend(); ++it) {
+        sum += *it;
+    }
+    EXPECT_EQ(sum, 19 * 20 / 2);
+    EXPECT_EQ(snap.shared_block_count(), 4u);
+}
+
+TEST(CowBlockVector, AppendsIntoFreshBlocksNeverCopy) {
+    SmallCow cv;
+    for (int i = 0; i < 8; ++i) {
+        cv.push_back(i);
+    }
+    SmallCow snap(cv);
+    for (int i = 8; i < 40; ++i) {
+        cv.push_back(i);
+    }
+    EXPECT_EQ(cv.shared_block_count(), 2u);
+    EXPECT_EQ(snap.size(), 8u);
+    EXPECT_EQ(cv[39], 39);
+
+    // A snapshot taken mid-block: the shared tail is cloned once on append.
+    cv.push_back(40);
+    SmallCow mid(cv);
+    const int* tail = &std::as_const(mid)[40];
+    cv.push_back(41);
+    EXPECT_NE(&std::as_const(cv)[40], tail);
+    EXPECT_EQ(mid.size(), 41u);
+    EXPECT_EQ(cv[41], 41);
+}
+
+TEST(CowBlockVector, PopAndClearLeaveSnapshotIntact) {
+    auto tracker = std::make_shared<int>(0);
+    CowBlockVector<std::shared_ptr<int>, std::allocator<std::shared_ptr<int>>, 2> cv;
+    for (int i = 0; i < 10; ++i) {
+        cv.push_back(tracker);
+    }
+    auto snap = cv.snapshot();
+    EXPECT_EQ(tracker.use_count(), 11);
+
+    cv.pop_back();
+    EXPECT_EQ(cv.size(), 9u);
+    EXPECT_EQ(snap.size(), 10u);
+    // Popping cloned the tail block (2 elements) and destroyed one element.
+    EXPECT_EQ(tracker.use_count(), 12);
+
+    cv.clear();
+    EXPECT_EQ(tracker.use_count(), 11);
+    EXPECT_EQ(*snap[9], 0);
+    snap.clear();
+    EXPECT_EQ(tracker.use_count(), 1);
+}
+
+TEST(CowBlockVector, AssignmentMoveAndIterators) {
+    CowBlockVector<std::string, std::allocator<std::string>, 3> a{"a", "b", "c"};
+    CowBlockVector<std::string, std::allocator<std::string>, 3> b(5, "x");
+    b = a;
+    EXPECT_EQ(b.size(), 3u);
+    EXPECT_EQ(a.shared_block_count(), 1u);
+    for (auto& s : b) {
+        s += "!";
+    }
+    EXPECT_EQ(a[0], "a");
+    EXPECT_EQ(b[2], "c!");
+
+    CowBlockVector<std::string, std::allocator<std::string>, 3> c(std::move(b));
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(c.back(), "c!");
+    swap(a, c);
+    EXPECT_EQ(a.front(), "a!");
+    c.resize(20);
+    EXPECT_EQ(c[19], "");
+    EXPECT_THROW(c.at(20), std::out_of_range);
+
+    std::vector<int> values(100);
+    std::iota(values.begin(), values.end(), 0);
+    SmallCow sorted;
+    for (int v : values) {
+        sorted.push_back(99 - v);
+    }
+    SmallCow original(sorted);
+    std::sort(sorted.begin(), sorted.end());
+    EXPECT_TRUE(std::equal(sorted.cbegin(), sorted.cend(), values.begin()));
+    EXPECT_EQ(std::as_const(original)[0], 99);
+}
+
+TEST(CowBlockVector, SnapshotsAcrossThreads) {
+    CowBlockVector<long> cv;
+    for (long i = 0; i < 100000; ++i) {
+        cv.push_back(i);
+    }
+    std::vector<std::thread> readers;
+    std::vector<long> sums(4, 0);
+    for (size_t t = 0; t < sums.size(); ++t) {
+        readers.emplace_back([&sums, t, snap = cv.snapshot()]() mutable {
+            for (long v : std::as_const(snap)) {
+                sums[t] += v;
+            }
+            snap[t] = -1;
+        });
+        for (size_t i = 0; i < cv.size(); i += 1000) {
+            cv[i] += 1;
+        }
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    long base = 99999L * 100000 / 2;
+    for (size_t t = 0; t < sums.size(); ++t) {
+        EXPECT_EQ(sums[t], base + static_cast<long>(100 * t));
+    }
+    EXPECT_EQ(cv[1000], 1004);
+}
+
+TEST(CowBlockVector, PmrAllocatorCopyMoveAndSwap) {
+    using Vec = CowBlockVector<std::pmr::string, std::pmr::polymorphic_allocator<std::pmr::string>>;
+    std::pmr::unsynchronized_pool_resource r1;
+    std::pmr::unsynchronized_pool_resource r2;
+    Vec a(&r1);
+    for (int i = 0; i < 1000; ++i) {
+        a.push_back(std::pmr::string(std::to_string(i) + std::string(32, 'x')));
+    }
+    Vec same(&r1);
+    Vec other(&r2);
+    same = a;
+    other = a;
+    EXPECT_EQ(other.get_allocator().resource(), &r2);
+    ASSERT_EQ(other.size(), 1000u);
+    EXPECT_EQ(other[999], a[999]);
+
+    same = std::move(a);
+    EXPECT_EQ(same.size(), 1000u);
+    other = std::move(same);
+    EXPECT_EQ(other.get_allocator().resource(), &r2);
+    ASSERT_EQ(other.size(), 1000u);
+    EXPECT_STREQ(other[500].c_str(), (std::to_string(500) + std::string(32, 'x')).c_str());
+
+    Vec b(&r2);
+    b.push_back(std::pmr::string("b"));
+    b.swap(other);
+    EXPECT_EQ(b.size(), 1000u);
+    EXPECT_EQ(other.size(), 1u);
+    EXPECT_EQ(b.get_allocator().resource(), &r2);
+}
+
+namespace {
+// Allocator that counts live bytes and can be told to fail when the block
+// table (an array of pointers) grows.
+template <typename T>
+struct TableFailAllocator {
+    using value_type = T;
+
+    long* live;
+    bool* fail_table;
+
+    TableFailAllocator(long* counter, bool* fail) : live(counter), fail_table(fail) {}
+    template <typename U>
+    TableFailAllocator(const TableFailAllocator<U>& other) : live(other.live), fail_table(other.fail_table) {}
+
+    T* allocate(size_t n) {
+        if (std::is_pointer<T>::value && *fail_table) {
+            throw std::bad_alloc();
+        }
+        *live += static_cast<long>(n * sizeof(T));
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, size_t n) {
+        *live -= static_cast<long>(n * sizeof(T));
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const TableFailAllocator<U>& other) const { return live == other.live; }
+    template <typename U>
+    bool operator!=(const TableFailAllocator<U>& other) const { return live != other.live; }
+};
+}
+
+TEST(CowBlockVector, FailedTableGrowthDoesNotLeakBlock) {
+    long live = 0;
+    bool fail_table = false;
+    {
+        using Vec = CowBlockVector<int, TableFailAllocator<int>, 4>;
+        Vec v(TableFailAllocator<int>(&live, &fail_table));
+        for (int i = 0; i < 16; ++i) {
+            v.push_back(i);
+        }
+        long before = live;
+        fail_table = true;
+        EXPECT_THROW(v.push_back(16), std::bad_alloc);
+        fail_table = false;
+        EXPECT_EQ(live, before);
+        EXPECT_EQ(v.size(), 16u);
+        v.push_back(16);
+        EXPECT_EQ(v[16], 16);
+    }
+    EXPECT_EQ(live, 0);
+}
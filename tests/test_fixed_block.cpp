@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+#include "BlockVector.hpp"
+#include <algorithm>
+
+TEST(FixedBlockVector, GeometryIsCompileTime) {
+    FixedBlockVector<int, 4> bv;
+    EXPECT_EQ(bv.get_Block_size(), 16u);
+    EXPECT_EQ(bv.set_Block_size(1024), 16u);
+    static_assert(sizeof(FixedBlockVector<int, 8>) < sizeof(BlockVector<int>),
+                  "fixed geometry should not be stored in the object");
+}
+
+TEST(FixedBlockVector, SizedConstructorSpansBlocks) {
+    FixedBlockVector<int, 4> bv(100, 7);
+    EXPECT_EQ(bv.size(), 100u);
+    EXPECT_EQ(bv.get_Block_size(), 16u);
+    EXPECT_EQ(bv.capacity(), 112u);
+    for (size_t i = 0; i < bv.size(); ++i) {
+        EXPECT_EQ(bv[i], 7);
+    }
+
+    FixedBlockVector<int, 2> list = {1, 2, 3, 4, 5, 6};
+    EXPECT_EQ(list.back(), 6);
+    EXPECT_EQ(list.capacity(), 8u);
+}
+
+TEST(FixedBlockVector, IteratorsAndAlgorithms) {
+    FixedBlockVector<int, 3> bv;
+    for (int i = 0; i < 100; ++i) {
+        bv.push_back(99 - i);
+    }
+    std::sort(bv.begin(), bv.end());
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(bv[i], i);
+    }
+    EXPECT_EQ(bv.end() - bv.begin(), 100);
+    EXPECT_EQ(*(bv.rbegin()), 99);
+
+    FixedBlockVector<int, 3> copy(bv);
+    EXPECT_TRUE(std::equal(bv.begin(), bv.end(), copy.begin()));
+}
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include "GeometricBlockVector.hpp"
+#include <algorithm>
+#include <memory_resource>
+#include <numeric>
+#include <string>
+
+TEST(GeometricBlockVector, PushBackAndIndex) {
+    GeometricBlockVector<int, std::allocator<int>, 2> gv;
+    EXPECT_TRUE(gv.empty());
+    for (int i = 0; i < 1000; ++i) {
+        gv.push_back(i);
+    }
+    ASSERT_EQ(gv.size(), 1000u);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(gv[i], i);
+    }
+    EXPECT_EQ(gv.front(), 0);
+    EXPECT_EQ(gv.back(), 999);
+    EXPECT_THROW(gv.at(1000), std::out_of_range);
+    // blocks of 4, 8, 16, ...: 1000 elements fit in 8 blocks (capacity 1020).
+    EXPECT_EQ(gv.segment_count(), 8u);
+    EXPECT_EQ(gv.capacity(), 1020u);
+}
+
+TEST(GeometricBlockVector, SegmentsDoubleInSize) {
+    GeometricBlockVector<int, std::allocator<int>, 3> gv;
+    for (int i = 0; i < 100; ++i) {
+        gv.push_back(i);
+    }
+    EXPECT_EQ(gv.get_segment(0).size(), 8u);
+    EXPECT_EQ(gv.get_segment(1).size(), 16u);
+    EXPECT_EQ(gv.get_segment(2).size(), 32u);
+    EXPECT_EQ(gv.get_segment(3).size(), 44u);
+    EXPECT_EQ(gv.get_segment(3).data(), &gv[56]);
+
+    long total = 0;
+    gv.for_each_segment([&](bv::BlockSpan<int> seg) {
+        total += std::accumulate(seg.begin(), seg.end(), 0L);
+    });
+    EXPECT_EQ(total, 99L * 100 / 2);
+}
+
+TEST(GeometricBlockVector, ElementsNeverMove) {
+    GeometricBlockVector<std::string, std::allocator<std::string>, 1> gv;
+    std::string& first = gv.emplace_back("first");
+    const std::string* tenth = nullptr;
+    for (int i = 1; i < 5000; ++i) {
+        gv.push_back(std::to_string(i));
+        if (i == 10) {
+            tenth = &gv[10];
+        }
+    }
+    EXPECT_EQ(&first, &gv[0]);
+    EXPECT_EQ(tenth, &gv[10]);
+    EXPECT_EQ(gv[4999], "4999");
+}
+
+TEST(GeometricBlockVector, IteratorsAndAlgorithms) {
+    GeometricBlockVector<int, std::allocator<int>, 2> gv;
+    for (int i = 0; i < 500; ++i) {
+        gv.push_back((i * 7919) % 500);
+    }
+    EXPECT_EQ(gv.end() - gv.begin(), 500);
+    std::sort(gv.begin(), gv.end());
+    for (int i = 0; i < 500; ++i) {
+        EXPECT_EQ(gv[i], i);
+    }
+    EXPECT_EQ(*std::lower_bound(gv.begin(), gv.end(), 321), 321);
+    EXPECT_EQ(*(gv.begin() + 123), 123);
+    EXPECT_EQ(*(gv.end() - 1), 499);
+    EXPECT_EQ(*gv.rbegin(), 499);
+
+    int expected = 499;
+    for (auto it = gv.end(); it != gv.begin();) {
+        --it;
+        EXPECT_EQ(*it, expected--);
+    }
+    const auto& cgv = gv;
+    EXPECT_EQ(std::accumulate(cgv.begin(), cgv.end(), 0), 499 * 500 / 2);
+}
+
+TEST(GeometricBlockVector, CopyMoveAndSwap) {
+    GeometricBlockVector<std::string> a{"x", "y", "z"};
+    GeometricBlockVector<std::string> b(a);
+    EXPECT_EQ(b.size(), 3u);
+    EXPECT_EQ(b[2], "z");
+
+    const std::string* data = &a[0];
+    GeometricBlockVector<std::string> c(std::move(a));
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(&c[0], data);
+
+    GeometricBlockVector<std::string> d(10, "v");
+    d = c;
+    EXPECT_EQ(d.size(), 3u);
+    EXPECT_EQ(d[1], "y");
+    d = std::move(b);
+    EXPECT_EQ(d[0], "x");
+
+    swap(c, d);
+    EXPECT_EQ(&d[0], data);
+}
+
+TEST(GeometricBlockVector, ResizePopAndShrink) {
+    GeometricBlockVector<int, std::allocator<int>, 2> gv(100);
+    EXPECT_EQ(gv.size(), 100u);
+    EXPECT_EQ(gv[99], 0);
+    size_t capacity = gv.capacity();
+
+    gv.resize(10);
+    gv.pop_back();
+    EXPECT_EQ(gv.size(), 9u);
+    EXPECT_EQ(gv.capacity(), capacity);
+    gv.shrink_to_fit();
+    EXPECT_EQ(gv.capacity(), 12u);
+    gv.clear();
+    gv.shrink_to_fit();
+    EXPECT_EQ(gv.capacity(), 0u);
+    gv.push_back(5);
+    EXPECT_EQ(gv.back(), 5);
+}
+
+TEST(GeometricBlockVector, PmrAllocatorCopyMoveAndSwap) {
+    using Vec = GeometricBlockVector<std::pmr::string, std::pmr::polymorphic_allocator<std::pmr::string>>;
+    std::pmr::unsynchronized_pool_resource r1;
+    std::pmr::unsynchronized_pool_resource r2;
+    Vec a(&r1);
+    for (int i = 0; i < 1000; ++i) {
+        a.push_back(std::pmr::string(std::to_string(i) + std::string(32, 'x')));
+    }
+    Vec same(&r1);
+    Vec other(&r2);
+    same = a;
+    other = a;
+    EXPECT_EQ(other.get_allocator().resource(), &r2);
+    ASSERT_EQ(other.size(), 1000u);
+    EXPECT_EQ(other[999], a[999]);
+
+    same = std::move(a);
+    EXPECT_EQ(same.size(), 1000u);
+    other = std::move(same);
+    EXPECT_EQ(other.get_allocator().resource(), &r2);
+    ASSERT_EQ(other.size(), 1000u);
+    EXPECT_STREQ(other[500].c_str(), (std::to_string(500) + std::string(32, 'x')).c_str());
+
+    Vec b(&r2);
+    b.push_back(std::pmr::string("b"));
+    b.swap(other);
+    EXPECT_EQ(b.size(), 1000u);
+    EXPECT_EQ(other.size(), 1u);
+    EXPECT_EQ(b.get_allocator().resource(), &r2);
+}
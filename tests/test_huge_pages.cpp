@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include "HugePageResource.hpp"
+#include <cstdint>
+#include <string>
+
+TEST(HugePageResource, BlocksComeFromAlignedArenas) {
+    bv::HugePageResource huge;
+    pmr::BlockVector<uint64_t> bv(&huge);
+    const size_t block = bv.get_Block_size();
+    for (uint64_t i = 0; i < block * 50; ++i) {
+        bv.push_back(i);
+    }
+    EXPECT_EQ(huge.arena_count(), 1u);
+    EXPECT_EQ(bv[block * 50 - 1], block * 50 - 1);
+    // Consecutive blocks are carved back to back from the arena.
+    EXPECT_EQ(&bv[block], &bv[block - 1] + 1);
+    EXPECT_EQ(bv.get_allocator().resource(), &huge);
+}
+
+TEST(HugePageResource, FreedBlocksAreReused) {
+    bv::HugePageResource huge;
+    pmr::BlockVector<int> bv(&huge);
+    bv.set_max_spare_blocks(0);
+    const size_t block = bv.get_Block_size();
+    bv.resize(block * 4);
+    int* last_block = &bv[block * 3];
+    bv.resize(block * 3);
+    bv.resize(block * 4);
+    EXPECT_EQ(&bv[block * 3], last_block);
+}
+
+TEST(HugePageResource, OversizedRequestsGetTheirOwnArena) {
+    bv::HugePageResource huge(1);
+    std::pmr::memory_resource* resource = &huge;
+    void* small = resource->allocate(64, 64);
+    void* big = resource->allocate(size_t(5) << 20, 4096);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(small) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(big) % 4096, 0u);
+    EXPECT_EQ(huge.arena_count(), 2u);
+    // The oversized mapping did not replace the arena serving small requests.
+    void* next = resource->allocate(64, 64);
+    EXPECT_EQ(static_cast<char*>(next), static_cast<char*>(small) + 64);
+    resource->deallocate(next, 64, 64);
+    resource->deallocate(big, size_t(5) << 20, 4096);
+    resource->deallocate(small, 64, 64);
+
+    bv::HugePageResource other;
+    EXPECT_TRUE(resource->is_equal(huge));
+    EXPECT_FALSE(resource->is_equal(other));
+}
+
+TEST(HugePageResource, ArenaTailsServeLaterRequests) {
+    const size_t kib = 1024;
+    bv::HugePageResource huge(1);
+    std::pmr::memory_resource* resource = &huge;
+    char* first = static_cast<char*>(resource->allocate(1536 * kib, 64));
+    char* second = static_cast<char*>(resource->allocate(1792 * kib, 64));
+    EXPECT_EQ(huge.arena_count(), 2u);
+    // The last 512 KiB of the first arena did not fit `second` but are kept
+    // for a request the second arena's 256 KiB tail cannot hold.
+    char* third = static_cast<char*>(resource->allocate(384 * kib, 64));
+    EXPECT_EQ(third, first + 1536 * kib);
+    char* fourth = static_cast<char*>(resource->allocate(128 * kib, 64));
+    EXPECT_EQ(fourth, second + 1792 * kib);
+    EXPECT_EQ(huge.arena_count(), 2u);
+    resource->deallocate(fourth, 128 * kib, 64);
+    resource->deallocate(third, 384 * kib, 64);
+    resource->deallocate(second, 1792 * kib, 64);
+    resource->deallocate(first, 1536 * kib, 64);
+}
+
+TEST(HugePageResource, FreedChunksKeepTheirAlignment) {
+    bv::HugePageResource huge;
+    std::pmr::memory_resource* resource = &huge;
+    // Push the cursor off a 64-byte boundary so an 8-aligned chunk is not
+    // 64-aligned by accident.
+    void* pad = resource->allocate(8, 8);
+    void* loose = resource->allocate(64, 8);
+    ASSERT_NE(reinterpret_cast<uintptr_t>(loose) % 64, 0u);
+    resource->deallocate(loose, 64, 8);
+    void* strict = resource->allocate(64, 64);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(strict) % 64, 0u);
+    EXPECT_NE(strict, loose);
+    // The 8-aligned chunk is still reused at its own alignment.
+    EXPECT_EQ(resource->allocate(64, 8), loose);
+    resource->deallocate(loose, 64, 8);
+    resource->deallocate(strict, 64, 64);
+    resource->deallocate(pad, 8, 8);
+}
+
+TEST(HugePageResource, NonTrivialElements) {
+    bv::HugePageResource huge;
+    {
+        pmr::BlockVector<std::string> strings(&huge);
+        for (int i = 0; i < 2000; ++i) {
+            strings.push_back(std::string(40, static_cast<char>('a' + i % 26)));
+        }
+        EXPECT_EQ(strings[1999][0], 'a' + 1999 % 26);
+    }
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include "BlockVectorIO.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+namespace {
+struct Sample {
+    uint32_t id;
+    float value;
+};
+
+// Anonymous temporary file; the descriptor is rewound before every read.
+struct TempFd {
+    FILE* file = std::tmpfile();
+    int fd() const { return fileno(file); }
+    void rewind() const { ::lseek(fd(), 0, SEEK_SET); }
+    ~TempFd() { std::fclose(file); }
+};
+} // namespace
+
+TEST(BlockVectorIO, FdRoundTripAcrossGeometries) {
+    // Enough blocks to need several writev batches.
+    FixedBlockVector<int, 2> source;
+    for (int i = 0; i < 10000; ++i) {
+        source.push_back(i * 7);
+    }
+    TempFd file;
+    bv::save(source, file.fd());
+    file.rewind();
+
+    BlockVector<int> loaded = {1, 2, 3};
+    bv::load(loaded, file.fd());
+    ASSERT_EQ(loaded.size(), source.size());
+    EXPECT_EQ(loaded.get_Block_size(), 4u);
+    for (size_t i = 0; i < loaded.size(); ++i) {
+        ASSERT_EQ(loaded[i], source[i]);
+    }
+
+    file.rewind();
+    FixedBlockVector<int, 8> fixed;
+    bv::load(fixed, file.fd());
+    EXPECT_EQ(fixed.get_Block_size(), 256u);
+    EXPECT_EQ(fixed[9999], 9999 * 7);
+}
+
+TEST(BlockVectorIO, StreamRoundTrip) {
+    BlockVector<Sample> source;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        source.push_back(Sample{i, i * 0.25f});
+    }
+    std::stringstream buffer;
+    bv::save(source, buffer);
+
+    BlockVector<Sample> loaded;
+    bv::load(loaded, buffer);
+    ASSERT_EQ(loaded.size(), 1000u);
+    EXPECT_EQ(loaded[999].id, 999u);
+    EXPECT_EQ(loaded[500].value, 125.0f);
+
+    BlockVector<Sample> empty;
+    std::stringstream empty_buffer;
+    bv::save(empty, empty_buffer);
+    bv::load(loaded, empty_buffer);
+    EXPECT_TRUE(loaded.empty());
+}
+
+TEST(BlockVectorIO, RejectsBadInput) {
+    BlockVector<int> vec = {1, 2, 3};
+
+    std::stringstream garbage("this is not a serialized container at all");
+    EXPECT_THROW(bv::load(vec, garbage), std::runtime_error);
+
+    BlockVector<uint64_t> wide = {1, 2};
+    std::stringstream typed;
+    bv::save(wide, typed);
+    EXPECT_THROW(bv::load(vec, typed), std::runtime_error);
+
+    // Truncated payload leaves the destination empty.
+    std::stringstream full;
+    bv::save(BlockVector<int>(100, 5), full);
+    std::string bytes = full.str();
+    std::stringstream truncated(bytes.substr(0, bytes.size() - 4));
+    EXPECT_THROW(bv::load(vec, truncated), std::runtime_error);
+    EXPECT_TRUE(vec.empty());
+
+    TempFd file;
+    ASSERT_EQ(::write(file.fd(), bytes.data(), bytes.size() - 4), static_cast<ssize_t>(bytes.size() - 4));
+    file.rewind();
+    EXPECT_THROW(bv::load(vec, file.fd()), std::runtime_error);
+    EXPECT_THROW(bv::save(wide, -1), std::system_error);
+}
+
+// Headers are checked before anything is allocated: an oversized block or an
+// element count larger than the remaining input is rejected up front, and an
+// unseekable input is loaded in bounded chunks until it runs out.
+TEST(BlockVectorIO, RejectsCorruptHeaders) {
+    std::stringstream good;
+    bv::save(BlockVector<int>(10, 7), good);
+    std::string bytes = good.str();
+    auto with_header = [&](uint64_t block_size, uint64_t count) {
+        std::string copy = bytes;
+        std::memcpy(&copy[16], &block_size, sizeof(block_size));
+        std::memcpy(&copy[24], &count, sizeof(count));
+        return copy;
+    };
+
+    BlockVector<int> vec = {1, 2, 3};
+    std::stringstream huge_count(with_header(256, static_cast<uint64_t>(1) << 40));
+    EXPECT_THROW(bv::load(vec, huge_count), std::runtime_error);
+    std::stringstream huge_block(with_header(static_cast<uint64_t>(1) << 40, 10));
+    EXPECT_THROW(bv::load(vec, huge_block), std::runtime_error);
+    // A block size the payload does not need is not adopted: loading ten
+    // elements must not allocate a 1 GiB block.
+    std::stringstream oversized_block(with_header(static_cast<uint64_t>(1) << 28, 10));
+    bv::load(vec, oversized_block);
+    EXPECT_EQ(vec.size(), 10u);
+    EXPECT_EQ(vec.get_Block_size(), 16u);
+    EXPECT_EQ(vec[9], 7);
+    std::stringstream overflow(with_header(256, UINT64_MAX / 2));
+    EXPECT_THROW(bv::load(vec, overflow), std::runtime_error);
+
+    TempFd file;
+    std::string hostile = with_header(256, static_cast<uint64_t>(1) << 40);
+    ASSERT_EQ(::write(file.fd(), hostile.data(), hostile.size()), static_cast<ssize_t>(hostile.size()));
+    file.rewind();
+    EXPECT_THROW(bv::load(vec, file.fd()), std::runtime_error);
+
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    ASSERT_EQ(::write(fds[1], hostile.data(), hostile.size()), static_cast<ssize_t>(hostile.size()));
+    ::close(fds[1]);
+    EXPECT_THROW(bv::load(vec, fds[0]), std::runtime_error);
+    ::close(fds[0]);
+    EXPECT_TRUE(vec.empty());
+
+    std::stringstream intact(bytes);
+    bv::load(vec, intact);
+    EXPECT_EQ(vec.size(), 10u);
+    EXPECT_EQ(vec[9], 7);
+}
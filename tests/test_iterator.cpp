@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include "BlockVector.hpp"
+#include <algorithm>
+#include <random>
+
+TEST(BlockVectorIterator, ArithmeticAcrossBlocks) {
+    FixedBlockVector<int, 3> bv;
+    for (int i = 0; i < 100; ++i) {
+        bv.push_back(i);
+    }
+
+    auto it = bv.begin();
+    for (std::ptrdiff_t step : {7, 1, 8, 13, -5, -20, 90}) {
+        auto moved = it + step;
+        EXPECT_EQ(*moved, *it + step);
+        EXPECT_EQ(moved - it, step);
+        EXPECT_EQ(it - moved, -step);
+        it = moved;
+    }
+    EXPECT_EQ(*it, 94);
+    it += 6;
+    EXPECT_EQ(it, bv.end());
+    it -= 100;
+    EXPECT_EQ(it, bv.begin());
+    EXPECT_EQ(bv.begin()[57], 57);
+    EXPECT_EQ(bv.end() - bv.begin(), 100);
+}
+
+TEST(BlockVectorIterator, StepAcrossBlockBoundaries) {
+    FixedBlockVector<int, 2> bv;
+    for (int i = 0; i < 10; ++i) {
+        bv.push_back(i);
+    }
+
+    int expected = 0;
+    for (auto it = bv.begin(); it != bv.end(); ++it) {
+        EXPECT_EQ(*it, expected++);
+    }
+    EXPECT_EQ(expected, 10);
+    for (auto it = bv.end(); it != bv.begin();) {
+        --it;
+        EXPECT_EQ(*it, --expected);
+    }
+    EXPECT_EQ(expected, 0);
+}
+
+TEST(BlockVectorIterator, EndOfFullTable) {
+    // size is a multiple of the block size, so end() lies in a block that
+    // does not exist yet.
+    FixedBlockVector<int, 2> bv;
+    for (int i = 0; i < 8; ++i) {
+        bv.push_back(i);
+    }
+    auto last = bv.end() - 1;
+    EXPECT_EQ(*last, 7);
+    EXPECT_EQ(last + 1, bv.end());
+    EXPECT_EQ(*--bv.end(), 7);
+    EXPECT_EQ(bv.rbegin()[0], 7);
+}
+
+TEST(BlockVectorIterator, ComparisonsFollowIndex) {
+    BlockVector<int> bv(1000, 0);
+    auto a = bv.begin() + 10;
+    auto b = bv.begin() + 700;
+    EXPECT_TRUE(a < b);
+    EXPECT_TRUE(b > a);
+    EXPECT_TRUE(a <= a);
+    EXPECT_TRUE(b >= a);
+    EXPECT_TRUE(b < bv.end());
+    EXPECT_FALSE(bv.end() < b);
+    BlockVector<int>::const_iterator ca = a;
+    EXPECT_EQ(ca, bv.cbegin() + 10);
+    EXPECT_TRUE(bv.cbegin() < ca);
+}
+
+TEST(BlockVectorIterator, EmptyContainer) {
+    BlockVector<int> bv;
+    EXPECT_EQ(bv.begin(), bv.end());
+    EXPECT_EQ(bv.end() - bv.begin(), 0);
+    EXPECT_TRUE(std::is_sorted(bv.begin(), bv.end()));
+}
+
+TEST(BlockVectorIterator, StaysValidAcrossPushBack) {
+    FixedBlockVector<int, 2> bv;
+    for (int i = 0; i < 6; ++i) {
+        bv.push_back(i);
+    }
+    auto it = bv.begin() + 5;
+    for (int i = 6; i < 64; ++i) {
+        bv.push_back(i);
+    }
+    EXPECT_EQ(*it, 5);
+    ++it;
+    EXPECT_EQ(*it, 6);
+    it += 50;
+    EXPECT_EQ(*it, 56);
+}
+
+TEST(BlockVectorIterator, SortSearchAndSelect) {
+    FixedBlockVector<int, 4> bv;
+    std::mt19937 rng(7);
+    for (int i = 0; i < 5000; ++i) {
+        bv.push_back(static_cast<int>(rng() % 10000));
+    }
+    auto copy = bv;
+
+    std::nth_element(copy.begin(), copy.begin() + 2500, copy.end());
+    int median = copy[2500];
+
+    std::sort(bv.begin(), bv.end());
+    EXPECT_TRUE(std::is_sorted(bv.begin(), bv.end()));
+    EXPECT_EQ(bv[2500], median);
+
+    auto pos = std::lower_bound(bv.begin(), bv.end(), median);
+    EXPECT_EQ(*pos, median);
+    EXPECT_LE(pos - bv.begin(), 2500);
+    EXPECT_EQ(std::upper_bound(bv.begin(), bv.end(), 10000), bv.end());
+}
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include "MappedBlockVector.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <string>
+
+namespace {
+struct Point {
+    int32_t x;
+    int32_t y;
+};
+
+// Temporary backing file that is removed when the test ends.
+struct TempFile {
+    std::string path;
+    explicit TempFile(const char* name) : path(testing::TempDir() + name) { std::remove(path.c_str()); }
+    ~TempFile() { std::remove(path.c_str()); }
+};
+} // namespace
+
+TEST(MappedBlockVector, PersistsAcrossReopen) {
+    TempFile file("bv_mapped_persist.bin");
+    {
+        MappedBlockVector<uint64_t> mv(file.path, 1000);
+        EXPECT_EQ(mv.get_Block_size(), 1024u);
+        for (uint64_t i = 0; i < 5000; ++i) {
+            mv.push_back(i * 3);
+        }
+        mv.sync();
+    }
+
+    MappedBlockVector<uint64_t> reopened(file.path);
+    ASSERT_EQ(reopened.size(), 5000u);
+    EXPECT_EQ(reopened.get_Block_size(), 1024u);
+    EXPECT_EQ(reopened[4999], 4999u * 3);
+    EXPECT_EQ(std::accumulate(reopened.begin(), reopened.end(), uint64_t(0)), 3u * 4999u * 5000u / 2u);
+
+    reopened.push_back(7);
+    EXPECT_EQ(reopened.size(), 5001u);
+    EXPECT_EQ(reopened.at(5000), 7u);
+    EXPECT_THROW(reopened.at(5001), std::out_of_range);
+}
+
+TEST(MappedBlockVector, GrowthKeepsAddressesStable) {
+    TempFile file("bv_mapped_stable.bin");
+    MappedBlockVector<Point> mv(file.path, 64);
+    mv.push_back(Point{1, 2});
+    Point* first = &mv[0];
+    for (int i = 1; i < 1000; ++i) {
+        mv.emplace_back(Point{i, -i});
+    }
+    mv.reserve(10000);
+    EXPECT_EQ(&mv[0], first);
+    EXPECT_EQ(mv[0].y, 2);
+    EXPECT_EQ(mv[999].y, -999);
+    EXPECT_GE(mv.capacity(), 10000u);
+
+    size_t seen = 0;
+    for (auto seg : mv.segments()) {
+        seen += seg.size();
+    }
+    EXPECT_EQ(seen, 1000u);
+}
+
+TEST(MappedBlockVector, ResizeAndShrinkPersist) {
+    TempFile file("bv_mapped_resize.bin");
+    {
+        MappedBlockVector<int> mv(file.path, 16);
+        mv.resize(100);
+        EXPECT_EQ(mv[99], 0);
+        mv[50] = 5;
+        mv.resize(60);
+        mv.pop_back();
+    }
+    MappedBlockVector<int> reopened(file.path);
+    EXPECT_EQ(reopened.size(), 59u);
+    EXPECT_EQ(reopened[50], 5);
+    reopened.clear();
+    EXPECT_TRUE(reopened.empty());
+}
+
+TEST(MappedBlockVector, RejectsForeignOrMismatchedFiles) {
+    TempFile file("bv_mapped_bad.bin");
+    {
+        std::ofstream out(file.path, std::ios::binary);
+        out << "definitely not a block vector header, just some text";
+    }
+    EXPECT_THROW(MappedBlockVector<int>{file.path}, std::runtime_error);
+
+    TempFile typed("bv_mapped_typed.bin");
+    {
+        MappedBlockVector<uint64_t> mv(typed.path);
+        mv.push_back(1);
+    }
+    EXPECT_THROW(MappedBlockVector<int32_t>{typed.path}, std::runtime_error);
+    EXPECT_THROW(MappedBlockVector<int>{"/nonexistent-dir/bv.bin"}, std::system_error);
+}
+
+// Header fields chosen so the unchecked products wrap around and would slip
+// past the size and truncation checks.
+TEST(MappedBlockVector, RejectsCorruptHeaders) {
+    TempFile good("bv_mapped_good.bin");
+    {
+        MappedBlockVector<int> mv(good.path, 1024);
+        for (int i = 0; i < 3000; ++i) {
+            mv.push_back(i);
+        }
+    }
+    std::string bytes;
+    {
+        std::ifstream in(good.path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    bv::detail::MappedHeader header;
+    ASSERT_GE(bytes.size(), sizeof(header));
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    TempFile bad("bv_mapped_corrupt.bin");
+    auto rejects = [&](const bv::detail::MappedHeader& patched) {
+        std::string copy = bytes;
+        std::memcpy(&copy[0], &patched, sizeof(patched));
+        {
+            std::ofstream out(bad.path, std::ios::binary | std::ios::trunc);
+            out.write(copy.data(), static_cast<std::streamsize>(copy.size()));
+        }
+        EXPECT_THROW(MappedBlockVector<int>{bad.path}, std::runtime_error);
+    };
+
+    bv::detail::MappedHeader wrapped_stride = header;
+    wrapped_stride.block_count = UINT64_MAX / header.block_stride + 2;
+    rejects(wrapped_stride);
+
+    bv::detail::MappedHeader wrapped_size = header;
+    wrapped_size.block_count = UINT64_MAX / header.block_size + 2;
+    wrapped_size.size = 1;
+    rejects(wrapped_size);
+
+    bv::detail::MappedHeader wrapped_block = header;
+    wrapped_block.block_size = static_cast<uint64_t>(1) << 63;
+    rejects(wrapped_block);
+
+    bv::detail::MappedHeader no_header = header;
+    no_header.data_offset = 0;
+    rejects(no_header);
+
+    bv::detail::MappedHeader past_end = header;
+    past_end.data_offset = header.data_offset + (static_cast<uint64_t>(1) << 40);
+    rejects(past_end);
+
+    MappedBlockVector<int> intact(good.path);
+    EXPECT_EQ(intact.size(), 3000u);
+    EXPECT_EQ(intact[2999], 2999);
+}
+
+TEST(MappedBlockVector, MoveTransfersMapping) {
+    TempFile file("bv_mapped_move.bin");
+    MappedBlockVector<int> a(file.path, 8);
+    a.push_back(42);
+    int* first = &a[0];
+    MappedBlockVector<int> b(std::move(a));
+    EXPECT_EQ(&b[0], first);
+    EXPECT_EQ(b.size(), 1u);
+    EXPECT_EQ(a.size(), 0u);
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "BlockVector.hpp"
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace {
+struct CopyCounter {
+    static int copies;
+    static int moves;
+    int value;
+
+    explicit CopyCounter(int v = 0) : value(v) {}
+    CopyCounter(const CopyCounter& other) : value(other.value) { ++copies; }
+    CopyCounter(CopyCounter&& other) noexcept : value(other.value) { ++moves; }
+    CopyCounter& operator=(const CopyCounter&) = default;
+    CopyCounter& operator=(CopyCounter&&) = default;
+};
+int CopyCounter::copies = 0;
+int CopyCounter::moves = 0;
+} // namespace
+
+static_assert(std::is_nothrow_move_constructible<BlockVector<std::string>>::value,
+              "move construction must be noexcept");
+static_assert(std::is_nothrow_move_assignable<BlockVector<std::string>>::value,
+              "move assignment must be noexcept with std::allocator");
+static_assert(std::is_nothrow_swappable<BlockVector<std::string>>::value, "swap must be noexcept");
+
+TEST(BlockVectorMove, MoveConstructionStealsBlocks) {
+    BlockVector<std::string> a;
+    for (int i = 0; i < 1000; ++i) {
+        a.push_back(std::to_string(i));
+    }
+    const std::string* first = &a[0];
+
+    BlockVector<std::string> b(std::move(a));
+    EXPECT_EQ(b.size(), 1000u);
+    EXPECT_EQ(&b[0], first);
+    EXPECT_TRUE(a.empty());
+    a.push_back("reused");
+    EXPECT_EQ(a[0], "reused");
+
+    BlockVector<std::string> c;
+    c.push_back("old");
+    c = std::move(b);
+    EXPECT_EQ(&c[0], first);
+    EXPECT_EQ(c[999], "999");
+}
+
+TEST(BlockVectorMove, RvaluePushBackMoves) {
+    BlockVector<CopyCounter> bv;
+    CopyCounter::copies = 0;
+    CopyCounter::moves = 0;
+    for (int i = 0; i < 600; ++i) {
+        CopyCounter item(i);
+        bv.push_back(std::move(item));
+    }
+    EXPECT_EQ(CopyCounter::copies, 0);
+    EXPECT_EQ(CopyCounter::moves, 600);
+
+    CopyCounter lvalue(7);
+    bv.push_back(lvalue);
+    EXPECT_EQ(CopyCounter::copies, 1);
+    EXPECT_EQ(bv[600].value, 7);
+
+    BlockVector<std::string> strings;
+    std::string long_text(100, 'x');
+    strings.push_back(std::move(long_text));
+    EXPECT_EQ(strings[0].size(), 100u);
+}
+
+TEST(BlockVectorMove, AdlAndStdSwap) {
+    BlockVector<int> a = {1, 2, 3};
+    BlockVector<int> b = {4};
+    const int* a_first = &a[0];
+
+    using std::swap;
+    swap(a, b);
+    EXPECT_EQ(a.size(), 1u);
+    EXPECT_EQ(&b[0], a_first);
+
+    std::swap(a, b);
+    EXPECT_EQ(a.size(), 3u);
+    EXPECT_EQ(&a[0], a_first);
+
+    a.swap(b);
+    EXPECT_EQ(b[2], 3);
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include "BlockVectorParallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+BlockVector<long> make_sequence(size_t n) {
+    BlockVector<long> bv;
+    for (size_t i = 0; i < n; ++i) {
+        bv.push_back(static_cast<long>(i));
+    }
+    return bv;
+}
+}
+
+TEST(BlockVectorParallel, ForEachVisitsEveryElementOnce) {
+    bv::ThreadPool pool(4);
+    BlockVector<long> vec = make_sequence(100000);
+    bv::for_each(vec, [](long& v) { v += 1; }, pool);
+    for (size_t i = 0; i < vec.size(); ++i) {
+        ASSERT_EQ(vec[i], static_cast<long>(i) + 1);
+    }
+
+    std::atomic<long> total{0};
+    const BlockVector<long>& cref = vec;
+    bv::for_each(cref, [&](const long& v) { total += v; }, pool);
+    EXPECT_EQ(total.load(), 100000L * 100001 / 2);
+}
+
+TEST(BlockVectorParallel, TransformResizesOutput) {
+    bv::ThreadPool pool(3);
+    BlockVector<long> in = make_sequence(5000);
+    FixedBlockVector<std::string, 4> out;
+    bv::transform(in, out, [](long v) { return std::to_string(v * 2); }, pool);
+    ASSERT_EQ(out.size(), in.size());
+    EXPECT_EQ(out[0], "0");
+    EXPECT_EQ(out[4999], "9998");
+}
+
+TEST(BlockVectorParallel, ReduceAndCountIf) {
+    BlockVector<long> vec = make_sequence(123457);
+    for (size_t threads : {1u, 2u, 5u}) {
+        bv::ThreadPool pool(threads);
+        EXPECT_EQ(bv::reduce(vec, 0L, [](long a, long b) { return a + b; }, pool), 123456L * 123457 / 2);
+        EXPECT_EQ(bv::reduce(vec, pool), 123456L * 123457 / 2);
+        EXPECT_EQ(bv::count_if(vec, [](long v) { return v % 3 == 0; }, pool), 41153u);
+    }
+
+    // Non-commutative but associative: concatenation must keep block order.
+    BlockVector<std::string> words;
+    for (int i = 0; i < 2000; ++i) {
+        words.push_back(std::to_string(i % 10));
+    }
+    std::string expected;
+    for (int i = 0; i < 2000; ++i) {
+        expected += std::to_string(i % 10);
+    }
+    bv::ThreadPool pool(4);
+    EXPECT_EQ(bv::reduce(words, std::string(), std::plus<>(), pool), expected);
+
+    BlockVector<long> empty;
+    EXPECT_EQ(bv::reduce(empty, 7L, std::plus<>(), pool), 7L);
+    EXPECT_EQ(bv::count_if(empty, [](long) { return true; }, pool), 0u);
+}
+
+TEST(BlockVectorParallel, ExceptionsReachTheCaller) {
+    bv::ThreadPool pool(4);
+    BlockVector<long> vec = make_sequence(10000);
+    EXPECT_THROW(bv::for_each(vec, [](long& v) {
+        if (v == 7777) {
+            throw std::runtime_error("boom");
+        }
+    }, pool), std::runtime_error);
+    // The pool is still usable afterwards.
+    EXPECT_EQ(bv::count_if(vec, [](long v) { return v < 10; }, pool), 10u);
+}
+
+TEST(BlockVectorParallel, SortMatchesStdSort) {
+    std::mt19937_64 rng(42);
+    for (size_t threads : {1, 3, 4}) {
+        bv::ThreadPool pool(threads);
+        // Sizes below one block, exactly on block boundaries and with a short
+        // tail, so both the odd run at the end and the final copy-back run.
+        for (size_t n : {0, 1, 200, 256, 1024, 5000, 70000}) {
+            BlockVector<uint64_t> vec;
+            std::vector<uint64_t> expected;
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t v = rng() % 1000;
+                vec.push_back(v);
+                expected.push_back(v);
+            }
+            std::sort(expected.begin(), expected.end());
+            bv::sort(vec, pool);
+            EXPECT_TRUE(std::equal(vec.begin(), vec.end(), expected.begin(), expected.end())) << n;
+
+            bv::sort(vec, std::greater<>(), pool);
+            EXPECT_TRUE(std::equal(vec.begin(), vec.end(), expected.rbegin(), expected.rend())) << n;
+        }
+    }
+}
+
+// The sized constructor puts every element into one block; the sort still
+// has to cut it into runs and merge them on the pool.
+TEST(BlockVectorParallel, SortSplitsASingleLargeBlock) {
+    const size_t n = 100003;
+    BlockVector<uint64_t> vec(n);
+    ASSERT_GE(vec.get_Block_size(), n);
+    std::mt19937_64 rng(3);
+    std::vector<uint64_t> expected(n);
+    for (size_t i = 0; i < n; ++i) {
+        vec[i] = expected[i] = rng();
+    }
+    std::sort(expected.begin(), expected.end());
+    bv::ThreadPool pool(4);
+    bv::sort(vec, pool);
+    EXPECT_TRUE(std::equal(vec.begin(), vec.end(), expected.begin(), expected.end()));
+
+    BlockVector<std::pair<int, int>> pairs(n, bv::for_overwrite);
+    for (size_t i = 0; i < n; ++i) {
+        pairs[i] = {static_cast<int>(rng() % 100), static_cast<int>(i)};
+    }
+    bv::stable_sort(pairs, [](const auto& a, const auto& b) { return a.first < b.first; }, pool);
+    for (size_t i = 1; i < n; ++i) {
+        ASSERT_TRUE(pairs[i - 1].first < pairs[i].first ||
+                    (pairs[i - 1].first == pairs[i].first && pairs[i - 1].second < pairs[i].second));
+    }
+}
+
+TEST(BlockVectorParallel, StableSortKeepsEqualKeysInOrder) {
+    bv::ThreadPool pool(4);
+    FixedBlockVector<std::pair<int, std::string>, 4> vec;
+    std::vector<std::pair<int, std::string>> expected;
+    std::mt19937 rng(7);
+    for (int i = 0; i < 3001; ++i) {
+        auto entry = std::make_pair(static_cast<int>(rng() % 20), std::to_string(i));
+        vec.push_back(entry);
+        expected.push_back(entry);
+    }
+    auto by_key = [](const auto& a, const auto& b) { return a.first < b.first; };
+    std::stable_sort(expected.begin(), expected.end(), by_key);
+    bv::stable_sort(vec, by_key, pool);
+    ASSERT_EQ(vec.size(), expected.size());
+    EXPECT_TRUE(std::equal(vec.begin(), vec.end(), expected.begin()));
+}
+
+#if defined(BV_HAS_EXECUTION_POLICIES)
+TEST(BlockVectorParallel, ExecutionPolicies) {
+    BlockVector<long> vec = make_sequence(10000);
+    EXPECT_EQ(bv::reduce(std::execution::seq, vec, 0L, std::plus<>()), 9999L * 10000 / 2);
+    EXPECT_EQ(bv::count_if(std::execution::par, vec, [](long v) { return v & 1; }), 5000u);
+    bv::for_each(std::execution::par_unseq, vec, [](long& v) { v = -v; });
+    EXPECT_EQ(vec[10], -10);
+    BlockVector<long> out;
+    bv::transform(std::execution::par, vec, out, [](long v) { return v * 3; });
+    EXPECT_EQ(out[10], -30);
+    bv::sort(std::execution::par, out);
+    EXPECT_EQ(out[0], -29997);
+    bv::stable_sort(std::execution::seq, out, std::greater<>());
+    EXPECT_EQ(out[0], 0);
+}
+#endif
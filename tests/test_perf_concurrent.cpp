@@ -0,0 +1,71 @@
+#include "BlockVector.hpp"
+#include "ConcurrentBlockVector.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr size_t kPerThread = 1000000;
+
+template <typename Func>
+double time_ms(Func&& func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> elapsed = end - start;
+    return elapsed.count();
+}
+
+template <typename Body>
+void run_threads(size_t threads, Body&& body) {
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t]() { body(t); });
+    }
+    for (auto& th : pool) {
+        th.join();
+    }
+}
+
+volatile size_t sink = 0;
+}
+
+int main() {
+    size_t max_threads = std::thread::hardware_concurrency();
+    if (max_threads == 0) {
+        max_threads = 4;
+    }
+
+    std::cout << "push_back per thread: " << kPerThread << " (size_t)\n";
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        double locked = time_ms([&]() {
+            BlockVector<size_t> block;
+            std::mutex mutex;
+            run_threads(threads, [&](size_t t) {
+                for (size_t i = 0; i < kPerThread; ++i) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    block.push_back(t * kPerThread + i);
+                }
+            });
+            sink += block.size();
+        });
+
+        double concurrent = time_ms([&]() {
+            ConcurrentBlockVector<size_t> block;
+            run_threads(threads, [&](size_t t) {
+                for (size_t i = 0; i < kPerThread; ++i) {
+                    block.push_back(t * kPerThread + i);
+                }
+            });
+            sink += block.size();
+        });
+
+        std::cout << threads << " threads: mutex+BlockVector=" << locked
+                  << " ms, ConcurrentBlockVector=" << concurrent << " ms\n";
+    }
+
+    return 0;
+}
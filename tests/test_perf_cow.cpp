@@ -0,0 +1,77 @@
+#include "BlockVector.hpp"
+#include "CowBlockVector.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+namespace {
+constexpr size_t kCount = static_cast<size_t>(1) << 24;
+constexpr size_t kSnapshots = 10;
+constexpr size_t kWritesPerRound = 1000;
+
+template <typename Func>
+double time_ms(Func&& func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> elapsed = end - start;
+    return elapsed.count();
+}
+
+volatile long long sink = 0;
+}
+
+// Periodic snapshots of a large vector that takes a few random writes between
+// them: a deep BlockVector copy against a CowBlockVector snapshot.
+int main() {
+    std::cout << "Elements: " << kCount << " ints (" << (kCount * sizeof(int) >> 20) << " MiB), "
+              << kSnapshots << " snapshots, " << kWritesPerRound << " random writes between them\n";
+
+    BlockVector<int> bv;
+    CowBlockVector<int> cv;
+    for (size_t i = 0; i < kCount; ++i) {
+        bv.push_back(static_cast<int>(i));
+        cv.push_back(static_cast<int>(i));
+    }
+
+    std::mt19937 rng(9);
+    double deep_ms = 0;
+    double snap_ms = 0;
+    double deep_write_ms = 0;
+    double cow_write_ms = 0;
+    size_t cloned_blocks = 0;
+    for (size_t round = 0; round < kSnapshots; ++round) {
+        deep_ms += time_ms([&]() {
+            BlockVector<int> copy(bv);
+            sink += copy[kCount / 2];
+        });
+
+        CowBlockVector<int> snap;
+        snap_ms += time_ms([&]() { snap = cv.snapshot(); });
+
+        std::mt19937 same(rng());
+        std::mt19937 other = same;
+        deep_write_ms += time_ms([&]() {
+            for (size_t i = 0; i < kWritesPerRound; ++i) {
+                bv[same() % kCount] += 1;
+            }
+        });
+        size_t shared_before = cv.shared_block_count();
+        cow_write_ms += time_ms([&]() {
+            for (size_t i = 0; i < kWritesPerRound; ++i) {
+                cv[other() % kCount] += 1;
+            }
+        });
+        cloned_blocks += shared_before - cv.shared_block_count();
+    }
+
+    size_t block_bytes = CowBlockVector<int>::block_size() * sizeof(int);
+    std::cout << "BlockVector deep copy:     " << deep_ms / kSnapshots << " ms per snapshot, "
+              << (kCount * sizeof(int) >> 20) << " MiB each\n";
+    std::cout << "CowBlockVector snapshot:   " << snap_ms / kSnapshots << " ms per snapshot, "
+              << (cloned_blocks / kSnapshots) * block_bytes / 1024 << " KiB cloned per round by the writes\n";
+    std::cout << "writes after snapshot:     BlockVector=" << deep_write_ms / kSnapshots
+              << " ms, CowBlockVector=" << cow_write_ms / kSnapshots << " ms per round\n";
+    return 0;
+}
@@ -1,7 +1,11 @@
 #include "BlockVector.hpp"
+#include "GeometricBlockVector.hpp"
 
 #include <chrono>
+#include <cstdint>
 #include <iostream>
+#include <memory_resource>
+#include <random>
 #include <vector>
 
 namespace {
@@ -67,6 +71,23 @@ int main() {
         sink += block.back().payload[0];
     });
 
+    double block_pmr_push = avg_ms(kRounds, [&]() {
+        std::pmr::monotonic_buffer_resource arena;
+        pmr::BlockVector<Heavy> block(&arena);
+        for (size_t i = 0; i < count; ++i) {
+            block.push_back(Heavy(static_cast<int>(i)));
+        }
+        sink += block.back().payload[0];
+    });
+
+    double block_stats_push = avg_ms(kRounds, [&]() {
+        BlockVector<Heavy, std::allocator<Heavy>, bv::dynamic_block_shift, bv::BasicStats> block;
+        for (size_t i = 0; i < count; ++i) {
+            block.push_back(Heavy(static_cast<int>(i)));
+        }
+        sink += block.back().payload[0] + block.stats_snapshot().block_allocations;
+    });
+
     double std_push = avg_ms(kRounds, [&]() {
         std::vector<Heavy> standard;
         for (size_t i = 0; i < count; ++i) {
@@ -87,10 +108,89 @@ int main() {
         sink += standard.back().payload[0];
     });
 
+    // Resize then overwrite every element, as when filling from a file.
+    const size_t fill_count = count * 64;
+    double fill_value_init = avg_ms(kRounds, [&]() {
+        BlockVector<uint64_t> block;
+        block.resize(fill_count);
+        block.for_each_segment([](bv::BlockSpan<uint64_t> seg) {
+            for (uint64_t& value : seg) {
+                value = reinterpret_cast<uintptr_t>(&value);
+            }
+        });
+        sink += static_cast<size_t>(block.back());
+    });
+
+    double fill_default_init = avg_ms(kRounds, [&]() {
+        BlockVector<uint64_t> block;
+        block.resize_default_init(fill_count);
+        block.for_each_segment([](bv::BlockSpan<uint64_t> seg) {
+            for (uint64_t& value : seg) {
+                value = reinterpret_cast<uintptr_t>(&value);
+            }
+        });
+        sink += static_cast<size_t>(block.back());
+    });
+
+    // Huge container: fixed 256-element blocks need a table of 128K pointers
+    // that is reallocated as it grows; geometric blocks need 18 table slots.
+    const size_t huge_count = static_cast<size_t>(1) << 25;
+    double fixed_huge_push = avg_ms(kRounds, [&]() {
+        BlockVector<int> block;
+        for (size_t i = 0; i < huge_count; ++i) {
+            block.push_back(static_cast<int>(i));
+        }
+        sink += static_cast<size_t>(block.back());
+    });
+
+    double geometric_huge_push = avg_ms(kRounds, [&]() {
+        GeometricBlockVector<int> block;
+        for (size_t i = 0; i < huge_count; ++i) {
+            block.push_back(static_cast<int>(i));
+        }
+        sink += static_cast<size_t>(block.back());
+    });
+
+    std::vector<size_t> probes(static_cast<size_t>(1) << 22);
+    std::mt19937_64 rng(7);
+    for (size_t& probe_index : probes) {
+        probe_index = static_cast<size_t>(rng() % huge_count);
+    }
+    BlockVector<int> fixed_huge;
+    GeometricBlockVector<int> geometric_huge;
+    for (size_t i = 0; i < huge_count; ++i) {
+        fixed_huge.push_back(static_cast<int>(i));
+        geometric_huge.push_back(static_cast<int>(i));
+    }
+
+    double fixed_huge_random = avg_ms(kRounds, [&]() {
+        size_t sum = 0;
+        for (size_t index : probes) {
+            sum += static_cast<size_t>(fixed_huge[index]);
+        }
+        sink += sum;
+    });
+
+    double geometric_huge_random = avg_ms(kRounds, [&]() {
+        size_t sum = 0;
+        for (size_t index : probes) {
+            sum += static_cast<size_t>(geometric_huge[index]);
+        }
+        sink += sum;
+    });
+
     std::cout << "push_back (no reserve): BlockVector=" << block_push
               << " ms, std::vector=" << std_push << " ms\n";
+    std::cout << "push_back (pmr arena):  BlockVector=" << block_pmr_push << " ms\n";
+    std::cout << "push_back (BasicStats): BlockVector=" << block_stats_push << " ms\n";
     std::cout << "resize up:              BlockVector=" << block_resize
               << " ms, std::vector=" << std_resize << " ms\n";
+    std::cout << "resize + overwrite " << fill_count << " uint64: resize=" << fill_value_init
+              << " ms, resize_default_init=" << fill_default_init << " ms\n";
+    std::cout << "push_back " << huge_count << " int: fixed blocks=" << fixed_huge_push
+              << " ms, geometric blocks=" << geometric_huge_push << " ms\n";
+    std::cout << "random read " << probes.size() << " of them: fixed blocks=" << fixed_huge_random
+              << " ms, geometric blocks=" << geometric_huge_random << " ms\n";
 
     return 0;
 }
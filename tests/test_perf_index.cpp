@@ -1,6 +1,8 @@
 #include "BlockVector.hpp"
+#include "HugePageResource.hpp"
 
 #include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <random>
 #include <vector>
@@ -98,5 +100,45 @@ int main() {
     std::cout << "index rand: BlockVector=" << block_rand << " ms, std::vector=" << std_rand
               << " ms\n";
 
+    // Random reads over a container far larger than the TLB reach of 4 KB
+    // pages: heap blocks vs blocks carved from huge-page arenas.
+    const size_t big_count = static_cast<size_t>(1) << 26;
+    std::vector<size_t> big_indices(count * 8);
+    std::uniform_int_distribution<size_t> big_dist(0, big_count - 1);
+    for (size_t& idx : big_indices) {
+        idx = big_dist(rng);
+    }
+
+    auto random_sum = [&](const auto& vec) {
+        return avg_ms(kRounds, [&]() {
+            uint64_t sum = 0;
+            for (size_t idx : big_indices) {
+                sum += vec[idx];
+            }
+            sink += static_cast<size_t>(sum);
+        });
+    };
+
+    double heap_rand = 0.0;
+    {
+        BlockVector<uint64_t> heap_blocks;
+        heap_blocks.resize(big_count);
+        heap_rand = random_sum(heap_blocks);
+    }
+
+    bv::HugePageResource huge;
+    double huge_rand = 0.0;
+    {
+        pmr::BlockVector<uint64_t> huge_blocks(&huge);
+        huge_blocks.resize(big_count);
+        huge_rand = random_sum(huge_blocks);
+    }
+
+    std::cout << "\nRandom access over " << big_count << " uint64 (" << (big_count * 8 >> 20) << " MiB), "
+              << big_indices.size() << " reads\n";
+    std::cout << "heap blocks:      " << heap_rand << " ms\n";
+    std::cout << "huge-page arenas: " << huge_rand << " ms"
+              << (huge.huge_page_advice_accepted() ? "" : " (MADV_HUGEPAGE rejected)") << "\n";
+
     return 0;
 }
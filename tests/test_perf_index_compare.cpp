@@ -36,15 +36,46 @@ double avg_ms(size_t rounds, Func&& func) {
 }
 
 volatile size_t sink = 0;
+
+using RuntimeVec = BlockVector<Heavy>;
+using FixedVec = FixedBlockVector<Heavy, 8>;
+using DivVec = BlockVectorDiv<Heavy>;
+
+// Out-of-line accessors so the generated code for each addressing scheme can
+// be compared directly, e.g. `objdump -d --no-show-raw-insn test_perf_index_compare`
+// or `g++ -O2 -S`: the runtime version loads block_shift_/block_mask_ from the
+// object, the fixed version uses immediate shift/and, and the div version divides.
+#if defined(__GNUC__)
+#define BV_NOINLINE __attribute__((noinline))
+#else
+#define BV_NOINLINE
+#endif
+
+BV_NOINLINE int load_runtime(const RuntimeVec& v, size_t i) { return v[i].payload[0]; }
+BV_NOINLINE int load_fixed(const FixedVec& v, size_t i) { return v[i].payload[0]; }
+BV_NOINLINE int load_div(const DivVec& v, size_t i) { return v[i].payload[0]; }
+
+template <typename Vec, typename Load>
+double index_sum_ms(const Vec& vec, size_t count, Load load) {
+    return avg_ms(kRounds, [&]() {
+        size_t sum = 0;
+        for (size_t i = 0; i < count; ++i) {
+            sum += static_cast<size_t>(load(vec, i));
+        }
+        sink += sum;
+    });
+}
 }
 
 int main() {
     BlockVector<int> probe;
     const size_t count = probe.get_Block_size() * 1000;
 
-    BlockVector<Heavy> shift_vec;
-    BlockVectorDiv<Heavy> div_vec;
+    RuntimeVec shift_vec;
+    FixedVec fixed_vec;
+    DivVec div_vec;
     shift_vec.resize(count);
+    fixed_vec.resize(count);
     div_vec.resize(count);
 
     std::cout << "Benchmark count: " << count << " (Heavy objects)\n";
@@ -57,6 +88,14 @@ int main() {
         sink += sum;
     });
 
+    double fixed_index = avg_ms(kRounds, [&]() {
+        size_t sum = 0;
+        for (size_t i = 0; i < count; ++i) {
+            sum += static_cast<size_t>(fixed_vec[i].payload[0]);
+        }
+        sink += sum;
+    });
+
     double div_index = avg_ms(kRounds, [&]() {
         size_t sum = 0;
         for (size_t i = 0; i < count; ++i) {
@@ -65,8 +104,17 @@ int main() {
         sink += sum;
     });
 
+    double shift_call = index_sum_ms(shift_vec, count, load_runtime);
+    double fixed_call = index_sum_ms(fixed_vec, count, load_fixed);
+    double div_call = index_sum_ms(div_vec, count, load_div);
+
+    std::cout << "sizeof: runtime=" << sizeof(RuntimeVec) << " fixed=" << sizeof(FixedVec)
+              << " div=" << sizeof(DivVec) << " bytes\n";
     std::cout << "BlockVector shift index: " << shift_index << " ms\n";
+    std::cout << "BlockVector fixed index: " << fixed_index << " ms\n";
     std::cout << "BlockVector div index:   " << div_index << " ms\n";
+    std::cout << "out-of-line load: runtime=" << shift_call << " ms, fixed=" << fixed_call
+              << " ms, div=" << div_call << " ms\n";
 
     return 0;
 }
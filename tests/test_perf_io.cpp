@@ -0,0 +1,97 @@
+#include "BlockVector.hpp"
+#include "BlockVectorIO.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+struct Record {
+    uint64_t id;
+    double value;
+};
+
+template <typename Func>
+double time_ms(Func&& func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> elapsed = end - start;
+    return elapsed.count();
+}
+
+volatile size_t sink = 0;
+}
+
+// Usage: test_perf_io [checkpoint file]
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : "/tmp/blockvector_perf_io.bin";
+    const size_t count = static_cast<size_t>(1) << 22;
+
+    BlockVector<Record> source;
+    for (size_t i = 0; i < count; ++i) {
+        source.push_back(Record{i, i * 0.5});
+    }
+    std::cout << "Checkpoint " << count << " records (" << (count * sizeof(Record) >> 20) << " MiB)\n";
+
+    // Ad-hoc baseline: one stream write/read per element.
+    double per_element_save = time_ms([&]() {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        uint64_t n = source.size();
+        out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+        for (const Record& record : source) {
+            out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        }
+    });
+
+    double per_element_load = time_ms([&]() {
+        std::ifstream in(path, std::ios::binary);
+        uint64_t n = 0;
+        in.read(reinterpret_cast<char*>(&n), sizeof(n));
+        BlockVector<Record> loaded;
+        Record record;
+        for (uint64_t i = 0; i < n && in.read(reinterpret_cast<char*>(&record), sizeof(record)); ++i) {
+            loaded.push_back(record);
+        }
+        sink += loaded.size();
+    });
+
+    double stream_save = time_ms([&]() {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        bv::save(source, out);
+    });
+
+    double stream_load = time_ms([&]() {
+        std::ifstream in(path, std::ios::binary);
+        BlockVector<Record> loaded;
+        bv::load(loaded, in);
+        sink += loaded.size();
+    });
+
+    double fd_save = time_ms([&]() {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        bv::save(source, fd);
+        ::close(fd);
+    });
+
+    double fd_load = time_ms([&]() {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        BlockVector<Record> loaded;
+        bv::load(loaded, fd);
+        ::close(fd);
+        sink += loaded.size();
+    });
+
+    std::cout << "per-element stream: save=" << per_element_save << " ms, load=" << per_element_load << " ms\n";
+    std::cout << "bv::save/load stream: save=" << stream_save << " ms, load=" << stream_load << " ms\n";
+    std::cout << "bv::save/load fd:     save=" << fd_save << " ms, load=" << fd_load << " ms\n";
+
+    std::remove(path.c_str());
+    return 0;
+}
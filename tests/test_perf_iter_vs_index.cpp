@@ -1,4 +1,5 @@
 #include "BlockVector.hpp"
+#include "BlockVectorSimd.hpp"
 
 #include <chrono>
 #include <iostream>
@@ -6,6 +7,7 @@
 
 namespace {
 constexpr size_t kRounds = 3;
+constexpr size_t kIntRounds = 50;
 
 struct Heavy {
     int payload[64];
@@ -86,5 +88,37 @@ int main() {
     std::cout << "std::vector index: " << std_index << " ms\n";
     std::cout << "std::vector iter:  " << std_iter << " ms\n";
 
+    // Plain int payload sized to stay cache resident: scalar iterator loop vs
+    // the block-wise SIMD kernels.
+    const size_t int_count = count * 2;
+    BlockVector<int> ints;
+    for (size_t i = 0; i < int_count; ++i) {
+        ints.push_back(static_cast<int>(i & 1023));
+    }
+
+    double int_iter = avg_ms(kIntRounds, [&]() {
+        long long sum = 0;
+        for (auto it = ints.begin(); it != ints.end(); ++it) {
+            sum += *it;
+        }
+        sink += static_cast<size_t>(sum);
+    });
+
+    std::cout << "\nBenchmark count: " << int_count << " (int)\n";
+    std::cout << "BlockVector<int> iter sum: " << int_iter << " ms\n";
+    const bv::simd::Isa levels[] = {bv::simd::Isa::scalar, bv::simd::Isa::sse2, bv::simd::Isa::avx2};
+    const char* names[] = {"scalar", "sse2", "avx2"};
+    for (size_t l = 0; l < 3; ++l) {
+        bv::simd::set_max_isa(levels[l]);
+        if (bv::simd::active_isa() != levels[l]) {
+            continue;
+        }
+        double simd_sum = avg_ms(kIntRounds, [&]() { sink += static_cast<size_t>(bv::simd::sum(ints)); });
+        double simd_find = avg_ms(kIntRounds, [&]() { sink += bv::simd::find(ints, -1); });
+        std::cout << "bv::simd::sum  (" << names[l] << "): " << simd_sum << " ms ("
+                  << int_iter / simd_sum << "x)\n";
+        std::cout << "bv::simd::find (" << names[l] << "): " << simd_find << " ms\n";
+    }
+
     return 0;
 }
@@ -0,0 +1,72 @@
+#include "BlockVector.hpp"
+#include "MappedBlockVector.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace {
+template <typename Func>
+double time_ms(Func&& func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> elapsed = end - start;
+    return elapsed.count();
+}
+
+volatile size_t sink = 0;
+}
+
+// Usage: test_perf_mapped [backing file]
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : "/tmp/blockvector_perf_mapped.bin";
+    const size_t count = static_cast<size_t>(1) << 24;
+    std::remove(path.c_str());
+
+    std::cout << "Benchmark count: " << count << " (uint64_t, " << (count * 8 >> 20) << " MiB)\n";
+
+    double rebuild = time_ms([&]() {
+        BlockVector<uint64_t> block;
+        for (size_t i = 0; i < count; ++i) {
+            block.push_back(i * 2654435761u);
+        }
+        sink += block.size();
+    });
+
+    double create = time_ms([&]() {
+        MappedBlockVector<uint64_t> mapped(path);
+        mapped.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            mapped.push_back(i * 2654435761u);
+        }
+        sink += mapped.size();
+    });
+
+    double reopen = 0.0;
+    double first_scan = 0.0;
+    {
+        std::unique_ptr<MappedBlockVector<uint64_t>> mapped;
+        reopen = time_ms([&]() { mapped.reset(new MappedBlockVector<uint64_t>(path)); });
+        first_scan = time_ms([&]() {
+            uint64_t sum = 0;
+            mapped->for_each_segment([&](bv::BlockSpan<const uint64_t> seg) {
+                for (uint64_t value : seg) {
+                    sum += value;
+                }
+            });
+            sink += static_cast<size_t>(sum);
+        });
+    }
+
+    std::cout << "rebuild BlockVector in memory: " << rebuild << " ms\n";
+    std::cout << "create mapped file:            " << create << " ms\n";
+    std::cout << "reopen mapped file:            " << reopen << " ms\n";
+    std::cout << "first full scan after reopen:  " << first_scan << " ms\n";
+
+    std::remove(path.c_str());
+    return 0;
+}
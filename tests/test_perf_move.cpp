@@ -0,0 +1,93 @@
+#include "BlockVector.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr size_t kRounds = 5;
+
+// Movable element that owns a heap buffer, so a copy is expensive.
+struct Heavy {
+    std::vector<int> payload;
+
+    explicit Heavy(int seed = 0) : payload(256, seed) {}
+};
+
+template <typename Func>
+double time_ms(Func&& func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> elapsed = end - start;
+    return elapsed.count();
+}
+
+template <typename Func>
+double avg_ms(size_t rounds, Func&& func) {
+    double total = 0.0;
+    for (size_t i = 0; i < rounds; ++i) {
+        total += time_ms(func);
+    }
+    return total / static_cast<double>(rounds);
+}
+
+volatile size_t sink = 0;
+}
+
+int main() {
+    BlockVector<int> probe;
+    const size_t block_size = probe.get_Block_size();
+
+    std::cout << "Container move (element count -> ms per move, copy for reference)\n";
+    for (size_t count : {block_size * 10, block_size * 100, block_size * 1000}) {
+        BlockVector<std::string> source;
+        for (size_t i = 0; i < count; ++i) {
+            source.push_back(std::to_string(i));
+        }
+
+        double move_ms = avg_ms(kRounds, [&]() {
+            BlockVector<std::string> moved(std::move(source));
+            sink += moved.size();
+            source = std::move(moved);
+        }) / 2.0;
+        double copy_ms = avg_ms(kRounds, [&]() {
+            BlockVector<std::string> copied(source);
+            sink += copied.size();
+        });
+        std::cout << count << ": move=" << move_ms << " ms, copy=" << copy_ms << " ms\n";
+    }
+
+    const size_t count = block_size * 40;
+    std::vector<Heavy> items(count, Heavy(1));
+
+    double push_copy = avg_ms(kRounds, [&]() {
+        BlockVector<Heavy> block;
+        for (size_t i = 0; i < count; ++i) {
+            block.push_back(items[i]);
+        }
+        sink += block.size();
+    });
+
+    // Fresh sources are prepared outside the timed region for every round.
+    double push_move = 0.0;
+    for (size_t round = 0; round < kRounds; ++round) {
+        std::vector<Heavy> local(items);
+        push_move += time_ms([&]() {
+            BlockVector<Heavy> block;
+            for (size_t i = 0; i < count; ++i) {
+                block.push_back(std::move(local[i]));
+            }
+            sink += block.size();
+        });
+    }
+    push_move /= static_cast<double>(kRounds);
+
+    std::cout << "\npush_back " << count << " Heavy (256 ints on the heap)\n";
+    std::cout << "push_back(const T&): " << push_copy << " ms\n";
+    std::cout << "push_back(T&&):      " << push_move << " ms\n";
+
+    return 0;
+}
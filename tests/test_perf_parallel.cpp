@@ -0,0 +1,69 @@
+#include "BlockVector.hpp"
+#include "BlockVectorParallel.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+namespace {
+constexpr size_t kCount = 20000000;
+constexpr size_t kRounds = 3;
+
+template <typename Func>
+double time_ms(Func&& func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> elapsed = end - start;
+    return elapsed.count();
+}
+
+template <typename Func>
+double avg_ms(size_t rounds, Func&& func) {
+    double total = 0.0;
+    for (size_t i = 0; i < rounds; ++i) {
+        total += time_ms(func);
+    }
+    return total / static_cast<double>(rounds);
+}
+
+volatile double sink = 0;
+}
+
+int main() {
+    BlockVector<double> data;
+    data.reserve(kCount);
+    for (size_t i = 0; i < kCount; ++i) {
+        data.push_back(static_cast<double>(i % 1000) * 0.5);
+    }
+
+    size_t hw = std::thread::hardware_concurrency();
+    std::cout << "Benchmark count: " << kCount << " (double), hardware threads: " << hw << "\n";
+
+    double serial_reduce = avg_ms(kRounds, [&]() {
+        double sum = 0;
+        for (size_t i = 0; i < data.size(); ++i) {
+            sum += std::sqrt(data[i]);
+        }
+        sink += sum;
+    });
+    std::cout << "serial index loop:   reduce(sqrt)=" << serial_reduce << " ms\n";
+
+    for (size_t threads = 1; threads <= (hw == 0 ? 4 : hw); threads *= 2) {
+        bv::ThreadPool pool(threads);
+        double par_reduce = avg_ms(kRounds, [&]() {
+            sink += bv::reduce(data, 0.0, [](double acc, double v) { return acc + std::sqrt(v); }, pool);
+        });
+        double par_count = avg_ms(kRounds, [&]() {
+            sink += static_cast<double>(bv::count_if(data, [](double v) { return v > 250.0; }, pool));
+        });
+        double par_for_each = avg_ms(kRounds, [&]() {
+            bv::for_each(data, [](double& v) { v = v * 1.0000001; }, pool);
+        });
+        std::cout << threads << " threads: reduce(sqrt)=" << par_reduce << " ms, count_if=" << par_count
+                  << " ms, for_each=" << par_for_each << " ms\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include "BlockVector.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// The same scans over containers with the default prefetch policy and with
+// bv::NoPrefetch.
+namespace {
+constexpr size_t kRounds = 3;
+// 2^20 Heavy objects are 256 MiB, well past the last-level cache.
+constexpr size_t kCount = static_cast<size_t>(1) << 20;
+// Containers grown side by side, so consecutive blocks of one container are
+// not neighbours in the heap.
+constexpr size_t kInterleaved = 4;
+
+struct Heavy {
+    int payload[64];
+
+    explicit Heavy(int seed = 0) {
+        for (size_t i = 0; i < 64; ++i) {
+            payload[i] = seed + static_cast<int>(i);
+        }
+    }
+};
+
+template <typename Func>
+double time_ms(Func&& func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> elapsed = end - start;
+    return elapsed.count();
+}
+
+template <typename Func>
+double avg_ms(size_t rounds, Func&& func) {
+    double total = 0.0;
+    for (size_t i = 0; i < rounds; ++i) {
+        total += time_ms(func);
+    }
+    return total / static_cast<double>(rounds);
+}
+
+volatile size_t sink = 0;
+
+template <typename Prefetch>
+void run(const char* label, size_t block_size) {
+    using Vec = BlockVector<Heavy, std::allocator<Heavy>, bv::dynamic_block_shift, bv::NoStats, Prefetch>;
+    std::vector<Vec> containers(kInterleaved);
+    for (auto& c : containers) {
+        c.set_Block_size(block_size);
+    }
+    for (size_t i = 0; i < kCount / kInterleaved; ++i) {
+        for (auto& c : containers) {
+            c.emplace_back(static_cast<int>(i));
+        }
+    }
+
+    double iter_ms = avg_ms(kRounds, [&]() {
+        size_t sum = 0;
+        for (const auto& c : containers) {
+            for (auto it = c.begin(); it != c.end(); ++it) {
+                sum += static_cast<size_t>(it->payload[0]);
+            }
+        }
+        sink += sum;
+    });
+    double segment_ms = avg_ms(kRounds, [&]() {
+        size_t sum = 0;
+        for (const auto& c : containers) {
+            c.for_each_segment([&](bv::BlockSpan<const Heavy> seg) {
+                for (const Heavy& h : seg) {
+                    sum += static_cast<size_t>(h.payload[0]);
+                }
+            });
+        }
+        sink += sum;
+    });
+    double range_ms = avg_ms(kRounds, [&]() {
+        size_t sum = 0;
+        for (const auto& c : containers) {
+            for (auto seg : c.segments()) {
+                for (const Heavy& h : seg) {
+                    sum += static_cast<size_t>(h.payload[0]);
+                }
+            }
+        }
+        sink += sum;
+    });
+
+    std::cout << label << ", block size " << block_size << " (" << block_size * sizeof(Heavy) / 1024 << " KiB blocks): "
+              << "iterator=" << iter_ms << " ms, for_each_segment=" << segment_ms
+              << " ms, segments()=" << range_ms << " ms\n";
+}
+}
+
+int main() {
+    std::cout << "Heavy objects: " << kCount << " (" << (kCount * sizeof(Heavy) >> 20) << " MiB) in "
+              << kInterleaved << " interleaved containers, default prefetch: " << bv::DefaultPrefetch::distance
+              << " blocks ahead, " << bv::DefaultPrefetch::lines << " lines\n";
+    for (size_t block_size : {16, 256}) {
+        run<bv::NoPrefetch>("no prefetch", block_size);
+        run<bv::DefaultPrefetch>("prefetch   ", block_size);
+    }
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "BlockVector.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace {
+constexpr size_t kRounds = 10;
+
+template <typename Func>
+double time_ms(Func&& func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> elapsed = end - start;
+    return elapsed.count();
+}
+
+template <typename Func>
+double avg_ms(size_t rounds, Func&& func) {
+    double total = 0.0;
+    for (size_t i = 0; i < rounds; ++i) {
+        total += time_ms(func);
+    }
+    return total / static_cast<double>(rounds);
+}
+
+volatile long long sink = 0;
+}
+
+int main() {
+    BlockVector<int> probe;
+    const size_t count = probe.get_Block_size() * 20000;
+
+    BlockVector<int> block;
+    std::vector<int> standard;
+    for (size_t i = 0; i < count; ++i) {
+        block.push_back(static_cast<int>(i & 0xff));
+        standard.push_back(static_cast<int>(i & 0xff));
+    }
+
+    std::cout << "Benchmark count: " << count << " (int sum)\n";
+
+    double block_index = avg_ms(kRounds, [&]() {
+        long long sum = 0;
+        for (size_t i = 0; i < count; ++i) {
+            sum += block[i];
+        }
+        sink += sum;
+    });
+
+    double block_iter = avg_ms(kRounds, [&]() {
+        long long sum = 0;
+        for (auto it = block.begin(); it != block.end(); ++it) {
+            sum += *it;
+        }
+        sink += sum;
+    });
+
+    double block_segments = avg_ms(kRounds, [&]() {
+        long long sum = 0;
+        for (auto seg : block.segments()) {
+            for (int v : seg) {
+                sum += v;
+            }
+        }
+        sink += sum;
+    });
+
+    double block_for_each = avg_ms(kRounds, [&]() {
+        long long sum = 0;
+        block.for_each_segment([&](bv::BlockSpan<int> seg) {
+            const int* data = seg.data();
+            const size_t n = seg.size();
+            long long local = 0;
+            for (size_t i = 0; i < n; ++i) {
+                local += data[i];
+            }
+            sum += local;
+        });
+        sink += sum;
+    });
+
+    double std_index = avg_ms(kRounds, [&]() {
+        long long sum = 0;
+        for (size_t i = 0; i < count; ++i) {
+            sum += standard[i];
+        }
+        sink += sum;
+    });
+
+    std::cout << "BlockVector index:            " << block_index << " ms\n";
+    std::cout << "BlockVector iter:             " << block_iter << " ms\n";
+    std::cout << "BlockVector segments():       " << block_segments << " ms\n";
+    std::cout << "BlockVector for_each_segment: " << block_for_each << " ms\n";
+    std::cout << "std::vector index:            " << std_index << " ms\n";
+
+    return 0;
+}
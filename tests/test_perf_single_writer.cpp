@@ -0,0 +1,107 @@
+#include "BlockVector.hpp"
+#include "SingleWriterBlockVector.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr size_t kCount = static_cast<size_t>(1) << 21;
+constexpr size_t kReaders = 3;
+
+template <typename Func>
+double time_ms(Func&& func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> elapsed = end - start;
+    return elapsed.count();
+}
+
+volatile long long sink = 0;
+
+// Baseline: a BlockVector guarded by a reader/writer lock. Readers hold the
+// shared lock while they scan the elements appended since their last pass.
+void run_locked() {
+    BlockVector<long long> bv;
+    std::shared_mutex mutex;
+    std::atomic<bool> done{false};
+    std::atomic<size_t> scanned{0};
+
+    std::vector<std::thread> readers;
+    for (size_t r = 0; r < kReaders; ++r) {
+        readers.emplace_back([&]() {
+            size_t seen = 0;
+            long long sum = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                std::shared_lock<std::shared_mutex> lock(mutex);
+                size_t n = bv.size();
+                for (size_t i = seen; i < n; ++i) {
+                    sum += bv[i];
+                }
+                scanned += n - seen;
+                seen = n;
+            }
+            sink += sum;
+        });
+    }
+    double write_ms = time_ms([&]() {
+        for (size_t i = 0; i < kCount; ++i) {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            bv.push_back(static_cast<long long>(i));
+        }
+    });
+    done.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    std::cout << "BlockVector + shared_mutex:  writer " << write_ms << " ms, readers scanned "
+              << scanned.load() << " elements\n";
+}
+
+void run_published() {
+    SingleWriterBlockVector<long long> sv;
+    std::atomic<bool> done{false};
+    std::atomic<size_t> scanned{0};
+
+    std::vector<std::thread> readers;
+    for (size_t r = 0; r < kReaders; ++r) {
+        readers.emplace_back([&]() {
+            size_t seen = 0;
+            long long sum = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                size_t n = sv.size();
+                for (size_t i = seen; i < n; ++i) {
+                    sum += sv[i];
+                }
+                scanned += n - seen;
+                seen = n;
+            }
+            sink += sum;
+        });
+    }
+    double write_ms = time_ms([&]() {
+        for (size_t i = 0; i < kCount; ++i) {
+            sv.push_back(static_cast<long long>(i));
+        }
+    });
+    done.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    std::cout << "SingleWriterBlockVector:     writer " << write_ms << " ms, readers scanned "
+              << scanned.load() << " elements\n";
+}
+}
+
+int main() {
+    std::cout << "Appending " << kCount << " elements with " << kReaders << " concurrent readers ("
+              << std::thread::hardware_concurrency() << " hardware threads)\n";
+    run_locked();
+    run_published();
+    return 0;
+}
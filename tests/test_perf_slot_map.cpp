@@ -0,0 +1,129 @@
+#include "BlockSlotMap.hpp"
+#include "BlockVector.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr size_t kRounds = 5;
+constexpr size_t kCount = static_cast<size_t>(1) << 20;
+
+struct Entity {
+    float position[3];
+    float velocity[3];
+    int id;
+    int flags;
+};
+
+// The hand-rolled store this replaces: a live flag per slot and a linear
+// scan over every slot, holes included.
+struct FlaggedEntity {
+    bool live;
+    Entity entity;
+};
+
+template <typename Func>
+double time_ms(Func&& func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> elapsed = end - start;
+    return elapsed.count();
+}
+
+template <typename Func>
+double avg_ms(size_t rounds, Func&& func) {
+    double total = 0.0;
+    for (size_t i = 0; i < rounds; ++i) {
+        total += time_ms(func);
+    }
+    return total / static_cast<double>(rounds);
+}
+
+volatile long long sink = 0;
+
+// Erases 30% of the slots, either scattered at random or as runs of 64.
+void run_case(const char* label, bool clustered) {
+    BlockSlotMap<Entity> map;
+    BlockVector<FlaggedEntity> flagged;
+    std::vector<BlockSlotMap<Entity>::handle> handles;
+    handles.reserve(kCount);
+    for (size_t i = 0; i < kCount; ++i) {
+        Entity e{{0, 0, 0}, {1, 1, 1}, static_cast<int>(i), 0};
+        handles.push_back(map.insert(e));
+        flagged.push_back(FlaggedEntity{true, e});
+    }
+
+    std::vector<size_t> order;
+    std::mt19937 rng(3);
+    if (clustered) {
+        for (size_t run = 0; run < kCount / 64; ++run) {
+            order.push_back(run);
+        }
+        std::shuffle(order.begin(), order.end(), rng);
+        order.resize(order.size() * 3 / 10);
+        std::vector<size_t> slots;
+        for (size_t run : order) {
+            for (size_t i = 0; i < 64; ++i) {
+                slots.push_back(run * 64 + i);
+            }
+        }
+        order.swap(slots);
+    } else {
+        order.resize(kCount);
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), rng);
+        order.resize(kCount * 3 / 10);
+    }
+    double erase_ms = time_ms([&]() {
+        for (size_t slot : order) {
+            map.erase(handles[slot]);
+        }
+    });
+    for (size_t slot : order) {
+        flagged[slot].live = false;
+    }
+
+    double slot_map_iter = avg_ms(kRounds, [&]() {
+        long long sum = 0;
+        for (const Entity& e : map) {
+            sum += e.id;
+        }
+        sink += sum;
+    });
+
+    double scan_iter = avg_ms(kRounds, [&]() {
+        long long sum = 0;
+        for (const FlaggedEntity& f : flagged) {
+            if (f.live) {
+                sum += f.entity.id;
+            }
+        }
+        sink += sum;
+    });
+
+    std::cout << label << ": erase " << order.size() << " = " << erase_ms << " ms; iterate "
+              << map.size() << " live: BlockSlotMap=" << slot_map_iter << " ms, flag scan=" << scan_iter << " ms\n";
+}
+}
+
+int main() {
+    std::cout << "Slots: " << kCount << " (Entity, " << sizeof(Entity) << " bytes)\n";
+
+    double insert_ms = avg_ms(kRounds, [&]() {
+        BlockSlotMap<Entity> map;
+        for (size_t i = 0; i < kCount; ++i) {
+            map.insert(Entity{{0, 0, 0}, {0, 0, 0}, static_cast<int>(i), 0});
+        }
+        sink += static_cast<long long>(map.size());
+    });
+    std::cout << "insert: " << insert_ms << " ms\n";
+
+    run_case("30% scattered holes", false);
+    run_case("30% holes in runs of 64", true);
+    return 0;
+}
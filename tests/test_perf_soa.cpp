@@ -0,0 +1,100 @@
+#include "BlockSoA.hpp"
+#include "BlockVector.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+namespace {
+constexpr size_t kRounds = 10;
+constexpr size_t kCount = static_cast<size_t>(1) << 22;
+
+// A 64-byte record where a typical scan reads one field.
+struct Record {
+    double position[3];
+    double velocity[3];
+    float mass;
+    int32_t id;
+    uint64_t flags;
+};
+static_assert(sizeof(Record) == 64, "Record should fill one cache line");
+
+using RecordColumns = BlockSoA<double, double, double, double, double, double, float, int32_t, uint64_t>;
+constexpr size_t kMass = 6;
+
+template <typename Func>
+double time_ms(Func&& func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> elapsed = end - start;
+    return elapsed.count();
+}
+
+template <typename Func>
+double avg_ms(size_t rounds, Func&& func) {
+    double total = 0.0;
+    for (size_t i = 0; i < rounds; ++i) {
+        total += time_ms(func);
+    }
+    return total / static_cast<double>(rounds);
+}
+
+volatile double sink = 0;
+}
+
+int main() {
+    BlockVector<Record> rows;
+    RecordColumns columns;
+    for (size_t i = 0; i < kCount; ++i) {
+        double d = static_cast<double>(i);
+        float mass = static_cast<float>(i % 1000);
+        rows.push_back(Record{{d, d, d}, {1, 1, 1}, mass, static_cast<int32_t>(i), 0});
+        columns.emplace_back(d, d, d, 1.0, 1.0, 1.0, mass, static_cast<int32_t>(i), uint64_t(0));
+    }
+
+    std::cout << "Benchmark count: " << kCount << " (Record, " << sizeof(Record)
+              << " bytes), summing the mass field\n";
+
+    double aos_index = avg_ms(kRounds, [&]() {
+        double sum = 0;
+        for (size_t i = 0; i < kCount; ++i) {
+            sum += rows[i].mass;
+        }
+        sink = sink + sum;
+    });
+
+    double aos_segments = avg_ms(kRounds, [&]() {
+        double sum = 0;
+        rows.for_each_segment([&](bv::BlockSpan<Record> seg) {
+            for (const Record& r : seg) {
+                sum += r.mass;
+            }
+        });
+        sink = sink + sum;
+    });
+
+    double soa_index = avg_ms(kRounds, [&]() {
+        double sum = 0;
+        for (size_t i = 0; i < kCount; ++i) {
+            sum += columns.get<kMass>(i);
+        }
+        sink = sink + sum;
+    });
+
+    double soa_segments = avg_ms(kRounds, [&]() {
+        double sum = 0;
+        columns.for_each_segment<kMass>([&](bv::BlockSpan<float> seg) {
+            for (float mass : seg) {
+                sum += mass;
+            }
+        });
+        sink = sink + sum;
+    });
+
+    std::cout << "BlockVector<Record> index:    " << aos_index << " ms\n";
+    std::cout << "BlockVector<Record> segments: " << aos_segments << " ms\n";
+    std::cout << "BlockSoA get<mass>(i):        " << soa_index << " ms\n";
+    std::cout << "BlockSoA mass segments:       " << soa_segments << " ms\n";
+    return 0;
+}
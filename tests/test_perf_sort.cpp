@@ -0,0 +1,64 @@
+#include "BlockVector.hpp"
+#include "BlockVectorParallel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr size_t kCount = static_cast<size_t>(1) << 24;
+
+template <typename Func>
+double time_ms(Func&& func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> elapsed = end - start;
+    return elapsed.count();
+}
+
+volatile uint64_t sink = 0;
+}
+
+// Sorting random 64-bit keys: std::sort on a std::vector and on BlockVector
+// iterators, against the block-aware bv::sort and bv::stable_sort.
+int main() {
+    std::vector<uint64_t> keys(kCount);
+    std::mt19937_64 rng(2024);
+    for (auto& key : keys) {
+        key = rng();
+    }
+    std::cout << "Sorting " << kCount << " uint64_t keys, hardware threads: "
+              << std::thread::hardware_concurrency() << "\n";
+
+    std::vector<uint64_t> standard = keys;
+    double vector_ms = time_ms([&]() { std::sort(standard.begin(), standard.end()); });
+
+    BlockVector<uint64_t> block;
+    block.append(keys);
+    double iter_ms = time_ms([&]() { std::sort(block.begin(), block.end()); });
+    sink += block[kCount / 2];
+
+    block.clear();
+    block.append(keys);
+    double bv_ms = time_ms([&]() { bv::sort(block); });
+    if (!std::equal(block.begin(), block.end(), standard.begin())) {
+        std::cout << "bv::sort produced a different order\n";
+        return 1;
+    }
+
+    block.clear();
+    block.append(keys);
+    double stable_ms = time_ms([&]() { bv::stable_sort(block); });
+    sink += block[kCount / 2];
+
+    std::cout << "std::sort(std::vector):       " << vector_ms << " ms\n";
+    std::cout << "std::sort(BlockVector iters): " << iter_ms << " ms\n";
+    std::cout << "bv::sort:                     " << bv_ms << " ms\n";
+    std::cout << "bv::stable_sort:              " << stable_ms << " ms\n";
+    return 0;
+}
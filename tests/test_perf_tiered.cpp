@@ -0,0 +1,95 @@
+#include "BlockVector.hpp"
+#include "TieredVector.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr size_t kCount = static_cast<size_t>(1) << 20;
+constexpr size_t kEdits = 2000;
+constexpr size_t kReads = static_cast<size_t>(1) << 22;
+
+template <typename Func>
+double time_ms(Func&& func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> elapsed = end - start;
+    return elapsed.count();
+}
+
+volatile long long sink = 0;
+
+// BlockVector has no insert/erase; the workaround is shifting every element
+// after the edit point by hand.
+void shift_insert(BlockVector<int>& bv, size_t pos, int value) {
+    bv.push_back(value);
+    for (size_t i = bv.size() - 1; i > pos; --i) {
+        bv[i] = bv[i - 1];
+    }
+    bv[pos] = value;
+}
+
+void shift_erase(BlockVector<int>& bv, size_t pos) {
+    for (size_t i = pos; i + 1 < bv.size(); ++i) {
+        bv[i] = bv[i + 1];
+    }
+    bv.pop_back();
+}
+
+template <typename Container, typename Insert, typename Erase>
+void run_edits(const char* label, Container& c, Insert insert, Erase erase) {
+    std::mt19937 rng(5);
+    double insert_ms = time_ms([&]() {
+        for (size_t i = 0; i < kEdits; ++i) {
+            insert(c, rng() % c.size(), static_cast<int>(i));
+        }
+    });
+    double erase_ms = time_ms([&]() {
+        for (size_t i = 0; i < kEdits; ++i) {
+            erase(c, rng() % c.size());
+        }
+    });
+    double read_ms = time_ms([&]() {
+        long long sum = 0;
+        for (size_t i = 0; i < kReads; ++i) {
+            sum += c[rng() % c.size()];
+        }
+        sink += sum;
+    });
+    std::cout << label << ": " << kEdits << " random inserts = " << insert_ms << " ms, " << kEdits
+              << " random erases = " << erase_ms << " ms, " << kReads << " random reads = " << read_ms << " ms\n";
+}
+}
+
+int main() {
+    std::cout << "Elements: " << kCount << " ints\n";
+
+    std::vector<int> vec(kCount, 1);
+    run_edits("std::vector", vec,
+              [](std::vector<int>& v, size_t pos, int value) { v.insert(v.begin() + static_cast<std::ptrdiff_t>(pos), value); },
+              [](std::vector<int>& v, size_t pos) { v.erase(v.begin() + static_cast<std::ptrdiff_t>(pos)); });
+
+    BlockVector<int> bv;
+    for (size_t i = 0; i < kCount; ++i) {
+        bv.push_back(1);
+    }
+    run_edits("BlockVector (manual shift)", bv, shift_insert, shift_erase);
+
+    TieredVector<int> tv(kCount, 1);
+    run_edits("TieredVector<256>", tv,
+              [](TieredVector<int>& v, size_t pos, int value) { v.insert(v.begin() + static_cast<std::ptrdiff_t>(pos), value); },
+              [](TieredVector<int>& v, size_t pos) { v.erase(v.begin() + static_cast<std::ptrdiff_t>(pos)); });
+
+    TieredVector<int, std::allocator<int>, 10> tv_wide(kCount, 1);
+    run_edits("TieredVector<1024>", tv_wide,
+              [](TieredVector<int, std::allocator<int>, 10>& v, size_t pos, int value) {
+                  v.insert(v.begin() + static_cast<std::ptrdiff_t>(pos), value);
+              },
+              [](TieredVector<int, std::allocator<int>, 10>& v, size_t pos) {
+                  v.erase(v.begin() + static_cast<std::ptrdiff_t>(pos));
+              });
+    return 0;
+}
@@ -1,8 +1,38 @@
 #include "BlockVector.hpp"
 
+#include <chrono>
 #include <iostream>
 #include <vector>
 
+namespace {
+constexpr size_t kCrossings = 2000000;
+
+template <typename Func>
+double time_ms(Func&& func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> elapsed = end - start;
+    return elapsed.count();
+}
+
+volatile size_t sink = 0;
+
+// Pushes and pops one element across a block boundary over and over.
+double oscillate(size_t spare_blocks) {
+    BlockVector<int> block;
+    block.set_max_spare_blocks(spare_blocks);
+    block.resize(block.get_Block_size() * 4);
+    return time_ms([&]() {
+        for (size_t i = 0; i < kCrossings; ++i) {
+            block.push_back(static_cast<int>(i));
+            block.pop_back();
+        }
+        sink += block.size();
+    });
+}
+}
+
 int main() {
     BlockVector<int> probe;
     const size_t count = probe.get_Block_size() * 200;
@@ -26,5 +56,12 @@ int main() {
     std::cout << "BlockVector capacity: " << block.capacity() << "\n";
     std::cout << "std::vector capacity: " << standard.capacity() << "\n";
 
+    block.shrink_to_fit();
+    std::cout << "After shrink_to_fit: " << block.capacity() << "\n";
+
+    std::cout << "\nBoundary oscillation (" << kCrossings << " push/pop pairs)\n";
+    std::cout << "no spare blocks: " << oscillate(0) << " ms\n";
+    std::cout << "1 spare block:   " << oscillate(1) << " ms\n";
+
     return 0;
 }
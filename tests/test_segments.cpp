@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "BlockVector.hpp"
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+TEST(BlockVectorSegments, CoverAllElementsInOrder) {
+    BlockVector<int> bv;
+    const size_t block = bv.get_Block_size();
+    const size_t n = block * 3 + 17;
+    for (size_t i = 0; i < n; ++i) {
+        bv.push_back(static_cast<int>(i));
+    }
+
+    EXPECT_EQ(bv.segment_count(), 4u);
+    size_t expected = 0;
+    size_t seen_segments = 0;
+    for (auto seg : bv.segments()) {
+        EXPECT_EQ(seg.size(), seen_segments < 3 ? block : 17u);
+        for (int v : seg) {
+            EXPECT_EQ(v, static_cast<int>(expected));
+            ++expected;
+        }
+        ++seen_segments;
+    }
+    EXPECT_EQ(expected, n);
+    EXPECT_EQ(bv.segments()[3].data(), &bv[block * 3]);
+}
+
+TEST(BlockVectorSegments, ForEachSegmentMatchesIndexSum) {
+    FixedBlockVector<long, 5> bv;
+    for (long i = 0; i < 1000; ++i) {
+        bv.push_back(i);
+    }
+    long total = 0;
+    size_t calls = 0;
+    bv.for_each_segment([&](bv::BlockSpan<long> seg) {
+        total = std::accumulate(seg.begin(), seg.end(), total);
+        for (long& v : seg) {
+            v *= 2;
+        }
+        ++calls;
+    });
+    EXPECT_EQ(total, 999L * 1000 / 2);
+    EXPECT_EQ(calls, 32u);
+    EXPECT_EQ(bv[999], 1998);
+
+    const auto& cref = bv;
+    long doubled = 0;
+    cref.for_each_segment([&](bv::BlockSpan<const long> seg) {
+        for (long v : seg) {
+            doubled += v;
+        }
+    });
+    EXPECT_EQ(doubled, 2 * total);
+}
+
+TEST(BlockVectorSegments, EmptyContainerHasNoSegments) {
+    BlockVector<int> bv;
+    bv.reserve(1000);
+    EXPECT_EQ(bv.segment_count(), 0u);
+    EXPECT_TRUE(bv.segments().begin() == bv.segments().end());
+    size_t calls = 0;
+    bv.for_each_segment([&](bv::BlockSpan<int>) { ++calls; });
+    EXPECT_EQ(calls, 0u);
+}
+
+namespace {
+std::vector<const void*> prefetched;
+
+// Prefetch policy that records the addresses it is asked to prefetch.
+template <size_t Distance>
+struct RecordingPrefetch : bv::BlockPrefetch<Distance, 1> {
+    static void prefetch(const void* addr) { prefetched.push_back(addr); }
+};
+
+template <size_t Distance>
+using RecordingVector = BlockVector<int, std::allocator<int>, 2, bv::NoStats, RecordingPrefetch<Distance>>;
+
+bool was_prefetched(const void* addr) {
+    return std::find(prefetched.begin(), prefetched.end(), addr) != prefetched.end();
+}
+} // namespace
+
+// Entering block b prefetches the start of block b + 2 (one line here) and
+// the table entry two blocks beyond that; nothing past the table is touched.
+TEST(BlockVectorSegments, ScansPrefetchBlocksAhead) {
+    RecordingVector<2> vec;
+    for (int i = 0; i < 20; ++i) {
+        vec.push_back(i);
+    }
+    ASSERT_EQ(vec.segment_count(), 5u);
+
+    prefetched.clear();
+    long sum = 0;
+    vec.for_each_segment([&](bv::BlockSpan<int> seg) { sum += std::accumulate(seg.begin(), seg.end(), 0L); });
+    EXPECT_EQ(sum, 190);
+    // Blocks 2, 3 and 4, plus the table entry for block 4 requested from block 0.
+    EXPECT_EQ(prefetched.size(), 4u);
+    EXPECT_TRUE(was_prefetched(&vec[8]));
+    EXPECT_TRUE(was_prefetched(&vec[12]));
+    EXPECT_TRUE(was_prefetched(&vec[16]));
+    EXPECT_FALSE(was_prefetched(&vec[0]));
+
+    // The iterator prefetches on each block crossing, i.e. from block 1 on.
+    prefetched.clear();
+    sum = 0;
+    for (auto it = vec.cbegin(); it != vec.cend(); ++it) {
+        sum += *it;
+    }
+    EXPECT_EQ(sum, 190);
+    EXPECT_EQ(prefetched.size(), 2u);
+    EXPECT_TRUE(was_prefetched(&vec[12]));
+    EXPECT_TRUE(was_prefetched(&vec[16]));
+
+    RecordingVector<0> off;
+    for (int i = 0; i < 20; ++i) {
+        off.push_back(i);
+    }
+    prefetched.clear();
+    off.for_each_segment([](bv::BlockSpan<int>) {});
+    EXPECT_TRUE(prefetched.empty());
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "BlockVectorSimd.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+namespace {
+// Runs `check` once per instruction set available on this machine.
+template <typename Check>
+void for_each_isa(Check check) {
+    for (bv::simd::Isa isa : {bv::simd::Isa::scalar, bv::simd::Isa::sse2, bv::simd::Isa::avx2}) {
+        bv::simd::set_max_isa(isa);
+        check();
+    }
+    bv::simd::set_max_isa(bv::simd::Isa::avx2);
+}
+} // namespace
+
+TEST(BlockVectorSimd, IntKernelsMatchScalarLoops) {
+    FixedBlockVector<int32_t, 6> bv;
+    long long expected_sum = 0;
+    for (int32_t i = 0; i < 1000; ++i) {
+        int32_t v = (i * 7919) % 2003 - 1000;
+        bv.push_back(v);
+        expected_sum += v;
+    }
+    bv.push_back(2000000000);
+    bv.push_back(2000000000);
+    expected_sum += 4000000000LL;
+
+    for_each_isa([&]() {
+        EXPECT_EQ(bv::simd::sum(bv), expected_sum);
+        EXPECT_EQ(bv::simd::min(bv), *std::min_element(bv.begin(), bv.end()));
+        EXPECT_EQ(bv::simd::max(bv), 2000000000);
+        EXPECT_EQ(bv::simd::find(bv, bv[777]), static_cast<size_t>(std::find(bv.begin(), bv.end(), bv[777]) - bv.begin()));
+        EXPECT_EQ(bv::simd::find(bv, 123456), bv.size());
+        EXPECT_EQ(bv::simd::count(bv, 2000000000), 2u);
+        EXPECT_EQ(bv::simd::count(bv, bv[5]), static_cast<size_t>(std::count(bv.begin(), bv.end(), bv[5])));
+    });
+}
+
+TEST(BlockVectorSimd, FloatingPointKernels) {
+    BlockVector<float> f;
+    BlockVector<double> d;
+    for (int i = 0; i < 1001; ++i) {
+        f.push_back(static_cast<float>(i % 17) - 3.0f);
+        d.push_back(static_cast<double>(i) * 0.5);
+    }
+
+    for_each_isa([&]() {
+        EXPECT_FLOAT_EQ(bv::simd::sum(f), std::accumulate(f.begin(), f.end(), 0.0f));
+        EXPECT_DOUBLE_EQ(bv::simd::sum(d), 1000.0 * 1001.0 / 4.0);
+        EXPECT_EQ(bv::simd::min(f), -3.0f);
+        EXPECT_EQ(bv::simd::max(f), 13.0f);
+        EXPECT_EQ(bv::simd::max(d), 500.0);
+        EXPECT_EQ(bv::simd::find(d, 250.0), 500u);
+        EXPECT_EQ(bv::simd::count(f, 0.0f), static_cast<size_t>(std::count(f.begin(), f.end(), 0.0f)));
+        // Literals of another arithmetic type convert to the element type.
+        EXPECT_EQ(bv::simd::find(d, 250), 500u);
+        EXPECT_EQ(bv::simd::count(f, 0), static_cast<size_t>(std::count(f.begin(), f.end(), 0.0f)));
+    });
+}
+
+TEST(BlockVectorSimd, ScalarFallbackForOtherTypes) {
+    BlockVector<uint8_t> bytes;
+    for (int i = 0; i < 600; ++i) {
+        bytes.push_back(static_cast<uint8_t>(i));
+    }
+    EXPECT_EQ(bv::simd::sum(bytes), 2u * (255u * 256u / 2u) + (87u * 88u / 2u));
+    EXPECT_EQ(bv::simd::max(bytes), 255);
+    EXPECT_EQ(bv::simd::find(bytes, uint8_t(3)), 3u);
+    EXPECT_EQ(bv::simd::count(bytes, uint8_t(3)), 3u);
+}
+
+TEST(BlockVectorSimd, EmptyContainer) {
+    BlockVector<int32_t> bv;
+    EXPECT_EQ(bv::simd::sum(bv), 0);
+    EXPECT_EQ(bv::simd::find(bv, 1), 0u);
+    EXPECT_EQ(bv::simd::count(bv, 1), 0u);
+    EXPECT_THROW(bv::simd::min(bv), std::out_of_range);
+    EXPECT_THROW(bv::simd::max(bv), std::out_of_range);
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "SingleWriterBlockVector.hpp"
+#include <atomic>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(SingleWriterBlockVector, AppendAndRead) {
+    SingleWriterBlockVector<std::string, std::allocator<std::string>, 2> sv;
+    EXPECT_TRUE(sv.empty());
+    const std::string& first = sv.emplace_back("first");
+    for (int i = 1; i < 5000; ++i) {
+        sv.push_back(std::to_string(i));
+    }
+    ASSERT_EQ(sv.size(), 5000u);
+    EXPECT_EQ(&first, &sv[0]);
+    EXPECT_EQ(sv[4999], "4999");
+    EXPECT_THROW(sv.at(5000), std::out_of_range);
+    EXPECT_EQ(sv.capacity(), 5000u);
+}
+
+TEST(SingleWriterBlockVector, SnapshotIsAConsistentPrefix) {
+    SingleWriterBlockVector<int, std::allocator<int>, 3> sv;
+    sv.reserve(100);
+    EXPECT_EQ(sv.capacity(), 104u);
+    for (int i = 0; i < 50; ++i) {
+        sv.push_back(i);
+    }
+    auto snap = sv.snapshot();
+    for (int i = 50; i < 100; ++i) {
+        sv.push_back(i);
+    }
+    EXPECT_EQ(snap.size(), 50u);
+    EXPECT_EQ(std::accumulate(snap.begin(), snap.end(), 0), 49 * 50 / 2);
+    EXPECT_EQ(snap.end() - snap.begin(), 50);
+    EXPECT_EQ(*(snap.begin() + 17), 17);
+    EXPECT_THROW(snap.at(50), std::out_of_range);
+
+    size_t segments = 0;
+    long total = 0;
+    snap.for_each_segment([&](bv::BlockSpan<const int> seg) {
+        ++segments;
+        total += std::accumulate(seg.begin(), seg.end(), 0L);
+    });
+    EXPECT_EQ(segments, 7u);
+    EXPECT_EQ(total, 49L * 50 / 2);
+
+    long all = 0;
+    sv.for_each_segment([&](bv::BlockSpan<const int> seg) {
+        all += std::accumulate(seg.begin(), seg.end(), 0L);
+    });
+    EXPECT_EQ(all, 99L * 100 / 2);
+}
+
+TEST(SingleWriterBlockVector, FailedConstructionPublishesNothing) {
+    struct Throws {
+        explicit Throws(int value) : value(value) {
+            if (value < 0) {
+                throw std::runtime_error("negative");
+            }
+        }
+        int value;
+    };
+    SingleWriterBlockVector<Throws> sv;
+    sv.emplace_back(1);
+    EXPECT_THROW(sv.emplace_back(-1), std::runtime_error);
+    EXPECT_EQ(sv.size(), 1u);
+    sv.emplace_back(2);
+    EXPECT_EQ(sv[1].value, 2);
+}
+
+// Readers scan everything published so far while the writer keeps growing
+// the directory; every element they see must be fully written.
+TEST(SingleWriterBlockVector, ReadersSeePublishedPrefix) {
+    constexpr size_t kCount = 200000;
+    SingleWriterBlockVector<size_t, std::allocator<size_t>, 4> sv;
+    std::atomic<bool> done{false};
+    std::atomic<size_t> bad_reads{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            size_t last = 0;
+            while (!done.load()) {
+                auto snap = sv.snapshot();
+                if (snap.size() < last) {
+                    ++bad_reads;
+                }
+                last = snap.size();
+                size_t expected = 0;
+                for (size_t value : snap) {
+                    if (value != expected * 3) {
+                        ++bad_reads;
+                    }
+                    ++expected;
+                }
+            }
+        });
+    }
+    for (size_t i = 0; i < kCount; ++i) {
+        sv.push_back(i * 3);
+    }
+    done.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(bad_reads.load(), 0u);
+    EXPECT_EQ(sv.size(), kCount);
+    EXPECT_EQ(sv[kCount - 1], (kCount - 1) * 3);
+}
@@ -0,0 +1,338 @@
+#include <gtest/gtest.h>
+#include "BlockSlotMap.hpp"
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST(BlockSlotMap, InsertLookupErase) {
+    BlockSlotMap<std::string> map;
+    auto a = map.insert("alpha");
+    auto b = map.emplace(3, 'b');
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_EQ(map[a], "alpha");
+    EXPECT_EQ(map.at(b), "bbb");
+
+    EXPECT_TRUE(map.erase(a));
+    EXPECT_FALSE(map.erase(a));
+    EXPECT_FALSE(map.contains(a));
+    EXPECT_EQ(map.get(a), nullptr);
+    EXPECT_THROW(map.at(a), std::out_of_range);
+    EXPECT_EQ(map.size(), 1u);
+}
+
+TEST(BlockSlotMap, ReusesHolesWithNewGeneration) {
+    BlockSlotMap<int> map;
+    auto first = map.insert(1);
+    map.insert(2);
+    map.erase(first);
+
+    auto reused = map.insert(3);
+    EXPECT_EQ(reused.index, first.index);
+    EXPECT_NE(reused.generation, first.generation);
+    EXPECT_FALSE(map.contains(first));
+    EXPECT_EQ(map[reused], 3);
+    EXPECT_EQ(map.slot_count(), 2u);
+}
+
+TEST(BlockSlotMap, ReferencesStayValid) {
+    BlockSlotMap<std::string> map;
+    auto h = map.insert("stable");
+    const std::string* address = &map[h];
+    std::vector<BlockSlotMap<std::string>::handle> others;
+    for (int i = 0; i < 10000; ++i) {
+        others.push_back(map.insert(std::to_string(i)));
+    }
+    for (size_t i = 0; i < others.size(); i += 2) {
+        map.erase(others[i]);
+    }
+    for (int i = 0; i < 3000; ++i) {
+        map.insert("again");
+    }
+    EXPECT_EQ(&map[h], address);
+    EXPECT_EQ(*address, "stable");
+}
+
+TEST(BlockSlotMap, IterationSkipsHoles) {
+    BlockSlotMap<int> map;
+    std::vector<BlockSlotMap<int>::handle> handles;
+    for (int i = 0; i < 100; ++i) {
+        handles.push_back(map.insert(i));
+    }
+    // Erase 0-9, 40-69 and 99 in an order that exercises left, right and
+    // two-sided merges.
+    for (int i : {5, 3, 4, 0, 9, 1, 2, 8, 6, 7, 99}) {
+        map.erase(handles[i]);
+    }
+    for (int i = 69; i >= 40; i -= 2) {
+        map.erase(handles[i]);
+    }
+    for (int i = 40; i < 70; i += 2) {
+        map.erase(handles[i]);
+    }
+
+    std::vector<int> seen;
+    for (int value : map) {
+        seen.push_back(value);
+    }
+    std::vector<int> expected;
+    for (int i = 10; i < 99; ++i) {
+        if (i < 40 || i >= 70) {
+            expected.push_back(i);
+        }
+    }
+    EXPECT_EQ(seen, expected);
+    EXPECT_EQ(map.size(), expected.size());
+
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        EXPECT_EQ(map[it.handle()], *it);
+    }
+}
+
+TEST(BlockSlotMap, EraseThroughIterator) {
+    BlockSlotMap<int> map;
+    for (int i = 0; i < 20; ++i) {
+        map.insert(i);
+    }
+    for (auto it = map.begin(); it != map.end();) {
+        if (*it % 3 != 0) {
+            it = map.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    int expected = 0;
+    for (int value : map) {
+        EXPECT_EQ(value, expected);
+        expected += 3;
+    }
+    EXPECT_EQ(map.size(), 7u);
+}
+
+// Erasing next to an existing hole merges the two runs, so the returned
+// iterator must land past the merged run rather than follow slot + 1.
+TEST(BlockSlotMap, EraseThroughIteratorNextToHoles) {
+    BlockSlotMap<int> map;
+    std::vector<BlockSlotMap<int>::handle> handles;
+    for (int i = 0; i < 12; ++i) {
+        handles.push_back(map.insert(i));
+    }
+    map.erase(handles[2]);
+    for (int i = 6; i <= 8; ++i) {
+        map.erase(handles[i]);
+    }
+
+    std::vector<int> visited;
+    for (auto it = map.begin(); it != map.end();) {
+        visited.push_back(*it);
+        if (*it % 2 != 0) {
+            it = map.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    EXPECT_EQ(visited, (std::vector<int>{0, 1, 3, 4, 5, 9, 10, 11}));
+
+    std::vector<int> left(map.begin(), map.end());
+    EXPECT_EQ(left, (std::vector<int>{0, 4, 10}));
+    EXPECT_EQ(map.size(), 3u);
+}
+
+TEST(BlockSlotMap, MatchesReferenceModel) {
+    BlockSlotMap<int> map;
+    std::map<uint32_t, std::pair<BlockSlotMap<int>::handle, int>> model;
+    std::mt19937 rng(11);
+    for (int step = 0; step < 20000; ++step) {
+        if (model.empty() || rng() % 5 < 3) {
+            int value = static_cast<int>(rng());
+            auto h = map.insert(value);
+            ASSERT_EQ(model.count(h.index), 0u);
+            model[h.index] = {h, value};
+        } else {
+            auto it = model.begin();
+            std::advance(it, rng() % model.size());
+            ASSERT_TRUE(map.erase(it->second.first));
+            model.erase(it);
+        }
+    }
+    ASSERT_EQ(map.size(), model.size());
+    auto expected = model.begin();
+    for (auto it = map.begin(); it != map.end(); ++it, ++expected) {
+        ASSERT_NE(expected, model.end());
+        EXPECT_EQ(it.handle(), expected->second.first);
+        EXPECT_EQ(*it, expected->second.second);
+    }
+    EXPECT_EQ(expected, model.end());
+}
+
+TEST(BlockSlotMap, CopyPreservesHandles) {
+    BlockSlotMap<std::string> map;
+    auto a = map.insert("a");
+    auto b = map.insert("b");
+    auto c = map.insert("c");
+    map.erase(b);
+
+    BlockSlotMap<std::string> copy(map);
+    EXPECT_EQ(copy.size(), 2u);
+    EXPECT_EQ(copy[a], "a");
+    EXPECT_EQ(copy[c], "c");
+    EXPECT_FALSE(copy.contains(b));
+    auto reused = copy.insert("d");
+    EXPECT_EQ(reused.index, b.index);
+
+    BlockSlotMap<std::string> moved(std::move(copy));
+    EXPECT_EQ(moved.size(), 3u);
+    EXPECT_TRUE(copy.empty());
+    copy = moved;
+    EXPECT_EQ(copy[reused], "d");
+}
+
+// Freeing a slot between two empty runs merges all three; the freed slot ends
+// up inside the run and must not be mistaken for a live element.
+TEST(BlockSlotMap, SlotMergedIntoRunStaysEmpty) {
+    BlockSlotMap<std::string> map;
+    auto a = map.insert("a");
+    auto b = map.insert("b");
+    auto c = map.insert("c");
+    map.erase(a);
+    map.erase(c);
+    map.erase(b);
+    EXPECT_FALSE(map.contains(b));
+    EXPECT_TRUE(map.empty());
+
+    BlockSlotMap<std::string> copy(map);
+    EXPECT_TRUE(copy.empty());
+    EXPECT_FALSE(copy.contains(b));
+    EXPECT_EQ(copy.begin(), copy.end());
+    auto d = copy.insert("d");
+    EXPECT_EQ(copy[d], "d");
+    EXPECT_EQ(copy.size(), 1u);
+}
+
+TEST(BlockSlotMap, ClearInvalidatesHandlesAndDestroys) {
+    auto tracker = std::make_shared<int>(0);
+    BlockSlotMap<std::shared_ptr<int>> map;
+    auto h = map.insert(tracker);
+    map.insert(tracker);
+    EXPECT_EQ(tracker.use_count(), 3);
+    map.clear();
+    EXPECT_EQ(tracker.use_count(), 1);
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.contains(h));
+    EXPECT_EQ(map.begin(), map.end());
+    auto again = map.insert(tracker);
+    EXPECT_EQ(again.index, 0u);
+    EXPECT_EQ(map.slot_count(), 2u);
+}
+
+TEST(BlockSlotMap, CopyAfterClearSkipsDestroyedSlots) {
+    BlockSlotMap<std::string> map;
+    std::vector<BlockSlotMap<std::string>::handle> old;
+    for (int i = 0; i < 5; ++i) {
+        old.push_back(map.insert(std::string(40, static_cast<char>('a' + i))));
+    }
+    map.clear();
+    auto h = map.insert("fresh");
+
+    BlockSlotMap<std::string> copy(map);
+    EXPECT_EQ(copy.size(), 1u);
+    EXPECT_EQ(copy[h], "fresh");
+    for (auto o : old) {
+        EXPECT_FALSE(copy.contains(o));
+    }
+    size_t visited = 0;
+    for (auto it = copy.begin(); it != copy.end(); ++it) {
+        ++visited;
+    }
+    EXPECT_EQ(visited, 1u);
+}
+
+namespace {
+// Propagating allocator tagged with an arena id, to check that copy, move
+// and swap carry the allocator along with the slots.
+template <typename T>
+struct TaggedAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    int id;
+
+    explicit TaggedAllocator(int arena_id) : id(arena_id) {}
+    template <typename U>
+    TaggedAllocator(const TaggedAllocator<U>& other) : id(other.id) {}
+
+    T* allocate(size_t n) { return std::allocator<T>().allocate(n); }
+    void deallocate(T* p, size_t n) { std::allocator<T>().deallocate(p, n); }
+
+    template <typename U>
+    bool operator==(const TaggedAllocator<U>& other) const { return id == other.id; }
+    template <typename U>
+    bool operator!=(const TaggedAllocator<U>& other) const { return id != other.id; }
+};
+}
+
+TEST(BlockSlotMap, PropagatingAllocatorFollowsCopyMoveAndSwap) {
+    using Map = BlockSlotMap<std::string, TaggedAllocator<std::string>>;
+    Map a(TaggedAllocator<std::string>(1));
+    auto h = a.insert(std::string(40, 'a'));
+    Map b(TaggedAllocator<std::string>(2));
+    b.insert("b");
+
+    b = a;
+    EXPECT_EQ(b.get_allocator().id, 1);
+    EXPECT_EQ(b[h], a[h]);
+
+    Map c(TaggedAllocator<std::string>(3));
+    c = std::move(b);
+    EXPECT_EQ(c.get_allocator().id, 1);
+    EXPECT_EQ(c[h], std::string(40, 'a'));
+
+    Map d(TaggedAllocator<std::string>(4));
+    d.swap(c);
+    EXPECT_EQ(d.get_allocator().id, 1);
+    EXPECT_EQ(c.get_allocator().id, 4);
+    EXPECT_EQ(d[h], std::string(40, 'a'));
+    EXPECT_TRUE(c.empty());
+}
+
+TEST(BlockSlotMap, PmrMoveAssignKeepsHandlesAcrossResources) {
+    using Map = BlockSlotMap<std::pmr::string, std::pmr::polymorphic_allocator<std::pmr::string>>;
+    std::pmr::unsynchronized_pool_resource r1;
+    std::pmr::unsynchronized_pool_resource r2;
+    Map a(&r1);
+    std::vector<Map::handle> handles;
+    for (int i = 0; i < 600; ++i) {
+        handles.push_back(a.insert(std::pmr::string(std::to_string(i) + std::string(32, 'x'))));
+    }
+    for (size_t i = 0; i < handles.size(); i += 3) {
+        a.erase(handles[i]);
+    }
+
+    Map same(&r1);
+    same = a;
+    EXPECT_EQ(same.size(), 400u);
+    EXPECT_EQ(same.get_allocator().resource(), &r1);
+
+    Map other(&r2);
+    other.insert(std::pmr::string("old"));
+    other = std::move(a);
+    EXPECT_EQ(other.get_allocator().resource(), &r2);
+    EXPECT_EQ(other.size(), 400u);
+    EXPECT_TRUE(a.empty());
+    EXPECT_FALSE(other.contains(handles[0]));
+    EXPECT_STREQ(other[handles[1]].c_str(), (std::to_string(1) + std::string(32, 'x')).c_str());
+    EXPECT_EQ(other[handles[1]].get_allocator().resource(), &r2);
+    other.insert(std::pmr::string("new"));
+    EXPECT_EQ(other.size(), 401u);
+
+    Map moved(&r1);
+    moved = std::move(same);
+    EXPECT_EQ(moved.size(), 400u);
+    moved.swap(same);
+    EXPECT_EQ(same.size(), 400u);
+    EXPECT_TRUE(moved.empty());
+}
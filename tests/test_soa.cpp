@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "BlockSoA.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <tuple>
+
+TEST(BlockSoA, EmplaceAndFieldAccess) {
+    BlockSoA<int, double, std::string> soa;
+    soa.set_Block_size(4);
+    for (int i = 0; i < 10; ++i) {
+        soa.emplace_back(i, i * 0.5, std::to_string(i));
+    }
+    ASSERT_EQ(soa.size(), 10u);
+    EXPECT_EQ(soa.capacity(), 12u);
+    EXPECT_EQ(soa.get<0>(7), 7);
+    EXPECT_DOUBLE_EQ(soa.get<1>(7), 3.5);
+    EXPECT_EQ(soa.get<2>(7), "7");
+
+    auto row = soa[3];
+    EXPECT_EQ(row.get<0>(), 3);
+    EXPECT_EQ(get<2>(row), "3");
+    row.get<2>() = "three";
+    EXPECT_EQ(soa.get<2>(3), "three");
+
+    std::tuple<int, double, std::string> copy = soa.back();
+    EXPECT_EQ(std::get<0>(copy), 9);
+    soa[0] = std::make_tuple(-1, -1.0, std::string("minus"));
+    EXPECT_EQ(soa.front().get<2>(), "minus");
+    soa[1] = soa[0];
+    EXPECT_EQ(soa.get<0>(1), -1);
+    EXPECT_THROW(soa.at(10), std::out_of_range);
+}
+
+TEST(BlockSoA, ColumnsAreSeparateAlignedArrays) {
+    BlockSoA<uint8_t, uint64_t> soa;
+    soa.set_Block_size(16);
+    for (int i = 0; i < 40; ++i) {
+        soa.emplace_back(static_cast<uint8_t>(i), static_cast<uint64_t>(i) * 3);
+    }
+    EXPECT_EQ(soa.segment_count(), 3u);
+    auto bytes = soa.get_segment<0>(1);
+    auto words = soa.get_segment<1>(1);
+    EXPECT_EQ(bytes.size(), 16u);
+    EXPECT_EQ(bytes.data(), &soa.get<0>(16));
+    EXPECT_EQ(&bytes[15], &bytes[0] + 15);
+    EXPECT_EQ(words.data(), &soa.get<1>(16));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(words.data()) % 64, 0u);
+    EXPECT_EQ(soa.get_segment<1>(2).size(), 8u);
+
+    uint64_t total = 0;
+    soa.for_each_segment<1>([&](bv::BlockSpan<uint64_t> column) {
+        total += std::accumulate(column.begin(), column.end(), uint64_t(0));
+    });
+    EXPECT_EQ(total, 3u * 39 * 40 / 2);
+}
+
+TEST(BlockSoA, FieldsNeverMove) {
+    BlockSoA<std::string, int> soa;
+    soa.emplace_back("first", 1);
+    const std::string* name = &soa.get<0>(0);
+    const int* value = &soa.get<1>(0);
+    for (int i = 0; i < 5000; ++i) {
+        soa.emplace_back(std::to_string(i), i);
+    }
+    EXPECT_EQ(&soa.get<0>(0), name);
+    EXPECT_EQ(&soa.get<1>(0), value);
+    EXPECT_EQ(*name, "first");
+}
+
+TEST(BlockSoA, IteratorsAndSort) {
+    BlockSoA<int, int> soa;
+    soa.set_Block_size(8);
+    for (int i = 0; i < 100; ++i) {
+        soa.emplace_back((i * 37) % 100, i);
+    }
+    std::sort(soa.begin(), soa.end(), [](const auto& a, const auto& b) { return get<0>(a) < get<0>(b); });
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(soa.get<0>(i), i);
+        EXPECT_EQ((soa.get<1>(i) * 37) % 100, i);
+    }
+
+    int sum = 0;
+    for (auto row : soa) {
+        sum += row.get<0>();
+    }
+    EXPECT_EQ(sum, 99 * 100 / 2);
+    const auto& csoa = soa;
+    EXPECT_EQ(csoa.end() - csoa.begin(), 100);
+    EXPECT_EQ((*(csoa.begin() + 42)).get<0>(), 42);
+}
+
+TEST(BlockSoA, CopyMoveResizeAndLifetimes) {
+    auto tracker = std::make_shared<int>(0);
+    BlockSoA<std::shared_ptr<int>, int> a;
+    for (int i = 0; i < 300; ++i) {
+        a.emplace_back(tracker, i);
+    }
+    BlockSoA<std::shared_ptr<int>, int> b(a);
+    EXPECT_EQ(tracker.use_count(), 601);
+    EXPECT_EQ(b.get<1>(299), 299);
+
+    BlockSoA<std::shared_ptr<int>, int> c(std::move(a));
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(tracker.use_count(), 601);
+    a = c;
+    EXPECT_EQ(tracker.use_count(), 901);
+    b = std::move(c);
+    EXPECT_EQ(tracker.use_count(), 601);
+
+    b.resize(500);
+    EXPECT_EQ(b.get<0>(499), nullptr);
+    b.resize(10);
+    b.pop_back();
+    EXPECT_EQ(b.size(), 9u);
+    EXPECT_EQ(tracker.use_count(), 310);
+    b.shrink_to_fit();
+    EXPECT_EQ(b.capacity(), b.get_Block_size());
+    a.clear();
+    b.clear();
+    EXPECT_EQ(tracker.use_count(), 1);
+}
+
+TEST(BlockSoA, FailedEmplaceLeavesNoPartialRow) {
+    struct Throws {
+        explicit Throws(int value) {
+            if (value < 0) {
+                throw std::runtime_error("negative");
+            }
+        }
+    };
+    auto tracker = std::make_shared<int>(0);
+    BlockSoA<std::shared_ptr<int>, Throws> soa;
+    soa.emplace_back(tracker, 1);
+    EXPECT_THROW(soa.emplace_back(tracker, -1), std::runtime_error);
+    EXPECT_EQ(soa.size(), 1u);
+    EXPECT_EQ(tracker.use_count(), 2);
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include "BlockVector.hpp"
+#include <string>
+
+namespace {
+template <typename T>
+using StatsVector = BlockVector<T, std::allocator<T>, bv::dynamic_block_shift, bv::BasicStats>;
+} // namespace
+
+static_assert(sizeof(BlockVector<int, std::allocator<int>, 8, bv::NoStats>) == sizeof(FixedBlockVector<int, 8>),
+              "NoStats must not add to the object size");
+
+TEST(BlockVectorStats, CountsBlocksAndFootprint) {
+    StatsVector<int> bv;
+    bv.set_max_spare_blocks(0);
+    const size_t block = bv.get_Block_size();
+    for (size_t i = 0; i < block * 10; ++i) {
+        bv.push_back(static_cast<int>(i));
+    }
+    bv::StatsSnapshot s = bv.stats_snapshot();
+    EXPECT_EQ(s.block_allocations, 10u);
+    EXPECT_EQ(s.block_frees, 0u);
+    EXPECT_EQ(s.table_grows, 2u); // 8 then 16 entries
+    EXPECT_EQ(s.bytes_reserved, block * 10 * sizeof(int));
+    EXPECT_EQ(s.bytes_used, block * 10 * sizeof(int));
+    EXPECT_EQ(s.push_count, block * 10);
+
+    bv.resize(block * 2);
+    s = bv.stats_snapshot();
+    EXPECT_EQ(s.block_frees, 8u);
+    EXPECT_EQ(s.bytes_reserved, block * 2 * sizeof(int));
+    EXPECT_EQ(s.peak_bytes_reserved, block * 10 * sizeof(int));
+    EXPECT_EQ(s.bytes_used, block * 2 * sizeof(int));
+
+    bv.pop_back();
+    EXPECT_EQ(bv.stats_snapshot().block_frees, 8u);
+}
+
+TEST(BlockVectorStats, SamplesPushLatency) {
+    StatsVector<std::string> bv;
+    const uint64_t pushes = bv::BasicStats::kPushSampleInterval * 20;
+    for (uint64_t i = 0; i < pushes; ++i) {
+        if (i % 2 == 0) {
+            bv.push_back("value");
+        } else {
+            bv.emplace_back(3, 'x');
+        }
+    }
+    bv::StatsSnapshot s = bv.stats_snapshot();
+    EXPECT_EQ(s.push_count, pushes);
+    EXPECT_EQ(s.push_samples, 20u);
+    uint64_t histogram_total = 0;
+    for (uint64_t bucket : s.push_latency_ns) {
+        histogram_total += bucket;
+    }
+    EXPECT_EQ(histogram_total, s.push_samples);
+}
+
+TEST(BlockVectorStats, CountersFollowStorage) {
+    StatsVector<int> a;
+    a.resize(a.get_Block_size() * 3);
+    EXPECT_EQ(a.stats_snapshot().block_allocations, 3u);
+
+    StatsVector<int> copy(a);
+    EXPECT_EQ(copy.stats_snapshot().block_allocations, 3u);
+
+    StatsVector<int> moved(std::move(a));
+    EXPECT_EQ(moved.stats_snapshot().block_allocations, 3u);
+    EXPECT_EQ(a.stats_snapshot().block_allocations, 0u);
+
+    StatsVector<int> other;
+    other.push_back(1);
+    swap(moved, other);
+    EXPECT_EQ(other.stats_snapshot().bytes_reserved, 3 * other.get_Block_size() * sizeof(int));
+    EXPECT_EQ(moved.stats_snapshot().block_allocations, 1u);
+
+    BlockVector<int> plain = {1, 2, 3};
+    EXPECT_EQ(plain.stats_snapshot().block_allocations, 0u);
+    EXPECT_EQ(plain.stats_snapshot().bytes_used, 3 * sizeof(int));
+}
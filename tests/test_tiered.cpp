@@ -0,0 +1,293 @@
+#include <gtest/gtest.h>
+#include "TieredVector.hpp"
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST(TieredVector, PushBackAndIndex) {
+    TieredVector<int, std::allocator<int>, 3> tv;
+    EXPECT_TRUE(tv.empty());
+    for (int i = 0; i < 100; ++i) {
+        tv.push_back(i);
+    }
+    ASSERT_EQ(tv.size(), 100u);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(tv[i], i);
+    }
+    EXPECT_EQ(tv.front(), 0);
+    EXPECT_EQ(tv.back(), 99);
+    EXPECT_EQ(tv.capacity(), 104u);
+    EXPECT_THROW(tv.at(100), std::out_of_range);
+}
+
+TEST(TieredVector, InsertAndEraseSingle) {
+    TieredVector<std::string, std::allocator<std::string>, 2> tv{"a", "b", "c", "d", "e", "f", "g"};
+    auto it = tv.insert(tv.begin() + 1, "x");
+    EXPECT_EQ(*it, "x");
+    tv.insert(tv.begin(), "front");
+    tv.insert(tv.end(), "back");
+    std::vector<std::string> expected{"front", "a", "x", "b", "c", "d", "e", "f", "g", "back"};
+    EXPECT_TRUE(std::equal(tv.begin(), tv.end(), expected.begin(), expected.end()));
+
+    it = tv.erase(tv.begin() + 2);
+    EXPECT_EQ(*it, "b");
+    tv.erase(tv.begin());
+    tv.erase(tv.end() - 1);
+    expected = {"a", "b", "c", "d", "e", "f", "g"};
+    EXPECT_TRUE(std::equal(tv.begin(), tv.end(), expected.begin(), expected.end()));
+}
+
+TEST(TieredVector, RangeInsertSpanningBlocks) {
+    TieredVector<int, std::allocator<int>, 2> tv;
+    for (int i = 0; i < 10; ++i) {
+        tv.push_back(i);
+    }
+    std::vector<int> extra(11);
+    std::iota(extra.begin(), extra.end(), 100);
+    auto it = tv.insert(tv.begin() + 3, extra.begin(), extra.end());
+    EXPECT_EQ(it - tv.begin(), 3);
+    tv.insert(tv.begin() + 1, 5, -1);
+
+    std::vector<int> expected{0};
+    expected.insert(expected.end(), 5, -1);
+    expected.insert(expected.end(), {1, 2});
+    expected.insert(expected.end(), extra.begin(), extra.end());
+    for (int i = 3; i < 10; ++i) {
+        expected.push_back(i);
+    }
+    EXPECT_TRUE(std::equal(tv.begin(), tv.end(), expected.begin(), expected.end()));
+
+    it = tv.erase(tv.begin() + 2, tv.begin() + 17);
+    expected.erase(expected.begin() + 2, expected.begin() + 17);
+    EXPECT_EQ(it - tv.begin(), 2);
+    EXPECT_TRUE(std::equal(tv.begin(), tv.end(), expected.begin(), expected.end()));
+}
+
+TEST(TieredVector, InsertValueFromSelf) {
+    TieredVector<std::string, std::allocator<std::string>, 1> tv{"p", "q", "r", "s"};
+    tv.insert(tv.begin(), tv[3]);
+    tv.insert(tv.begin() + 2, 3, tv.back());
+    std::vector<std::string> expected{"s", "p", "s", "s", "s", "q", "r", "s"};
+    EXPECT_TRUE(std::equal(tv.begin(), tv.end(), expected.begin(), expected.end()));
+}
+
+// Random edits checked against std::vector; shared_ptr use counts catch
+// elements that are leaked or destroyed twice while being shifted.
+TEST(TieredVector, MatchesReferenceModel) {
+    auto tracker = std::make_shared<int>(0);
+    TieredVector<std::shared_ptr<int>, std::allocator<std::shared_ptr<int>>, 3> tv;
+    std::vector<int> model;
+    std::vector<std::shared_ptr<int>> values;
+    for (int i = 0; i < 4096; ++i) {
+        values.push_back(std::make_shared<int>(i));
+    }
+
+    std::mt19937 rng(17);
+    for (int step = 0; step < 3000; ++step) {
+        size_t pos = model.empty() ? 0 : rng() % (model.size() + 1);
+        size_t count = 1 + rng() % (rng() % 4 == 0 ? 40 : 5);
+        if (model.size() < 40 || rng() % 2 == 0) {
+            std::vector<std::shared_ptr<int>> batch;
+            for (size_t i = 0; i < count; ++i) {
+                int value = static_cast<int>(rng() % values.size());
+                batch.push_back(values[value]);
+                model.insert(model.begin() + static_cast<std::ptrdiff_t>(pos + i), value);
+            }
+            if (count == 1) {
+                tv.insert(tv.begin() + static_cast<std::ptrdiff_t>(pos), batch[0]);
+            } else {
+                tv.insert(tv.begin() + static_cast<std::ptrdiff_t>(pos), batch.begin(), batch.end());
+            }
+        } else {
+            pos = std::min(pos, model.size() - 1);
+            count = std::min(count, model.size() - pos);
+            tv.erase(tv.begin() + static_cast<std::ptrdiff_t>(pos),
+                     tv.begin() + static_cast<std::ptrdiff_t>(pos + count));
+            model.erase(model.begin() + static_cast<std::ptrdiff_t>(pos),
+                        model.begin() + static_cast<std::ptrdiff_t>(pos + count));
+        }
+        ASSERT_EQ(tv.size(), model.size());
+        if (step % 50 == 0) {
+            for (size_t i = 0; i < model.size(); ++i) {
+                ASSERT_EQ(*tv[i], model[i]);
+            }
+        }
+    }
+    for (size_t i = 0; i < model.size(); ++i) {
+        ASSERT_EQ(*tv[i], model[i]);
+    }
+
+    long live = 0;
+    for (const auto& value : values) {
+        live += value.use_count() - 1;
+    }
+    EXPECT_EQ(live, static_cast<long>(model.size()));
+    tv.clear();
+    for (const auto& value : values) {
+        EXPECT_EQ(value.use_count(), 1);
+    }
+}
+
+TEST(TieredVector, IteratorsAndAlgorithms) {
+    TieredVector<int, std::allocator<int>, 2> tv;
+    for (int i = 0; i < 300; ++i) {
+        tv.insert(tv.begin() + (i / 2), (i * 7919) % 300);
+    }
+    std::sort(tv.begin(), tv.end());
+    for (int i = 0; i < 300; ++i) {
+        EXPECT_EQ(tv[i], i);
+    }
+    EXPECT_EQ(*std::lower_bound(tv.begin(), tv.end(), 123), 123);
+    EXPECT_EQ(*tv.rbegin(), 299);
+    const auto& ctv = tv;
+    EXPECT_EQ(std::accumulate(ctv.begin(), ctv.end(), 0), 299 * 300 / 2);
+}
+
+// Iterators cache the stretch of a block's ring buffer around the current
+// element; walking and jumping must stay correct across the wrap points.
+TEST(TieredVector, IteratorsFollowRotatedBlocks) {
+    TieredVector<int, std::allocator<int>, 3> tv;
+    for (int i = 0; i < 100; ++i) {
+        tv.push_back(i);
+    }
+    for (int i = 0; i < 5; ++i) {
+        tv.erase(tv.begin() + 3);
+        tv.insert(tv.begin(), -1 - i);
+    }
+    std::vector<int> model(tv.size());
+    for (size_t i = 0; i < tv.size(); ++i) {
+        model[i] = tv[i];
+    }
+    EXPECT_TRUE(std::equal(tv.begin(), tv.end(), model.begin(), model.end()));
+    EXPECT_TRUE(std::equal(tv.rbegin(), tv.rend(), model.rbegin(), model.rend()));
+
+    std::mt19937 rng(7);
+    auto it = tv.cbegin();
+    size_t index = 0;
+    for (int step = 0; step < 2000; ++step) {
+        std::ptrdiff_t delta = static_cast<std::ptrdiff_t>(rng() % 11) - 5;
+        if (static_cast<std::ptrdiff_t>(index) + delta < 0 ||
+            index + static_cast<size_t>(delta) >= model.size()) {
+            continue;
+        }
+        it += delta;
+        index += static_cast<size_t>(delta);
+        ASSERT_EQ(*it, model[index]);
+        ASSERT_EQ(it[-static_cast<std::ptrdiff_t>(index)], model[0]);
+    }
+}
+
+TEST(TieredVector, CopyMoveResizeAndShrink) {
+    TieredVector<std::string, std::allocator<std::string>, 2> a{"x", "y", "z"};
+    a.insert(a.begin(), "w");
+    TieredVector<std::string, std::allocator<std::string>, 2> b(a);
+    EXPECT_EQ(b.size(), 4u);
+    EXPECT_EQ(b[0], "w");
+
+    TieredVector<std::string, std::allocator<std::string>, 2> c(std::move(a));
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(c[3], "z");
+    a = c;
+    EXPECT_EQ(a[1], "x");
+    swap(a, b);
+
+    c.resize(50);
+    EXPECT_EQ(c.capacity(), 52u);
+    c.erase(c.begin() + 2, c.end());
+    EXPECT_EQ(c.capacity(), 52u);
+    c.shrink_to_fit();
+    EXPECT_EQ(c.capacity(), 4u);
+    c.pop_back();
+    EXPECT_EQ(c.back(), "w");
+}
+
+TEST(TieredVector, PmrAllocatorCopyMoveAndSwap) {
+    using Vec = TieredVector<std::pmr::string, std::pmr::polymorphic_allocator<std::pmr::string>>;
+    std::pmr::unsynchronized_pool_resource r1;
+    std::pmr::unsynchronized_pool_resource r2;
+    Vec a(&r1);
+    for (int i = 0; i < 1000; ++i) {
+        a.push_back(std::pmr::string(std::to_string(i) + std::string(32, 'x')));
+    }
+    Vec same(&r1);
+    Vec other(&r2);
+    same = a;
+    other = a;
+    EXPECT_EQ(other.get_allocator().resource(), &r2);
+    ASSERT_EQ(other.size(), 1000u);
+    EXPECT_EQ(other[999], a[999]);
+
+    same = std::move(a);
+    EXPECT_EQ(same.size(), 1000u);
+    other = std::move(same);
+    EXPECT_EQ(other.get_allocator().resource(), &r2);
+    ASSERT_EQ(other.size(), 1000u);
+    EXPECT_STREQ(other[500].c_str(), (std::to_string(500) + std::string(32, 'x')).c_str());
+
+    Vec b(&r2);
+    b.push_back(std::pmr::string("b"));
+    b.swap(other);
+    EXPECT_EQ(b.size(), 1000u);
+    EXPECT_EQ(other.size(), 1u);
+    EXPECT_EQ(b.get_allocator().resource(), &r2);
+}
+
+namespace {
+// memory_resource that only counts the bytes it has ever handed out.
+class AllocationCounter : public std::pmr::memory_resource {
+public:
+    size_t allocated = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t align) override {
+        allocated += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t align) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+}
+
+// Staged copies for bulk insert must not come out of the container's
+// resource: a monotonic resource would never get that memory back.
+TEST(TieredVector, BulkInsertDoesNotStageInContainerResource) {
+    AllocationCounter counter;
+    TieredVector<int, std::pmr::polymorphic_allocator<int>, 4> tv(&counter);
+    tv.reserve(4096);
+    tv.push_back(0);
+    tv.push_back(1);
+    size_t before = counter.allocated;
+
+    tv.insert(tv.begin() + 1, 1000, 7);
+    std::vector<int> extra(500, 9);
+    tv.insert(tv.begin() + 1, extra.begin(), extra.end());
+    EXPECT_EQ(counter.allocated, before);
+    EXPECT_EQ(tv.size(), 1502u);
+    EXPECT_EQ(tv[1], 9);
+    EXPECT_EQ(tv[501], 7);
+    EXPECT_EQ(tv.back(), 1);
+}
+
+TEST(TieredVector, BulkInsertPmrStringsUseContainerResource) {
+    using Vec = TieredVector<std::pmr::string, std::pmr::polymorphic_allocator<std::pmr::string>, 3>;
+    std::pmr::unsynchronized_pool_resource pool;
+    Vec tv(&pool);
+    tv.push_back(std::pmr::string("a"));
+    tv.insert(tv.begin(), 20, std::pmr::string(40, 'v'));
+    std::vector<std::string> extra(10, std::string(40, 'r'));
+    tv.insert(tv.begin() + 5, extra.begin(), extra.end());
+    ASSERT_EQ(tv.size(), 31u);
+    for (size_t i = 0; i < tv.size(); ++i) {
+        EXPECT_EQ(tv[i].get_allocator().resource(), &pool);
+    }
+    EXPECT_EQ(tv[5], std::pmr::string(40, 'r'));
+    EXPECT_EQ(tv[30], std::pmr::string("a"));
+}